@@ -0,0 +1,83 @@
+#include <nanobench.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+import std;
+import tinystd;
+
+// One log call per iteration, with an int, a double and a short string. All
+// output goes to /dev/null, so that only the cost on the logging thread is
+// measured: a synchronous logger formats and writes, the async logger only
+// enqueues a record.
+int
+main()
+{
+    int const dev_null = ::open("/dev/null", O_WRONLY);
+
+    std::string_view const name = "request";
+    std::uint64_t          i    = 0;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("log call on the logging thread").relative(true);
+
+    bench.run(
+        "std::format_to_n + ::write",
+        [&]
+        {
+            std::array<char, 256> buffer;
+            auto const            result = std::format_to_n(
+                buffer.data(),
+                buffer.size(),
+                "{} #{} took {:.3f} ms\n",
+                name,
+                ++i,
+                0.25
+            );
+            ::write(dev_null, buffer.data(), result.out - buffer.data());
+        }
+    );
+
+    std::FILE* const file = std::fopen("/dev/null", "w");
+    bench.run(
+        "std::fprintf (buffered)",
+        [&]
+        {
+            std::fprintf(
+                file,
+                "%.*s #%llu took %.3f ms\n",
+                static_cast<int>(name.size()),
+                name.data(),
+                static_cast<unsigned long long>(++i),
+                0.25
+            );
+        }
+    );
+    std::fclose(file);
+
+    {
+        tinystd::async_logger logger(
+            dev_null, tinystd::log_overflow::block, 1 << 16
+        );
+        bench.run(
+            "tinystd::async_logger (block)",
+            [&] { logger.log("{} #{} took {:.3f} ms", name, ++i, 0.25); }
+        );
+    }
+
+    {
+        tinystd::async_logger logger(
+            dev_null, tinystd::log_overflow::drop, 1 << 16
+        );
+        bench.run(
+            "tinystd::async_logger (drop)",
+            [&] { logger.log("{} #{} took {:.3f} ms", name, ++i, 0.25); }
+        );
+        logger.flush();
+        std::println(
+            "async_logger (drop): {} records dropped", logger.dropped()
+        );
+    }
+
+    ::close(dev_null);
+    return 0;
+}
@@ -1,10 +1,11 @@
 #include <boost/smart_ptr/atomic_shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
 #include <nanobench.h>
 
 import tinystd;
 import std;
 
-template <typename T>
+template <typename T, typename Policy>
 class lockfree_stack
 {
 private:
@@ -13,7 +14,7 @@ private:
         T                         data;
         tinystd::shared_ptr<node> next; // every node is managed by shared_ptr
     };
-    tinystd::atomic_shared_ptr<node> head;
+    tinystd::atomic_shared_ptr<node, Policy> head;
 
 public:
     void
@@ -93,11 +94,26 @@ worker(Stack& stack, size_t operations)
     }
 }
 
+// a single thread pushes and pops in turn, the uncontended cost
+template <typename Stack>
+void
+push_pop_worker(Stack& stack, size_t operations)
+{
+    for (size_t i = 0; i < operations; ++i)
+    {
+        stack.push(i);
+        stack.pop();
+    }
+}
+
 template <typename Stack>
 void
-run_benchmark(ankerl::nanobench::Bench& bench, std::string const & name)
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads
+)
 {
-    size_t const num_threads           = std::thread::hardware_concurrency();
     size_t const operations_per_thread = 1000000;
 
     bench.minEpochIterations(1).run(
@@ -108,6 +124,14 @@ run_benchmark(ankerl::nanobench::Bench& bench, std::string const & name)
             std::vector<std::thread> threads;
             threads.reserve(num_threads);
 
+            if (num_threads == 1)
+            {
+                threads.emplace_back(
+                    push_pop_worker<Stack>,
+                    std::ref(stack),
+                    operations_per_thread
+                );
+            }
             for (size_t i = 0; i < num_threads / 2; ++i)
             {
                 threads.emplace_back(
@@ -126,18 +150,125 @@ run_benchmark(ankerl::nanobench::Bench& bench, std::string const & name)
     );
 }
 
+// Read-mostly workload: every thread loads the pointer and reads the pointee,
+// one in every 1024 operations of thread 0 is a store. With snapshot = true,
+// the pointee is read through load_snapshot() instead of load().
+template <typename AtomicSharedPtr, bool snapshot = false, typename MakeShared>
+void
+run_load_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    MakeShared                make
+)
+{
+    size_t const operations_per_thread = 1000000;
+
+    AtomicSharedPtr asp(make(0));
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                if (t == 0 && i % 1024 == 0)
+                                {
+                                    asp.store(make(i));
+                                }
+                                else if constexpr (snapshot)
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        *asp.load_snapshot()
+                                    );
+                                }
+                                else
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        *asp.load()
+                                    );
+                                }
+                            }
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
 int
 main()
 {
-    ankerl::nanobench::Bench bench;
+    size_t const max_threads = std::thread::hardware_concurrency();
 
-    bench.relative(true);
-    run_benchmark<lockfree_stack_boost<int>>(
-        bench, "Boost Atomic Shared Ptr Stack"
-    );
-    run_benchmark<lockfree_stack<int>>(
-        bench, "TinySTD Atomic Shared Ptr Stack"
-    );
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench
+            .title(
+                "lockfree stack, " + std::to_string(num_threads) + " threads"
+            )
+            .relative(true);
+        run_benchmark<lockfree_stack_boost<int>>(
+            bench, "Boost Atomic Shared Ptr Stack", num_threads
+        );
+        run_benchmark<lockfree_stack<int, tinystd::hazard_pointer_policy>>(
+            bench,
+            "TinySTD Atomic Shared Ptr Stack (hazard pointer)",
+            num_threads
+        );
+        run_benchmark<lockfree_stack<int, tinystd::split_count_policy>>(
+            bench, "TinySTD Atomic Shared Ptr Stack (split count)", num_threads
+        );
+    }
+
+    auto const make_boost = [](size_t i)
+    { return boost::make_shared<size_t>(i); };
+    auto const make_tinystd = [](size_t i)
+    { return tinystd::make_shared<size_t>(i); };
+    // read scaling is measured on at least 32 threads even on smaller hosts
+    size_t const max_load_threads = std::max<size_t>(max_threads, 32);
+    for (size_t num_threads = 1; num_threads <= max_load_threads;
+         num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("load, " + std::to_string(num_threads) + " threads")
+            .relative(true);
+        run_load_benchmark<boost::atomic_shared_ptr<size_t>>(
+            bench, "boost::atomic_shared_ptr", num_threads, make_boost
+        );
+        run_load_benchmark<
+            tinystd::atomic_shared_ptr<size_t, tinystd::hazard_pointer_policy>>(
+            bench,
+            "tinystd::atomic_shared_ptr (hazard pointer)",
+            num_threads,
+            make_tinystd
+        );
+        run_load_benchmark<
+            tinystd::atomic_shared_ptr<size_t, tinystd::split_count_policy>>(
+            bench,
+            "tinystd::atomic_shared_ptr (split count)",
+            num_threads,
+            make_tinystd
+        );
+        run_load_benchmark<
+            tinystd::atomic_shared_ptr<size_t, tinystd::snapshot_policy>,
+            true>(
+            bench,
+            "tinystd::atomic_shared_ptr::load_snapshot",
+            num_threads,
+            make_tinystd
+        );
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,152 @@
+#include <nanobench.h>
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+import std;
+import tinystd;
+
+// the usual replacement for a concurrent map: a fixed number of shards, each
+// a std::unordered_map behind a std::shared_mutex
+template <typename K, typename V>
+class sharded_map
+{
+public:
+    auto
+    find(K const & key) const -> std::optional<V>
+    {
+        auto&            s = shard_of(key);
+        std::shared_lock lock{s.mutex};
+        auto const       it = s.map.find(key);
+        if (it == s.map.end()) return std::nullopt;
+        return it->second;
+    }
+
+    auto
+    insert_or_assign(K key, V value) -> bool
+    {
+        auto&            s = shard_of(key);
+        std::unique_lock lock{s.mutex};
+        return s.map.insert_or_assign(std::move(key), std::move(value)).second;
+    }
+
+    auto
+    erase(K const & key) -> bool
+    {
+        auto&            s = shard_of(key);
+        std::unique_lock lock{s.mutex};
+        return s.map.erase(key) != 0;
+    }
+
+private:
+    constexpr static std::size_t num_shards = 64;
+
+    struct alignas(std::hardware_destructive_interference_size) shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<K, V>  map;
+    };
+
+    std::array<shard, num_shards> m_shards;
+
+    auto
+    shard_of(K const & key) const -> shard const &
+    {
+        return m_shards[std::hash<K>{}(key) % num_shards];
+    }
+
+    auto
+    shard_of(K const & key) -> shard&
+    {
+        return m_shards[std::hash<K>{}(key) % num_shards];
+    }
+};
+
+// Every thread looks up, inserts or erases random keys out of key_range, a
+// write is one of every write_period operations (alternately an insert and an
+// erase). The map is filled with half of the keys before.
+template <typename Map>
+void
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    size_t                    write_period
+)
+{
+    size_t const operations_per_thread = 1000000;
+    size_t const key_range             = 1 << 16;
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                Map map;
+                for (size_t i = 0; i < key_range; i += 2)
+                {
+                    map.insert_or_assign(i, i);
+                }
+
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            std::minstd_rand rng(t);
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                size_t const key = rng() % key_range;
+                                if (i % write_period != 0)
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        map.find(key)
+                                    );
+                                }
+                                else if (i / write_period % 2 == 0)
+                                {
+                                    map.insert_or_assign(key, i);
+                                }
+                                else { map.erase(key); }
+                            }
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+int
+main()
+{
+    size_t const max_threads = std::thread::hardware_concurrency();
+
+    // 90% reads and 50% reads
+    for (size_t write_period : {10, 2})
+    {
+        for (size_t num_threads = 1; num_threads <= max_threads;
+             num_threads *= 2)
+        {
+            ankerl::nanobench::Bench bench;
+            bench
+                .title(
+                    std::to_string(100 - 100 / write_period) + "% reads, "
+                    + std::to_string(num_threads) + " threads"
+                )
+                .relative(true);
+            run_benchmark<sharded_map<size_t, size_t>>(
+                bench, "sharded std::unordered_map", num_threads, write_period
+            );
+            run_benchmark<tinystd::concurrent_hash_map<size_t, size_t>>(
+                bench,
+                "tinystd::concurrent_hash_map",
+                num_threads,
+                write_period
+            );
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <nanobench.h>
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+import std;
+import tinystd;
+
+// the usual LRU cache: a fixed number of shards, each a std::list in recency
+// order indexed by a std::unordered_map behind a std::mutex; a hit moves the
+// entry to the front, so it takes the lock exclusively
+template <typename K, typename V>
+class sharded_lru_cache
+{
+public:
+    explicit sharded_lru_cache(std::size_t capacity)
+        : m_shard_capacity{capacity / num_shards}
+    {
+    }
+
+    auto
+    find(K const & key) -> std::shared_ptr<V const>
+    {
+        auto&            s = shard_of(key);
+        std::scoped_lock lock{s.mutex};
+        auto const       it = s.index.find(key);
+        if (it == s.index.end()) return nullptr;
+        s.order.splice(s.order.begin(), s.order, it->second);
+        return it->second->second;
+    }
+
+    void
+    insert(K key, V value)
+    {
+        auto&            s = shard_of(key);
+        std::scoped_lock lock{s.mutex};
+        if (s.index.contains(key)) return;
+        if (s.index.size() == m_shard_capacity)
+        {
+            s.index.erase(s.order.back().first);
+            s.order.pop_back();
+        }
+        s.order.emplace_front(key, std::make_shared<V const>(std::move(value)));
+        s.index.emplace(std::move(key), s.order.begin());
+    }
+
+private:
+    constexpr static std::size_t num_shards = 16;
+
+    using list_t = std::list<std::pair<K, std::shared_ptr<V const>>>;
+
+    struct alignas(std::hardware_destructive_interference_size) shard
+    {
+        std::mutex                                       mutex;
+        list_t                                           order;
+        std::unordered_map<K, typename list_t::iterator> index;
+    };
+
+    std::size_t                   m_shard_capacity;
+    std::array<shard, num_shards> m_shards;
+
+    auto
+    shard_of(K const & key) -> shard&
+    {
+        return m_shards[std::hash<K>{}(key) % num_shards];
+    }
+};
+
+// Every thread looks up random keys out of key_range, all of them cached:
+// the hit path only.
+template <typename Cache>
+void
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    size_t                    key_range
+)
+{
+    size_t const operations_per_thread = 1000000;
+
+    // every shard could hold all the keys, nothing is evicted
+    Cache cache(16 * key_range * (sizeof(size_t) + sizeof(size_t)));
+    for (size_t i = 0; i < key_range; ++i) cache.insert(i, i);
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            std::minstd_rand rng(t);
+                            size_t           sum = 0;
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                sum += *cache.find(rng() % key_range);
+                            }
+                            ankerl::nanobench::doNotOptimizeAway(sum);
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+int
+main()
+{
+    size_t const max_threads = std::thread::hardware_concurrency();
+
+    for (size_t key_range : {size_t{1} << 16, size_t{64}})
+    {
+        for (size_t num_threads = 1; num_threads <= max_threads;
+             num_threads *= 2)
+        {
+            ankerl::nanobench::Bench bench;
+            bench
+                .title(
+                    "hits out of " + std::to_string(key_range) + " keys, "
+                    + std::to_string(num_threads) + " threads"
+                )
+                .relative(true);
+            run_benchmark<sharded_lru_cache<size_t, size_t>>(
+                bench,
+                "std::list + std::unordered_map + std::mutex",
+                num_threads,
+                key_range
+            );
+            run_benchmark<tinystd::concurrent_lru_cache<size_t, size_t>>(
+                bench, "tinystd::concurrent_lru_cache", num_threads, key_range
+            );
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// std::map behind a std::shared_mutex, scans and lookups share the lock
+template <typename K, typename V>
+class locked_map
+{
+public:
+    auto
+    find(K const & key) const -> std::optional<V>
+    {
+        std::shared_lock lock{m_mutex};
+        auto const       it = m_map.find(key);
+        if (it == m_map.end()) return std::nullopt;
+        return it->second;
+    }
+
+    auto
+    insert(K key, V value) -> bool
+    {
+        std::unique_lock lock{m_mutex};
+        return m_map.emplace(std::move(key), std::move(value)).second;
+    }
+
+    auto
+    erase(K const & key) -> bool
+    {
+        std::unique_lock lock{m_mutex};
+        return m_map.erase(key) != 0;
+    }
+
+    template <typename F>
+    void
+    for_each(K const & first, K const & last, F&& fn) const
+    {
+        std::shared_lock lock{m_mutex};
+        for (auto it = m_map.lower_bound(first);
+             it != m_map.end() && it->first < last;
+             ++it)
+        {
+            fn(it->first, it->second);
+        }
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::map<K, V>            m_map;
+};
+
+// Every thread works on random keys out of key_range, the map is filled with
+// half of the keys before. With scan_length > 0 a read is a scan of that many
+// keys, otherwise a lookup. A write is one of every write_period operations
+// (alternately an insert and an erase).
+template <typename Map>
+void
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    size_t                    write_period,
+    size_t                    scan_length
+)
+{
+    size_t const operations_per_thread = scan_length ? 100000 : 1000000;
+    size_t const key_range             = 1 << 16;
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                Map map;
+                for (size_t i = 0; i < key_range; i += 2) map.insert(i, i);
+
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            std::minstd_rand rng(t);
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                size_t const key = rng() % key_range;
+                                if (i % write_period != 0 && scan_length)
+                                {
+                                    size_t sum = 0;
+                                    map.for_each(
+                                        key,
+                                        key + scan_length,
+                                        [&](size_t, size_t value)
+                                        { sum += value; }
+                                    );
+                                    ankerl::nanobench::doNotOptimizeAway(sum);
+                                }
+                                else if (i % write_period != 0)
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        map.find(key)
+                                    );
+                                }
+                                else if (i / write_period % 2 == 0)
+                                {
+                                    map.insert(key, i);
+                                }
+                                else { map.erase(key); }
+                            }
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+int
+main()
+{
+    size_t const max_threads = std::thread::hardware_concurrency();
+
+    struct workload
+    {
+        std::string name;
+        size_t      write_period;
+        size_t      scan_length;
+    };
+
+    for (auto const & [name, write_period, scan_length] :
+         {workload{"range scans of 64 keys, 10% updates", 10, 64},
+          workload{"50% lookups, 50% updates", 2, 0}})
+    {
+        for (size_t num_threads = 1; num_threads <= max_threads;
+             num_threads *= 2)
+        {
+            ankerl::nanobench::Bench bench;
+            bench.title(name + ", " + std::to_string(num_threads) + " threads")
+                .relative(true);
+            run_benchmark<locked_map<size_t, size_t>>(
+                bench,
+                "std::map + std::shared_mutex",
+                num_threads,
+                write_period,
+                scan_length
+            );
+            run_benchmark<tinystd::concurrent_skip_list<size_t, size_t>>(
+                bench,
+                "tinystd::concurrent_skip_list",
+                num_threads,
+                write_period,
+                scan_length
+            );
+        }
+    }
+
+    return 0;
+}
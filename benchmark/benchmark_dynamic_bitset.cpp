@@ -0,0 +1,169 @@
+#include <boost/dynamic_bitset.hpp>
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+constexpr std::size_t bits = std::size_t{1} << 20;
+
+// a sparse bitmap: every 1000th bit set, and a dense one: every 3rd bit
+template <typename Bitset>
+auto
+make(std::size_t step) -> Bitset
+{
+    Bitset bitset(bits);
+    for (std::size_t i = 0; i < bits; i += step)
+    {
+        if constexpr (std::same_as<Bitset, std::vector<bool>>)
+        {
+            bitset[i] = true;
+        }
+        else { bitset.set(i); }
+    }
+    return bitset;
+}
+
+void
+benchmark_count(ankerl::nanobench::Bench& bench)
+{
+    auto const vector_bool = make<std::vector<bool>>(3);
+    auto const boost_bits  = make<boost::dynamic_bitset<std::uint64_t>>(3);
+    auto const tiny_bits   = make<tinystd::dynamic_bitset>(3);
+
+    bench.title("count 1M bits").relative(true);
+    bench.run(
+        "std::vector<bool>",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                std::ranges::count(vector_bool, true)
+            );
+        }
+    );
+    bench.run(
+        "boost::dynamic_bitset",
+        [&] { ankerl::nanobench::doNotOptimizeAway(boost_bits.count()); }
+    );
+    bench.run(
+        "tinystd::dynamic_bitset",
+        [&] { ankerl::nanobench::doNotOptimizeAway(tiny_bits.count()); }
+    );
+}
+
+void
+benchmark_and(ankerl::nanobench::Bench& bench)
+{
+    auto       vector_bool  = make<std::vector<bool>>(3);
+    auto const vector_other = make<std::vector<bool>>(5);
+    auto       boost_bits   = make<boost::dynamic_bitset<std::uint64_t>>(3);
+    auto const boost_other  = make<boost::dynamic_bitset<std::uint64_t>>(5);
+    auto       tiny_bits    = make<tinystd::dynamic_bitset>(3);
+    auto const tiny_other   = make<tinystd::dynamic_bitset>(5);
+
+    bench.title("1M bits &= 1M bits").relative(true);
+    bench.run(
+        "std::vector<bool>",
+        [&]
+        {
+            for (std::size_t i = 0; i < bits; ++i)
+            {
+                vector_bool[i] = vector_bool[i] && vector_other[i];
+            }
+            ankerl::nanobench::doNotOptimizeAway(vector_bool);
+        }
+    );
+    bench.run(
+        "boost::dynamic_bitset",
+        [&]
+        {
+            boost_bits &= boost_other;
+            ankerl::nanobench::doNotOptimizeAway(boost_bits);
+        }
+    );
+    bench.run(
+        "tinystd::dynamic_bitset",
+        [&]
+        {
+            tiny_bits &= tiny_other;
+            ankerl::nanobench::doNotOptimizeAway(tiny_bits);
+        }
+    );
+}
+
+// visit every set bit of a sparse bitmap
+void
+benchmark_iterate(ankerl::nanobench::Bench& bench)
+{
+    auto const vector_bool = make<std::vector<bool>>(1000);
+    auto const boost_bits  = make<boost::dynamic_bitset<std::uint64_t>>(1000);
+    auto const tiny_bits   = make<tinystd::dynamic_bitset>(1000);
+
+    bench.title("visit the set bits of a sparse 1M bitmap").relative(true);
+    bench.run(
+        "std::vector<bool>",
+        [&]
+        {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < bits; ++i)
+            {
+                if (vector_bool[i]) sum += i;
+            }
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+    bench.run(
+        "boost::dynamic_bitset (find_next)",
+        [&]
+        {
+            std::size_t sum = 0;
+            for (auto i = boost_bits.find_first();
+                 i != boost::dynamic_bitset<std::uint64_t>::npos;
+                 i = boost_bits.find_next(i))
+            {
+                sum += i;
+            }
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+    bench.run(
+        "tinystd::dynamic_bitset (find_next)",
+        [&]
+        {
+            std::size_t sum = 0;
+            for (auto i = tiny_bits.find_first();
+                 i != tinystd::dynamic_bitset::npos;
+                 i = tiny_bits.find_next(i))
+            {
+                sum += i;
+            }
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+    bench.run(
+        "tinystd::dynamic_bitset (set_bits)",
+        [&]
+        {
+            std::size_t sum = 0;
+            for (std::size_t const i : tiny_bits.set_bits()) sum += i;
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+}
+
+int
+main()
+{
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_count(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_and(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_iterate(bench);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <boost/container/flat_map.hpp>
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// `size` shuffled even keys, so half of the looked up keys miss
+auto
+make_keys(std::size_t size) -> std::vector<std::uint64_t>
+{
+    std::vector<std::uint64_t> keys(size);
+    for (std::size_t i = 0; i < size; ++i) keys[i] = 2 * i;
+    std::ranges::shuffle(keys, std::mt19937_64{42});
+    return keys;
+}
+
+template <typename Map>
+void
+run_lookup(
+    ankerl::nanobench::Bench&          bench,
+    char const *                       name,
+    std::vector<std::uint64_t> const & keys
+)
+{
+    Map map;
+    for (std::uint64_t const key : keys) map[key] = key;
+
+    std::mt19937_64                              rng{7};
+    std::uniform_int_distribution<std::uint64_t> dist(0, 2 * keys.size());
+    bench.run(
+        name,
+        [&] { ankerl::nanobench::doNotOptimizeAway(map.find(dist(rng))); }
+    );
+}
+
+template <typename Map>
+void
+run_build(
+    ankerl::nanobench::Bench&          bench,
+    char const *                       name,
+    std::vector<std::uint64_t> const & keys
+)
+{
+    bench.run(
+        name,
+        [&]
+        {
+            Map map;
+            for (std::uint64_t const key : keys) map.emplace(key, key);
+            ankerl::nanobench::doNotOptimizeAway(map);
+        }
+    );
+}
+
+// one bulk insert of all elements, sorted once
+void
+run_bulk_build(
+    ankerl::nanobench::Bench& bench, std::vector<std::uint64_t> const & keys
+)
+{
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> elements;
+    for (std::uint64_t const key : keys) elements.emplace_back(key, key);
+    bench.run(
+        "tinystd::flat_map insert_range",
+        [&]
+        {
+            tinystd::flat_map<std::uint64_t, std::uint64_t> map;
+            map.insert_range(elements);
+            ankerl::nanobench::doNotOptimizeAway(map);
+        }
+    );
+}
+
+int
+main()
+{
+    using key_t = std::uint64_t;
+
+    for (std::size_t const size : {16, 256, 4096, 65536})
+    {
+        auto const keys = make_keys(size);
+
+        ankerl::nanobench::Bench bench;
+        bench.title(std::format("find in {} elements", size)).relative(true);
+        run_lookup<std::map<key_t, key_t>>(bench, "std::map", keys);
+        run_lookup<boost::container::flat_map<key_t, key_t>>(
+            bench, "boost::container::flat_map", keys
+        );
+        run_lookup<tinystd::flat_map<key_t, key_t>>(
+            bench, "tinystd::flat_map", keys
+        );
+    }
+
+    for (std::size_t const size : {16, 256, 4096})
+    {
+        auto const keys = make_keys(size);
+
+        ankerl::nanobench::Bench bench;
+        bench.title(std::format("build from {} shuffled elements", size))
+            .relative(true);
+        run_build<std::map<key_t, key_t>>(bench, "std::map", keys);
+        run_build<boost::container::flat_map<key_t, key_t>>(
+            bench, "boost::container::flat_map", keys
+        );
+        run_build<tinystd::flat_map<key_t, key_t>>(
+            bench, "tinystd::flat_map", keys
+        );
+        run_bulk_build(bench, keys);
+    }
+}
@@ -0,0 +1,162 @@
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// the stack built on atomic_shared_ptr, as in benchmark_atomic_shared_ptr.cpp
+template <typename T>
+class shared_ptr_stack
+{
+private:
+    struct node
+    {
+        T                         data;
+        tinystd::shared_ptr<node> next; // every node is managed by shared_ptr
+    };
+    tinystd::atomic_shared_ptr<node> head;
+
+public:
+    void
+    push(T const & data)
+    {
+        tinystd::shared_ptr<node> new_node{
+            new node{data, head.load(std::memory_order_relaxed)}
+        };
+        while (!head.compare_exchange_weak(
+            new_node->next,
+            std::move(new_node),
+            std::memory_order_release,
+            std::memory_order_relaxed
+        ));
+    }
+
+    std::optional<T>
+    pop() noexcept
+    {
+        tinystd::shared_ptr<node> old_head =
+            head.load(std::memory_order_relaxed);
+        while (old_head
+               && !head.compare_exchange_weak(
+                   old_head,
+                   std::move(old_head->next),
+                   std::memory_order_acquire,
+                   std::memory_order_relaxed
+               ));
+        std::optional<T> item;
+        if (old_head) item.emplace(std::move(old_head->data));
+        return item;
+    }
+};
+
+// adapts boost::lockfree::stack/queue to the interface of the others
+template <typename Container>
+class boost_adaptor
+{
+public:
+    void
+    push(int data)
+    {
+        while (!m_container.push(data));
+    }
+
+    std::optional<int>
+    pop() noexcept
+    {
+        int data;
+        if (m_container.pop(data)) return data;
+        return std::nullopt;
+    }
+
+private:
+    Container m_container{1024};
+};
+
+template <typename Container, bool is_producer>
+void
+worker(Container& container, size_t operations)
+{
+    for (size_t i = 0; i < operations; ++i)
+    {
+        if constexpr (is_producer) { container.push(i); }
+        else { while (!container.pop()); }
+    }
+}
+
+// half of the threads push, the other half pop
+template <typename Container>
+void
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads
+)
+{
+    size_t const operations_per_thread = 1000000;
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                Container                container;
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+
+                for (size_t i = 0; i < num_threads / 2; ++i)
+                {
+                    threads.emplace_back(
+                        worker<Container, true>,
+                        std::ref(container),
+                        operations_per_thread
+                    );
+                    threads.emplace_back(
+                        worker<Container, false>,
+                        std::ref(container),
+                        operations_per_thread
+                    );
+                }
+
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+int
+main()
+{
+    size_t const max_threads = std::thread::hardware_concurrency();
+
+    for (size_t num_threads = 2; num_threads <= max_threads; num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("stack, " + std::to_string(num_threads) + " threads")
+            .relative(true);
+        run_benchmark<shared_ptr_stack<int>>(
+            bench, "atomic_shared_ptr based stack", num_threads
+        );
+        run_benchmark<boost_adaptor<boost::lockfree::stack<int>>>(
+            bench, "boost::lockfree::stack", num_threads
+        );
+        run_benchmark<tinystd::lockfree_stack<int>>(
+            bench, "tinystd::lockfree_stack", num_threads
+        );
+    }
+
+    for (size_t num_threads = 2; num_threads <= max_threads; num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("queue, " + std::to_string(num_threads) + " threads")
+            .relative(true);
+        run_benchmark<boost_adaptor<boost::lockfree::queue<int>>>(
+            bench, "boost::lockfree::queue", num_threads
+        );
+        run_benchmark<tinystd::lockfree_queue<int>>(
+            bench, "tinystd::lockfree_queue", num_threads
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+struct node
+{
+    std::uint64_t key;
+    std::uint64_t value;
+    node*         left;
+    node*         right;
+};
+
+// allocate and deallocate a node through one of the allocators below
+struct new_delete
+{
+    static auto
+    create(std::uint64_t i) -> node*
+    {
+        return new node{i, i, nullptr, nullptr};
+    }
+
+    static void
+    destroy(node* p) noexcept
+    {
+        delete p;
+    }
+};
+
+struct pmr_pool
+{
+    inline static std::pmr::synchronized_pool_resource resource;
+
+    static auto
+    create(std::uint64_t i) -> node*
+    {
+        auto const p = resource.allocate(sizeof(node), alignof(node));
+        return std::construct_at(static_cast<node*>(p), i, i, nullptr, nullptr);
+    }
+
+    static void
+    destroy(node* p) noexcept
+    {
+        std::destroy_at(p);
+        resource.deallocate(p, sizeof(node), alignof(node));
+    }
+};
+
+template <typename Policy>
+struct tinystd_pool
+{
+    using pool = tinystd::object_pool<node, Policy>;
+
+    static auto
+    create(std::uint64_t i) -> node*
+    {
+        return pool::create(i, i, nullptr, nullptr);
+    }
+
+    static void
+    destroy(node* p) noexcept
+    {
+        pool::destroy(p);
+    }
+};
+
+// Keeps a window of live nodes and replaces a random one on every iteration,
+// allocations and deallocations happen on the same thread.
+template <typename Alloc>
+void
+benchmark_churn(ankerl::nanobench::Bench& bench, char const * name)
+{
+    constexpr std::size_t window = 4096;
+    std::vector<node*>    live(window);
+    for (std::size_t i = 0; i < window; ++i) live[i] = Alloc::create(i);
+
+    std::minstd_rand rng(42);
+    std::uint64_t    i = 0;
+    bench.run(
+        name,
+        [&]
+        {
+            auto& slot = live[rng() % window];
+            Alloc::destroy(slot);
+            slot = Alloc::create(++i);
+            ankerl::nanobench::doNotOptimizeAway(slot);
+        }
+    );
+
+    for (auto p : live) Alloc::destroy(p);
+}
+
+// The producer allocates nodes and passes them to the consumer, which
+// deallocates them: every block travels from one thread to the other.
+template <typename Alloc>
+void
+benchmark_cross_thread(ankerl::nanobench::Bench& bench, char const * name)
+{
+    constexpr int                       items = 1000000;
+    tinystd::waitfree_spsc_queue<node*> q(1024);
+    bench.minEpochIterations(10).batch(items).run(
+        name,
+        [&]
+        {
+            std::jthread producer(
+                [&]
+                {
+                    for (int i = 0; i < items; ++i)
+                    {
+                        auto const p = Alloc::create(i);
+                        while (!q.emplace(p));
+                    }
+                }
+            );
+            std::jthread consumer(
+                [&]
+                {
+                    for (int i = 0; i < items; ++i)
+                    {
+                        std::optional<node*> p;
+                        while (!(p = q.pop()));
+                        Alloc::destroy(*p);
+                    }
+                }
+            );
+        }
+    );
+}
+
+int
+main()
+{
+    ankerl::nanobench::Bench bench;
+
+    bench.title("allocation churn, one thread").relative(true);
+    benchmark_churn<new_delete>(bench, "new/delete");
+    benchmark_churn<pmr_pool>(bench, "std::pmr::synchronized_pool_resource");
+    benchmark_churn<tinystd_pool<tinystd::heap_slab_policy>>(
+        bench, "tinystd::object_pool"
+    );
+    benchmark_churn<tinystd_pool<tinystd::hugepage_slab_policy>>(
+        bench, "tinystd::object_pool (huge pages)"
+    );
+
+    bench.title("allocation across threads").relative(true);
+    benchmark_cross_thread<new_delete>(bench, "new/delete");
+    benchmark_cross_thread<pmr_pool>(
+        bench, "std::pmr::synchronized_pool_resource"
+    );
+    benchmark_cross_thread<tinystd_pool<tinystd::heap_slab_policy>>(
+        bench, "tinystd::object_pool"
+    );
+    benchmark_cross_thread<tinystd_pool<tinystd::hugepage_slab_policy>>(
+        bench, "tinystd::object_pool (huge pages)"
+    );
+
+    return 0;
+}
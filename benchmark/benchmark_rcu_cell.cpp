@@ -0,0 +1,114 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// A small routing table, read by every thread, replaced by thread 0 in one
+// of every 1024 operations.
+using table = std::array<std::uint64_t, 16>;
+
+template <typename Read, typename Update>
+void
+run_read_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    Read                      read,
+    Update                    update
+)
+{
+    size_t const operations_per_thread = 1000000;
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                if (t == 0 && i % 1024 == 0) { update(i); }
+                                else
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        read(i % 16)
+                                    );
+                                }
+                            }
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+template <typename Policy>
+void
+run_atomic_shared_ptr_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads
+)
+{
+    tinystd::atomic_shared_ptr<table, Policy> asp(
+        tinystd::make_shared<table>()
+    );
+    run_read_benchmark(
+        bench,
+        name,
+        num_threads,
+        [&](size_t i) { return (*asp.load())[i]; },
+        [&](size_t i)
+        {
+            auto next = tinystd::make_shared<table>();
+            next->fill(i);
+            asp.store(std::move(next));
+        }
+    );
+}
+
+int
+main()
+{
+    // read scaling is measured on at least 32 threads even on smaller hosts
+    size_t const max_threads =
+        std::max<size_t>(std::thread::hardware_concurrency(), 32);
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("read, " + std::to_string(num_threads) + " threads")
+            .relative(true);
+
+        run_atomic_shared_ptr_benchmark<tinystd::hazard_pointer_policy>(
+            bench, "tinystd::atomic_shared_ptr (hazard pointer)", num_threads
+        );
+        run_atomic_shared_ptr_benchmark<tinystd::split_count_policy>(
+            bench, "tinystd::atomic_shared_ptr (split count)", num_threads
+        );
+
+        tinystd::rcu_cell<table> cell;
+        run_read_benchmark(
+            bench,
+            "tinystd::rcu_cell",
+            num_threads,
+            [&](size_t i) { return (*cell.read())[i]; },
+            [&](size_t i)
+            {
+                table next;
+                next.fill(i);
+                cell.update(next);
+            }
+        );
+    }
+
+    return 0;
+}
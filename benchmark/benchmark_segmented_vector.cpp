@@ -0,0 +1,106 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// 64 bytes, big enough that relocating on growth shows
+struct payload
+{
+    std::array<std::uint64_t, 8> words;
+};
+
+template <typename Vector>
+void
+run_grow(ankerl::nanobench::Bench& bench, char const * name, std::size_t n)
+{
+    bench.run(
+        name,
+        [&]
+        {
+            Vector v;
+            for (std::size_t i = 0; i < n; ++i) v.push_back(payload{{i}});
+            ankerl::nanobench::doNotOptimizeAway(&v[n - 1]);
+        }
+    );
+}
+
+// push_back into a new container until it holds n elements, cost per
+// element: vector relocates everything on each doubling, which costs more
+// once the elements fall out of the cache, segmented_vector only adds chunks
+void
+benchmark_grow(ankerl::nanobench::Bench& bench, std::size_t n)
+{
+    bench.title("push_back " + std::to_string(n) + " elements of 64 bytes")
+        .relative(true)
+        .batch(n)
+        .unit("push_back");
+    bench.minEpochIterations(1);
+    run_grow<std::vector<payload>>(bench, "std::vector", n);
+    run_grow<std::deque<payload>>(bench, "std::deque", n);
+    run_grow<tinystd::vector<payload>>(bench, "tinystd::vector", n);
+    run_grow<tinystd::segmented_vector<payload>>(
+        bench, "tinystd::segmented_vector", n
+    );
+}
+
+// sum over every element, iterating chunk by chunk against contiguous
+void
+benchmark_iterate(ankerl::nanobench::Bench& bench)
+{
+    constexpr std::size_t n = std::size_t{1} << 20;
+
+    tinystd::vector<std::uint64_t>           contiguous;
+    tinystd::segmented_vector<std::uint64_t> segmented;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        contiguous.push_back(i);
+        segmented.push_back(i);
+    }
+
+    bench.title("sum 1M uint64_t").relative(true).batch(n).unit("element");
+    bench.run(
+        "tinystd::vector",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                std::accumulate(contiguous.begin(), contiguous.end(), 0ull)
+            );
+        }
+    );
+    bench.run(
+        "tinystd::segmented_vector (iterator)",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                std::accumulate(segmented.begin(), segmented.end(), 0ull)
+            );
+        }
+    );
+    bench.run(
+        "tinystd::segmented_vector (chunks)",
+        [&]
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < segmented.chunk_count(); ++i)
+            {
+                for (std::uint64_t x : segmented.chunk(i)) sum += x;
+            }
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+}
+
+int
+main()
+{
+    for (std::size_t const n : {1 << 10, 1 << 16, 1 << 22})
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_grow(bench, n);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_iterate(bench);
+    }
+    return 0;
+}
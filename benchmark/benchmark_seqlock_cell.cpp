@@ -0,0 +1,113 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+struct quote
+{
+    double        bid;
+    double        ask;
+    std::uint64_t bid_size;
+    std::uint64_t ask_size;
+};
+
+// Every thread reads the quote, thread 0 updates it in one of every 16
+// operations.
+template <typename Read, typename Update>
+void
+run_benchmark(
+    ankerl::nanobench::Bench& bench,
+    std::string const &       name,
+    size_t                    num_threads,
+    Read                      read,
+    Update                    update
+)
+{
+    size_t const operations_per_thread = 1000000;
+
+    bench.minEpochIterations(1)
+        .batch(num_threads * operations_per_thread)
+        .run(
+            name,
+            [&]
+            {
+                std::vector<std::thread> threads;
+                threads.reserve(num_threads);
+                for (size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            for (size_t i = 0; i < operations_per_thread; ++i)
+                            {
+                                if (t == 0 && i % 16 == 0)
+                                {
+                                    update(quote{
+                                        double(i), double(i + 1), i, i
+                                    });
+                                }
+                                else
+                                {
+                                    ankerl::nanobench::doNotOptimizeAway(
+                                        read().bid
+                                    );
+                                }
+                            }
+                        }
+                    );
+                }
+                for (auto& thread : threads) { thread.join(); }
+            }
+        );
+}
+
+int
+main()
+{
+    size_t const max_threads = std::thread::hardware_concurrency();
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("quote, " + std::to_string(num_threads) + " threads")
+            .relative(true);
+
+        std::mutex mutex;
+        quote      guarded{};
+        run_benchmark(
+            bench,
+            "std::mutex",
+            num_threads,
+            [&]
+            {
+                std::scoped_lock lock{mutex};
+                return guarded;
+            },
+            [&](quote const & q)
+            {
+                std::scoped_lock lock{mutex};
+                guarded = q;
+            }
+        );
+
+        tinystd::atomic_shared_ptr<quote> asp(tinystd::make_shared<quote>());
+        run_benchmark(
+            bench,
+            "tinystd::atomic_shared_ptr",
+            num_threads,
+            [&] { return *asp.load(); },
+            [&](quote const & q) { asp.store(tinystd::make_shared<quote>(q)); }
+        );
+
+        tinystd::seqlock_cell<quote> cell;
+        run_benchmark(
+            bench,
+            "tinystd::seqlock_cell",
+            num_threads,
+            [&] { return cell.load(); },
+            [&](quote const & q) { cell.store(q); }
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+struct message
+{
+    std::uint64_t id;
+    std::uint64_t payload[3];
+};
+
+struct recycled_message : message
+{
+};
+
+template <>
+inline constexpr bool
+    tinystd::enable_control_block_recycling<recycled_message> = true;
+
+template <template <typename> class SharedPtr, typename MakeShared>
+void
+benchmark_make_shared_churn(
+    ankerl::nanobench::Bench& bench, char const * name, MakeShared make
+)
+{
+    std::uint64_t id = 0;
+    bench.run(
+        name,
+        [&]
+        {
+            SharedPtr<message> sp = make(id++);
+            ankerl::nanobench::doNotOptimizeAway(sp->id);
+        }
+    );
+}
+
+template <typename SharedPtr, typename WeakPtr>
+void
+benchmark_weak_lock(
+    ankerl::nanobench::Bench& bench, char const * name, SharedPtr const & sp
+)
+{
+    WeakPtr wp(sp);
+    bench.run(
+        name,
+        [&]
+        {
+            auto locked = wp.lock();
+            ankerl::nanobench::doNotOptimizeAway(locked->id);
+        }
+    );
+}
+
+// Messages are allocated by a producer thread and released by a consumer
+// thread, so a block is allocated and deallocated on different threads.
+template <typename Message>
+void
+benchmark_allocation_throughput(
+    ankerl::nanobench::Bench& bench, char const * name
+)
+{
+    constexpr int items = 1000000;
+    tinystd::waitfree_spsc_queue<tinystd::shared_ptr<Message>> q(1024);
+    bench.minEpochIterations(10).batch(items).run(
+        name,
+        [&]
+        {
+            std::jthread producer(
+                [&]
+                {
+                    for (int i = 0; i < items; ++i)
+                    {
+                        auto msg = tinystd::make_shared<Message>();
+                        while (!q.emplace(std::move(msg)));
+                    }
+                }
+            );
+            std::jthread consumer(
+                [&]
+                {
+                    for (int i = 0; i < items; ++i)
+                    {
+                        while (!q.pop().has_value());
+                    }
+                }
+            );
+        }
+    );
+}
+
+int
+main()
+{
+    ankerl::nanobench::Bench bench;
+
+    bench.title("make_shared churn").relative(true);
+    benchmark_make_shared_churn<std::shared_ptr>(
+        bench,
+        "std::make_shared",
+        [](std::uint64_t id) { return std::make_shared<message>(id); }
+    );
+    benchmark_make_shared_churn<tinystd::shared_ptr>(
+        bench,
+        "tinystd::make_shared",
+        [](std::uint64_t id) { return tinystd::make_shared<message>(id); }
+    );
+    benchmark_make_shared_churn<tinystd::shared_ptr>(
+        bench,
+        "tinystd::make_shared (recycled control block)",
+        [](std::uint64_t id)
+        {
+            auto sp = tinystd::make_shared<recycled_message>();
+            sp->id  = id;
+            return sp;
+        }
+    );
+
+    bench.title("weak_ptr::lock").relative(true);
+    benchmark_weak_lock<std::shared_ptr<message>, std::weak_ptr<message>>(
+        bench, "std::weak_ptr::lock", std::make_shared<message>(0)
+    );
+    benchmark_weak_lock<
+        tinystd::shared_ptr<message>,
+        tinystd::weak_ptr<message>>(
+        bench, "tinystd::weak_ptr::lock", tinystd::make_shared<message>(0)
+    );
+
+    bench.title("make_shared allocation throughput across threads")
+        .relative(true);
+    benchmark_allocation_throughput<message>(bench, "tinystd::make_shared");
+    benchmark_allocation_throughput<recycled_message>(
+        bench, "tinystd::make_shared (recycled control block)"
+    );
+
+    return 0;
+}
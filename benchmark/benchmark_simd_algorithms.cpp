@@ -0,0 +1,109 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+constexpr std::size_t size = std::size_t{1} << 16;
+
+// random values, the searched one is only at the end
+template <typename T>
+auto
+make() -> tinystd::vector<T>
+{
+    std::mt19937_64                 rng{42};
+    std::uniform_int_distribution<> dist(0, 99);
+    tinystd::vector<T>              v;
+    for (std::size_t i = 0; i < size; ++i) v.push_back(T(dist(rng)));
+    v[size - 1] = T(100);
+    return v;
+}
+
+template <typename T>
+void
+run_algorithms(char const * type)
+{
+    auto const v     = make<T>();
+    auto const other = v;
+    // the type simd::sum adds in, so that both sums are the same
+    using sum_type = decltype(tinystd::simd::sum(v));
+
+    ankerl::nanobench::Bench bench;
+    bench.title(std::format("64K {}", type)).relative(true);
+
+    bench.run(
+        "std::ranges::find",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(std::ranges::find(v, T(100)));
+        }
+    );
+    bench.run(
+        "simd::find",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                tinystd::simd::find(v, T(100))
+            );
+        }
+    );
+    bench.run(
+        "std::ranges::count",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(std::ranges::count(v, T(7)));
+        }
+    );
+    bench.run(
+        "simd::count",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(tinystd::simd::count(v, T(7)));
+        }
+    );
+    bench.run(
+        "std::ranges::min",
+        [&] { ankerl::nanobench::doNotOptimizeAway(std::ranges::min(v)); }
+    );
+    bench.run(
+        "simd::min",
+        [&] { ankerl::nanobench::doNotOptimizeAway(tinystd::simd::min(v)); }
+    );
+    bench.run(
+        "std::reduce",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                std::reduce(v.begin(), v.end(), sum_type{})
+            );
+        }
+    );
+    bench.run(
+        "simd::sum",
+        [&] { ankerl::nanobench::doNotOptimizeAway(tinystd::simd::sum(v)); }
+    );
+    bench.run(
+        "std::ranges::equal",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(std::ranges::equal(v, other));
+        }
+    );
+    bench.run(
+        "simd::equal",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(
+                tinystd::simd::equal(v, other)
+            );
+        }
+    );
+}
+
+int
+main()
+{
+    run_algorithms<std::int8_t>("std::int8_t");
+    run_algorithms<std::int32_t>("std::int32_t");
+    run_algorithms<float>("float");
+    run_algorithms<double>("double");
+}
@@ -0,0 +1,84 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// 64 bytes per row, a loop that reads two fields of every row pulls whole
+// rows through the cache in the array-of-structures layout
+struct particle
+{
+    double x, y, z;
+    double vx, vy, vz;
+    double mass;
+    std::int64_t id;
+};
+
+using particles = tinystd::soa_vector<
+    double,
+    double,
+    double,
+    double,
+    double,
+    double,
+    double,
+    std::int64_t>;
+
+constexpr std::size_t rows = std::size_t{1} << 20;
+
+// sum x * mass over 1M rows, 2 of 8 fields
+void
+benchmark_sum_two_fields(ankerl::nanobench::Bench& bench)
+{
+    tinystd::vector<particle> aos;
+    particles                 soa;
+    soa.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        auto const d = static_cast<double>(i);
+        aos.push_back({d, d, d, 1.0, 1.0, 1.0, 0.5, std::int64_t(i)});
+        soa.emplace_back(d, d, d, 1.0, 1.0, 1.0, 0.5, std::int64_t(i));
+    }
+
+    bench.title("sum x * mass over 1M rows of 8 fields").relative(true);
+    bench.batch(rows).unit("row");
+    bench.run(
+        "tinystd::vector<particle>",
+        [&]
+        {
+            double sum = 0;
+            for (particle const & p : aos) sum += p.x * p.mass;
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+    bench.run(
+        "tinystd::soa_vector",
+        [&]
+        {
+            auto const x    = soa.column<0>();
+            auto const mass = soa.column<6>();
+            double     sum  = 0;
+            for (std::size_t i = 0; i < rows; ++i) sum += x[i] * mass[i];
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+    bench.run(
+        "tinystd::soa_vector (row iterator)",
+        [&]
+        {
+            double sum = 0;
+            for (auto const & row : std::as_const(soa))
+            {
+                sum += std::get<0>(row) * std::get<6>(row);
+            }
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+}
+
+int
+main()
+{
+    ankerl::nanobench::Bench bench;
+    benchmark_sum_two_fields(bench);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// Sum of squares over a vector, one fork-join per iteration: the pool
+// splits it with parallel_reduce, the baseline spawns one std::jthread per
+// hardware thread and joins them.
+void
+benchmark_fork_join(ankerl::nanobench::Bench& bench, std::size_t size)
+{
+    std::vector<double> data(size);
+    std::iota(data.begin(), data.end(), 0.0);
+    std::size_t const num_threads = std::thread::hardware_concurrency();
+
+    bench
+        .title(
+            "fork-join sum of squares, " + std::to_string(size) + " doubles"
+        )
+        .relative(true);
+    bench.run(
+        "std::jthread per hardware thread",
+        [&]
+        {
+            std::vector<double> partials(num_threads);
+            {
+                std::vector<std::jthread> threads;
+                for (std::size_t t = 0; t < num_threads; ++t)
+                {
+                    threads.emplace_back(
+                        [&, t]
+                        {
+                            auto const first = size * t / num_threads;
+                            auto const last  = size * (t + 1) / num_threads;
+                            double     acc   = 0;
+                            for (auto i = first; i < last; ++i)
+                            {
+                                acc += data[i] * data[i];
+                            }
+                            partials[t] = acc;
+                        }
+                    );
+                }
+            }
+            ankerl::nanobench::doNotOptimizeAway(
+                std::accumulate(partials.begin(), partials.end(), 0.0)
+            );
+        }
+    );
+
+    tinystd::thread_pool pool;
+    bench.run(
+        "tinystd::thread_pool::parallel_reduce",
+        [&]
+        {
+            ankerl::nanobench::doNotOptimizeAway(pool.parallel_reduce(
+                tinystd::span<double>(data.data(), data.size()),
+                0.0,
+                [](double acc, double x) { return acc + x * x; },
+                std::plus<>{}
+            ));
+        }
+    );
+}
+
+// Throughput of tiny independent tasks submitted from one thread: the pool
+// runs a task per submit, the baseline spawns a std::jthread per task.
+void
+benchmark_fine_grained(ankerl::nanobench::Bench& bench)
+{
+    constexpr int num_tasks = 10000;
+
+    bench.title("fine-grained tasks").relative(true);
+    bench.minEpochIterations(1).batch(num_tasks);
+
+    std::atomic<int> count{0};
+    bench.run(
+        "std::jthread per task",
+        [&]
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(num_tasks);
+            for (int i = 0; i < num_tasks; ++i)
+            {
+                threads.emplace_back(
+                    [&] { count.fetch_add(1, std::memory_order_relaxed); }
+                );
+            }
+        }
+    );
+
+    tinystd::thread_pool pool;
+    bench.run(
+        "tinystd::thread_pool::submit",
+        [&]
+        {
+            std::latch done{num_tasks};
+            for (int i = 0; i < num_tasks; ++i)
+            {
+                pool.submit(
+                    [&]
+                    {
+                        count.fetch_add(1, std::memory_order_relaxed);
+                        done.count_down();
+                    }
+                );
+            }
+            done.wait();
+        }
+    );
+}
+
+int
+main()
+{
+    for (std::size_t size : {std::size_t{1} << 12, std::size_t{1} << 22})
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_fork_join(bench, size);
+    }
+
+    ankerl::nanobench::Bench bench;
+    benchmark_fine_grained(bench);
+
+    return 0;
+}
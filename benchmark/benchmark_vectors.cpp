@@ -0,0 +1,297 @@
+#include <boost/container/small_vector.hpp>
+#include <nanobench.h>
+
+import std;
+import tinystd;
+
+// owns a heap int, trivially relocatable through `[[clang::trivial_abi]]`
+// but not trivially copyable: std::vector shifts it with a move-construct
+// and destroy per element, tinystd vectors with memmove
+struct [[clang::trivial_abi]] handle
+{
+    int* ptr;
+
+    explicit handle(int i) : ptr(new int(i)) {}
+
+    handle(handle&& other) noexcept : ptr(std::exchange(other.ptr, nullptr)) {}
+
+    auto
+    operator=(handle&& other) noexcept -> handle&
+    {
+        std::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    ~handle() { delete ptr; }
+};
+
+static_assert(__is_trivially_relocatable(handle));
+
+template <typename Vector>
+void
+run_build_small(ankerl::nanobench::Bench& bench, char const * name)
+{
+    bench.run(
+        name,
+        [&]
+        {
+            Vector v;
+            for (int i = 0; i < 8; ++i) v.push_back(i);
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+}
+
+// a short-lived vector of 8 ints, the inline buffers avoid the allocation
+void
+benchmark_build_small(ankerl::nanobench::Bench& bench)
+{
+    bench.title("push_back 8 ints into a new vector").relative(true);
+    run_build_small<std::vector<int>>(bench, "std::vector");
+    run_build_small<boost::container::small_vector<int, 16>>(
+        bench, "boost::container::small_vector<16>"
+    );
+    run_build_small<tinystd::vector<int>>(bench, "tinystd::vector");
+    run_build_small<tinystd::small_vector<int, 16>>(
+        bench, "tinystd::small_vector<16>"
+    );
+}
+
+template <typename Vector>
+void
+run_middle_insert_erase(ankerl::nanobench::Bench& bench, char const * name)
+{
+    constexpr int size = 1000;
+
+    Vector v;
+    for (int i = 0; i < size; ++i) v.emplace_back(i);
+    int i = 0;
+    bench.run(
+        name,
+        [&]
+        {
+            v.emplace(v.begin() + size / 2, ++i);
+            v.erase(v.begin() + size / 3);
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+}
+
+// insert into and erase from the middle of 1000 handles, the tail shift
+// dominates
+void
+benchmark_middle_insert_erase(ankerl::nanobench::Bench& bench)
+{
+    bench.title("insert + erase in the middle of 1000 handles").relative(true);
+    run_middle_insert_erase<std::vector<handle>>(bench, "std::vector");
+    run_middle_insert_erase<boost::container::small_vector<handle, 16>>(
+        bench, "boost::container::small_vector<16>"
+    );
+    run_middle_insert_erase<tinystd::vector<handle>>(bench, "tinystd::vector");
+    run_middle_insert_erase<tinystd::small_vector<handle, 16>>(
+        bench, "tinystd::small_vector<16>"
+    );
+}
+
+template <typename Vector>
+void
+run_append(
+    ankerl::nanobench::Bench& bench,
+    char const *              name,
+    std::vector<int> const &  source
+)
+{
+    bench.run(
+        name,
+        [&]
+        {
+            Vector v;
+            v.insert(v.end(), source.begin(), source.end());
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+    bench.run(
+        std::string(name) + " (push_back loop)",
+        [&]
+        {
+            Vector v;
+            for (int x : source) v.push_back(x);
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+}
+
+// fill a new vector from a range of 10000 ints, the range insert allocates
+// once and copies in bulk, the push_back loop grows by doubling
+void
+benchmark_append(ankerl::nanobench::Bench& bench)
+{
+    std::vector<int> source(10000);
+    std::iota(source.begin(), source.end(), 0);
+
+    bench.title("append 10000 ints to a new vector").relative(true);
+    run_append<std::vector<int>>(bench, "std::vector", source);
+    run_append<boost::container::small_vector<int, 16>>(
+        bench, "boost::container::small_vector<16>", source
+    );
+    run_append<tinystd::vector<int>>(bench, "tinystd::vector", source);
+    run_append<tinystd::small_vector<int, 16>>(
+        bench, "tinystd::small_vector<16>", source
+    );
+}
+
+template <typename Vector>
+void
+run_grow_huge(ankerl::nanobench::Bench& bench, char const * name)
+{
+    constexpr std::size_t chunk = std::size_t{1} << 20;
+    constexpr std::size_t total = std::size_t{1} << 28;
+
+    bench.run(
+        name,
+        [&]
+        {
+            Vector v;
+            while (v.size() < total)
+            {
+                v.append_for_overwrite(chunk)[0] = std::byte{1};
+            }
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+}
+
+// grow a buffer to 256 MiB in 1 MiB appends without reserving: relocating
+// copies everything on every doubling, mremap only moves page table entries
+void
+benchmark_grow_huge(ankerl::nanobench::Bench& bench)
+{
+    bench.title("grow a byte buffer to 256 MiB").relative(true);
+    bench.minEpochIterations(1).epochs(5);
+    run_grow_huge<tinystd::vector<std::byte>>(bench, "std::allocator");
+    run_grow_huge<
+        tinystd::vector<std::byte, tinystd::huge_buffer_allocator<std::byte>>>(
+        bench, "huge_buffer_allocator"
+    );
+    run_grow_huge<tinystd::vector<
+        std::byte,
+        tinystd::huge_buffer_allocator<std::byte, std::size_t{1} << 20, true>>>(
+        bench, "huge_buffer_allocator (transparent huge pages)"
+    );
+}
+
+template <typename Vector>
+void
+run_many_tiny(ankerl::nanobench::Bench& bench, char const * name)
+{
+    constexpr int count = 100000;
+
+    // the footprint goes into the name, the time is dominated by cache misses
+    bench.run(
+        std::string(name) + " (" + std::to_string(sizeof(Vector)) + " bytes)",
+        [&]
+        {
+            std::vector<Vector> vectors(count);
+            for (int i = 0; i < count; ++i)
+            {
+                for (int j = 0; j < 3; ++j) vectors[i].push_back(i + j);
+            }
+            int sum = 0;
+            for (Vector const & v : vectors) sum += v[0] + v[v.size() - 1];
+            ankerl::nanobench::doNotOptimizeAway(sum);
+        }
+    );
+}
+
+// 100000 vectors of 3 ints each, as in the nodes of an index: the stored
+// size type and an inline capacity that fills a cache line decide the
+// footprint
+void
+benchmark_many_tiny(ankerl::nanobench::Bench& bench)
+{
+    using compact = tinystd::small_vector_options<std::uint32_t>;
+    using tiny    = tinystd::small_vector_options<std::uint16_t>;
+
+    bench.title("build and read 100000 vectors of 3 ints").relative(true);
+    run_many_tiny<std::vector<int>>(bench, "std::vector");
+    run_many_tiny<tinystd::vector<int>>(bench, "tinystd::vector");
+    run_many_tiny<tinystd::vector<int, std::allocator<int>, compact>>(
+        bench, "tinystd::vector<uint32_t size>"
+    );
+    run_many_tiny<tinystd::small_vector<int, 4>>(
+        bench, "tinystd::small_vector<4>"
+    );
+    run_many_tiny<tinystd::small_vector<int, 4, std::allocator<int>, tiny>>(
+        bench, "tinystd::small_vector<4, uint16_t size>"
+    );
+    run_many_tiny<tinystd::small_vector<
+        int,
+        tinystd::inline_capacity_for<int, 64, std::allocator<int>, compact>,
+        std::allocator<int>,
+        compact>>(bench, "tinystd::small_vector<64 bytes, uint32_t size>");
+}
+
+template <typename Vector>
+void
+run_push_1000(ankerl::nanobench::Bench& bench, char const * name)
+{
+    bench.run(
+        name,
+        [&]
+        {
+            Vector v;
+            for (int i = 0; i < 1000; ++i) v.push_back(i);
+            ankerl::nanobench::doNotOptimizeAway(v.data());
+        }
+    );
+}
+
+template <typename StoredSize, std::size_t Numerator, std::size_t Denominator>
+using growing_vector = tinystd::vector<
+    int,
+    std::allocator<int>,
+    tinystd::small_vector_options<StoredSize, Numerator, Denominator>>;
+
+// push_back 1000 ints into a new vector, a smaller growth factor
+// reallocates more often but wastes less memory
+void
+benchmark_growth_factor(ankerl::nanobench::Bench& bench)
+{
+    bench.title("push_back 1000 ints by growth factor").relative(true);
+    run_push_1000<growing_vector<std::size_t, 2, 1>>(bench, "2");
+    run_push_1000<growing_vector<std::size_t, 3, 2>>(bench, "1.5");
+    run_push_1000<growing_vector<std::uint32_t, 3, 2>>(
+        bench, "1.5, uint32_t size"
+    );
+    run_push_1000<growing_vector<std::size_t, 4, 1>>(bench, "4");
+}
+
+int
+main()
+{
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_build_small(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_middle_insert_erase(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_append(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_many_tiny(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_growth_factor(bench);
+    }
+    {
+        ankerl::nanobench::Bench bench;
+        benchmark_grow_huge(bench);
+    }
+    return 0;
+}
@@ -0,0 +1,457 @@
+module;
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+
+export module tinystd:async_logger;
+
+import std;
+import :shared_ptr;
+import :waitfree_spsc_queue;
+
+namespace tinystd
+{
+
+// what log() does when the queue of the calling thread is full
+export enum class log_overflow
+{
+    drop,  // discard the record and count it, see dropped()
+    block, // wait until the drain thread makes room
+};
+
+// Bytes of a log record, the arguments of one log() call must fit into it.
+export constexpr std::size_t log_record_size = 256;
+
+// A log record: the format string, a function formatting the record and the
+// raw bytes of the arguments. Strings are copied into the record (truncated
+// to the room left), other arguments must be trivially copyable.
+class log_record
+{
+public:
+    template <typename... Args>
+    log_record(std::string_view fmt, Args const &... args) noexcept
+        : m_format{&format_args<std::remove_cvref_t<Args>...>}
+        , m_fmt{fmt.data()}
+        , m_fmt_size{static_cast<std::uint32_t>(fmt.size())}
+    {
+        constexpr std::size_t fixed =
+            (std::size_t{0} + ... + fixed_size<Args>());
+        static_assert(fixed <= payload_size, "too many arguments to log");
+        std::size_t offset        = 0;
+        std::size_t string_budget = payload_size - fixed;
+        (encode(offset, string_budget, args), ...);
+    }
+
+    // appends the formatted record and a new line to out
+    void
+    format_to(std::string& out) const
+    {
+        m_format(out, *this);
+        out.push_back('\n');
+    }
+
+private:
+    using format_t = void (*)(std::string&, log_record const &);
+
+    constexpr static std::size_t payload_size =
+        log_record_size - sizeof(format_t) - sizeof(char const*)
+        - sizeof(std::uint32_t);
+
+    template <typename T>
+    constexpr static bool is_string =
+        std::convertible_to<T const &, std::string_view>;
+
+    // strings are decoded as a view into the record
+    template <typename T>
+    using decoded_t =
+        std::conditional_t<is_string<T>, std::string_view, std::decay_t<T>>;
+
+    format_t                            m_format;
+    char const*                         m_fmt;
+    std::uint32_t                       m_fmt_size;
+    std::array<std::byte, payload_size> m_payload;
+
+    // bytes of an argument that cannot be truncated, the length of a string
+    template <typename T>
+    constexpr static auto
+    fixed_size() noexcept -> std::size_t
+    {
+        if constexpr (is_string<T>) { return sizeof(std::uint32_t); }
+        else
+        {
+            static_assert(
+                std::is_trivially_copyable_v<std::decay_t<T>>,
+                "log arguments must be strings or trivially copyable"
+            );
+            return sizeof(std::decay_t<T>);
+        }
+    }
+
+    template <typename T>
+    void
+    encode(std::size_t& offset, std::size_t& string_budget, T const & arg)
+        noexcept
+    {
+        if constexpr (is_string<T>)
+        {
+            std::string_view const str = arg;
+            auto const size = static_cast<std::uint32_t>(
+                std::min(str.size(), string_budget)
+            );
+            string_budget -= size;
+            auto const dest = m_payload.data() + offset;
+            std::memcpy(dest, &size, sizeof(size));
+            std::memcpy(dest + sizeof(size), str.data(), size);
+            offset += sizeof(size) + size;
+        }
+        else
+        {
+            std::decay_t<T> const value = arg;
+            std::memcpy(m_payload.data() + offset, &value, sizeof(value));
+            offset += sizeof(value);
+        }
+    }
+
+    template <typename T>
+    auto
+    decode(std::size_t& offset) const noexcept -> decoded_t<T>
+    {
+        if constexpr (is_string<T>)
+        {
+            auto const    src = m_payload.data() + offset;
+            std::uint32_t size;
+            std::memcpy(&size, src, sizeof(size));
+            std::string_view const str{
+                reinterpret_cast<char const*>(src + sizeof(size)), size
+            };
+            offset += sizeof(size) + size;
+            return str;
+        }
+        else
+        {
+            // through bytes, T need not be default constructible
+            std::array<std::byte, sizeof(decoded_t<T>)> bytes;
+            std::memcpy(bytes.data(), m_payload.data() + offset, bytes.size());
+            offset += bytes.size();
+            return std::bit_cast<decoded_t<T>>(bytes);
+        }
+    }
+
+    template <typename... Args>
+    static void
+    format_args(std::string& out, log_record const & record)
+    {
+        std::size_t offset = 0;
+        // braced initialization decodes the arguments in order
+        std::tuple<decoded_t<Args>...> const values{
+            record.template decode<Args>(offset)...
+        };
+        std::apply(
+            [&](auto const &... args)
+            {
+                std::vformat_to(
+                    std::back_inserter(out),
+                    std::string_view{record.m_fmt, record.m_fmt_size},
+                    std::make_format_args(args...)
+                );
+            },
+            values
+        );
+    }
+};
+
+// Asynchronous logger, log() only copies its arguments into a record.
+// - Every thread logging to a logger gets its own waitfree_spsc_queue of
+//   records on its first log() call, so producers never contend with each
+//   other.
+// - A drain thread polls the queues, formats the records into one buffer
+//   per queue and writes all the buffers with one writev call, then sleeps
+//   for poll_interval when every queue was empty.
+// - Records of one thread are written in order, records of different
+//   threads are interleaved by batches.
+// - The queue of an exiting thread is drained and dropped.
+// - The format string must outlive the logger (string literals do).
+// - No thread may log while the logger is destroyed, the destructor writes
+//   every queued record.
+export class async_logger
+{
+public:
+    explicit async_logger(
+        int                       fd             = STDERR_FILENO,
+        log_overflow              overflow       = log_overflow::drop,
+        std::size_t               queue_capacity = 1024,
+        std::chrono::microseconds poll_interval  = std::chrono::milliseconds{1}
+    )
+        : m_id{next_id.fetch_add(1, std::memory_order_relaxed)}
+        , m_fd{fd}
+        , m_overflow{overflow}
+        , m_queue_capacity{queue_capacity}
+        , m_poll_interval{poll_interval}
+        , m_thread{[this](std::stop_token stop) { run(stop); }}
+    {
+    }
+
+    // no copy/move semantics
+    async_logger(async_logger const &) = delete;
+    auto
+    operator=(async_logger const &) = delete;
+
+    ~async_logger() noexcept
+    {
+        m_thread.request_stop();
+        m_thread.join();
+        for (auto const & p : m_producers)
+        {
+            p->orphaned.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename... Args>
+    void
+    log(std::format_string<Args...> fmt, Args&&... args)
+    {
+        auto& queue = local_producer().queue;
+        if (queue.emplace(fmt.get(), args...)) [[likely]] { return; }
+        if (m_overflow == log_overflow::drop)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        while (!queue.emplace(fmt.get(), args...)) std::this_thread::yield();
+    }
+
+    // blocks until every record logged before is written
+    void
+    flush()
+    {
+        // The pass after the current one starts after the call, it sees
+        // every record logged before the call.
+        auto const target = m_passes.load(std::memory_order_seq_cst) + 2;
+        for (auto pass = m_passes.load(std::memory_order_acquire);
+             pass < target;
+             pass = m_passes.load(std::memory_order_acquire))
+        {
+            m_passes.wait(pass, std::memory_order_acquire);
+        }
+    }
+
+    // number of records discarded with log_overflow::drop
+    [[nodiscard]] auto
+    dropped() const noexcept -> std::size_t
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct producer
+    {
+        explicit producer(std::size_t capacity) : queue(capacity) {}
+
+        waitfree_spsc_queue<log_record> queue;
+        std::atomic<bool>               closed{false};   // thread exited
+        std::atomic<bool>               orphaned{false}; // logger destroyed
+
+        // drain thread only
+        std::string buffer;
+        bool        drained_closed = false; // empty for good, to be removed
+    };
+
+    // owned by the thread, closes the producer when the thread exits
+    struct handle
+    {
+        std::uint64_t        logger_id;
+        shared_ptr<producer> p;
+
+        handle(std::uint64_t id, shared_ptr<producer> ptr) noexcept
+            : logger_id{id}
+            , p{std::move(ptr)}
+        {
+        }
+        handle(handle&&) noexcept = default;
+        auto
+        operator=(handle&&) noexcept -> handle& = default;
+
+        ~handle()
+        {
+            if (p) p->closed.store(true, std::memory_order_release);
+        }
+    };
+
+    struct local_producers
+    {
+        std::uint64_t       last_id = 0;
+        producer*           last    = nullptr;
+        std::vector<handle> handles;
+    };
+
+    inline static std::atomic<std::uint64_t> next_id{1};
+    inline static thread_local local_producers local{};
+
+    std::uint64_t const             m_id;
+    int const                       m_fd;
+    log_overflow const              m_overflow;
+    std::size_t const               m_queue_capacity;
+    std::chrono::microseconds const m_poll_interval;
+
+    std::atomic<std::size_t> m_dropped{0};
+    std::atomic<std::size_t> m_passes{0};
+
+    // registered producers, m_version is bumped on every change
+    std::mutex                        m_mutex;
+    std::vector<shared_ptr<producer>> m_producers;
+    std::atomic<std::size_t>          m_version{0};
+
+    // last member, stopped and joined before the others are destroyed
+    std::jthread m_thread;
+
+    auto
+    local_producer() -> producer&
+    {
+        if (local.last_id == m_id) [[likely]] { return *local.last; }
+
+        auto it = std::ranges::find(local.handles, m_id, &handle::logger_id);
+        if (it == local.handles.end())
+        {
+            std::erase_if(
+                local.handles,
+                [](handle const & h)
+                { return h.p->orphaned.load(std::memory_order_relaxed); }
+            );
+            auto p = make_shared<producer>(m_queue_capacity);
+            {
+                std::scoped_lock lock{m_mutex};
+                m_producers.push_back(p);
+                m_version.fetch_add(1, std::memory_order_release);
+            }
+            local.handles.emplace_back(m_id, std::move(p));
+            it = std::prev(local.handles.end());
+        }
+        local.last_id = m_id;
+        local.last    = it->p.get();
+        return *local.last;
+    }
+
+    void
+    run(std::stop_token stop)
+    {
+        std::vector<shared_ptr<producer>> producers;
+        std::vector<::iovec>              iov;
+        std::size_t                       version = 0;
+        while (true)
+        {
+            // checked before draining, so that the last pass sees every
+            // record logged before the stop
+            bool const stopping = stop.stop_requested();
+            if (m_version.load(std::memory_order_acquire) != version)
+            {
+                std::scoped_lock lock{m_mutex};
+                version   = m_version.load(std::memory_order_relaxed);
+                producers = m_producers;
+            }
+
+            std::size_t num_records = 0;
+            bool        any_closed  = false;
+            for (auto const & p : producers)
+            {
+                // No record is pushed to a producer closed before the
+                // drain, it is drained until its queue is empty.
+                p->drained_closed = p->closed.load(std::memory_order_acquire);
+                any_closed       |= p->drained_closed;
+                num_records      += drain(*p, p->drained_closed);
+            }
+            write_buffers(producers, iov);
+
+            if (any_closed) remove_closed();
+            m_passes.fetch_add(1, std::memory_order_seq_cst);
+            m_passes.notify_all();
+
+            if (num_records == 0)
+            {
+                if (stopping) break;
+                std::this_thread::sleep_for(m_poll_interval);
+            }
+        }
+    }
+
+    // Formats the records of p into its buffer, at most queue_capacity of
+    // them unless until_empty so that a fast producer cannot hold up the
+    // pass.
+    auto
+    drain(producer& p, bool until_empty) -> std::size_t
+    {
+        std::size_t count = 0;
+        for (; until_empty || count < m_queue_capacity; ++count)
+        {
+            auto record = p.queue.pop();
+            if (!record) break;
+            try
+            {
+                record->format_to(p.buffer);
+            }
+            catch (std::exception const & e)
+            {
+                p.buffer.append("<log format error: ")
+                    .append(e.what())
+                    .append(">\n");
+            }
+        }
+        return count;
+    }
+
+    // writes the buffers of all producers with as few writev calls as
+    // possible, then clears them
+    void
+    write_buffers(
+        std::vector<shared_ptr<producer>> const & producers,
+        std::vector<::iovec>&                     iov
+    ) noexcept
+    {
+        iov.clear();
+        for (auto const & p : producers)
+        {
+            if (p->buffer.empty()) continue;
+            iov.push_back({p->buffer.data(), p->buffer.size()});
+        }
+
+        for (std::size_t first = 0; first < iov.size();)
+        {
+            auto const count =
+                std::min<std::size_t>(iov.size() - first, IOV_MAX);
+            auto const written =
+                ::writev(m_fd, &iov[first], static_cast<int>(count));
+            if (written < 0)
+            {
+                if (errno == EINTR) continue;
+                break; // nowhere to report it, the records are lost
+            }
+            // skip what is written, resume a partial write
+            auto remaining = static_cast<std::size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len)
+            {
+                remaining -= iov[first++].iov_len;
+            }
+            if (remaining > 0)
+            {
+                iov[first].iov_base =
+                    static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+
+        for (auto const & p : producers) p->buffer.clear();
+    }
+
+    void
+    remove_closed()
+    {
+        std::scoped_lock lock{m_mutex};
+        std::erase_if(
+            m_producers,
+            [](shared_ptr<producer> const & p) { return p->drained_closed; }
+        );
+        m_version.fetch_add(1, std::memory_order_release);
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,592 @@
+export module tinystd:concurrent_hash_map;
+
+import std;
+import :size_class_cache;
+import :pooled_allocation;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Concurrent hash map with lock-free reads.
+// - Every bucket points to an immutable chain: an array of (hash, node*)
+//   entries. A write to a bucket builds a new chain under the bucket's
+//   spinlock, publishes it with a single store and retires the old chain
+//   through hazard_pointer, so a reader protects one chain and scans it
+//   without any lock or reference count.
+// - A node is shared by all chains containing it and counts them, it is
+//   destroyed when the last chain containing it is reclaimed. Readers never
+//   touch the counts.
+// - Incremental resizing: when the map grows beyond one entry per bucket, a
+//   table with twice as many buckets is published, whose buckets are
+//   "unmigrated". Every write then migrates a few buckets of the old table,
+//   splitting each chain into two; readers of an unmigrated bucket look it up
+//   in the old table. A new resize starts only after the previous migration
+//   is complete.
+// - Old tables are kept until the map is destroyed: they are bucket arrays of
+//   at most half the size of the current one, so readers do not need to
+//   protect the table.
+export template <
+    typename K,
+    typename V,
+    typename Hash     = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>>
+class concurrent_hash_map
+{
+    struct node
+    {
+        K                          key;
+        V                          value;
+        std::atomic<std::uint32_t> num_chains{0};
+    };
+
+    struct entry
+    {
+        std::size_t hash;
+        node*       n;
+    };
+
+    // allocated with its entries right after it
+    struct chain
+    {
+        std::size_t size;
+
+        auto
+        entries() noexcept -> entry*
+        {
+            return reinterpret_cast<entry*>(this + 1);
+        }
+    };
+
+    struct bucket
+    {
+        std::atomic<chain*> head{nullptr};
+        std::atomic<bool>   locked{false};
+    };
+
+    struct table
+    {
+        std::size_t               mask;
+        table*                    prev; // migrated into this table
+        std::atomic<std::size_t>  migrate_cursor{0};
+        std::atomic<std::size_t>  num_migrated{0};
+        std::unique_ptr<bucket[]> buckets;
+
+        table(std::size_t size, table* prev_table)
+            : mask{size - 1}
+            , prev{prev_table}
+            , buckets{std::make_unique<bucket[]>(size)}
+        {
+            if (prev)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    buckets[i].head.store(
+                        unmigrated(), std::memory_order_relaxed
+                    );
+                }
+            }
+        }
+
+        auto
+        size() const noexcept -> std::size_t
+        {
+            return mask + 1;
+        }
+
+        auto
+        get_bucket(std::size_t hash) noexcept -> bucket&
+        {
+            return buckets[hash & mask];
+        }
+
+        auto
+        migrating() const noexcept -> bool
+        {
+            return prev
+                && num_migrated.load(std::memory_order_acquire)
+                       != prev->size();
+        }
+    };
+
+public:
+    using key_type    = K;
+    using mapped_type = V;
+
+    concurrent_hash_map() : concurrent_hash_map(16) {}
+    explicit concurrent_hash_map(std::size_t bucket_count)
+        : m_table{new table(
+              std::bit_ceil(std::max<std::size_t>(bucket_count, 2)), nullptr
+          )}
+    {
+    }
+
+    // no copy/move semantics
+    concurrent_hash_map(concurrent_hash_map const &) = delete;
+    auto
+    operator=(concurrent_hash_map const &) = delete;
+
+    // No other thread may access the map. Chains retired earlier are still
+    // reclaimed by later hazard pointer scans.
+    ~concurrent_hash_map() noexcept
+    {
+        auto t = m_table.load(std::memory_order_relaxed);
+        while (t)
+        {
+            for (std::size_t i = 0; i < t->size(); ++i)
+            {
+                auto const c =
+                    t->buckets[i].head.load(std::memory_order_relaxed);
+                if (!is_sentinel(c)) release_chain(c);
+            }
+            delete std::exchange(t, t->prev);
+        }
+    }
+
+    // Calls fn(value) while the entry is protected and returns whether the
+    // key is found. fn must not access a concurrent_hash_map of the same type
+    // (one hazard pointer per thread and type).
+    template <std::invocable<V const &> F>
+    auto
+    visit(K const & key, F&& fn) const -> bool
+    {
+        auto const h  = hash(key);
+        auto       hp = make_hazard_pointer<chain>();
+        auto       c  = protect_chain(hp, h);
+        if (c == nullptr) return false;
+        auto const entries = c->entries();
+        for (std::size_t i = 0; i < c->size; ++i)
+        {
+            if (entries[i].hash == h && m_equal(entries[i].n->key, key))
+            {
+                std::invoke(
+                    std::forward<F>(fn), std::as_const(entries[i].n->value)
+                );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto
+    find(K const & key) const -> std::optional<V>
+    {
+        std::optional<V> result;
+        visit(key, [&](V const & value) { result.emplace(value); });
+        return result;
+    }
+
+    [[nodiscard]] auto
+    contains(K const & key) const -> bool
+    {
+        return visit(key, [](V const &) {});
+    }
+
+    // returns whether the key is inserted, an existing value is kept
+    template <typename... Args>
+    auto
+    emplace(K key, Args&&... args) -> bool
+    {
+        auto const h = hash(key);
+        auto const n =
+            pooled_new<node>(std::move(key), V(std::forward<Args>(args)...));
+        bool linked = false;
+        bool inserted;
+        try
+        {
+            inserted = write_bucket(
+                h,
+                [&](bucket& b, chain* c) -> bool
+                {
+                    if (find_entry(c, h, n->key) != npos) return false;
+                    publish(b, c, copy_chain(c, npos, entry{h, n}));
+                    linked = true;
+                    return true;
+                }
+            );
+        }
+        catch (...)
+        {
+            // e.g. the new chain could not be allocated
+            if (!linked) pooled_delete(n);
+            throw;
+        }
+        if (!inserted)
+        {
+            pooled_delete(n);
+            return false;
+        }
+        grow_if_needed(m_size.fetch_add(1, std::memory_order_relaxed) + 1);
+        return true;
+    }
+
+    auto
+    insert(K key, V value) -> bool
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    // returns whether the key is inserted rather than assigned
+    auto
+    insert_or_assign(K key, V value) -> bool
+    {
+        auto const h = hash(key);
+        auto const n = pooled_new<node>(std::move(key), std::move(value));
+        bool       linked = false;
+        bool       inserted;
+        try
+        {
+            inserted = write_bucket(
+                h,
+                [&](bucket& b, chain* c) -> bool
+                {
+                    // readers of the old chain still see the old node
+                    auto const i = find_entry(c, h, n->key);
+                    publish(b, c, copy_chain(c, i, entry{h, n}));
+                    linked = true;
+                    return i == npos;
+                }
+            );
+        }
+        catch (...)
+        {
+            if (!linked) pooled_delete(n);
+            throw;
+        }
+        if (!inserted) return false;
+        grow_if_needed(m_size.fetch_add(1, std::memory_order_relaxed) + 1);
+        return true;
+    }
+
+    // returns whether the key is erased
+    auto
+    erase(K const & key) -> bool
+    {
+        auto const h      = hash(key);
+        auto const erased = write_bucket(
+            h,
+            [&](bucket& b, chain* c) -> bool
+            {
+                auto const i = find_entry(c, h, key);
+                if (i == npos) return false;
+                publish(b, c, copy_chain(c, i, std::nullopt));
+                return true;
+            }
+        );
+        if (erased) m_size.fetch_sub(1, std::memory_order_relaxed);
+        return erased;
+    }
+
+    // might be outdated once it returns
+    [[nodiscard]] auto
+    size() const noexcept -> std::size_t
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+private:
+    constexpr static std::size_t npos = std::numeric_limits<std::size_t>::max();
+    constexpr static std::size_t migration_batch    = 8;
+    constexpr static int         spins_before_yield = 64;
+
+    std::atomic<table*>      m_table;
+    std::atomic<std::size_t> m_size{0};
+    std::mutex               m_resize_mutex;
+
+    [[no_unique_address]] Hash     m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+    // a bucket of a new table whose chain is still in the previous table
+    [[nodiscard]] static auto
+    unmigrated() noexcept -> chain*
+    {
+        // never dereferenced
+        return reinterpret_cast<chain*>(std::uintptr_t{1});
+    }
+
+    // a bucket of an old table whose chain is moved to the next table
+    [[nodiscard]] static auto
+    migrated() noexcept -> chain*
+    {
+        return reinterpret_cast<chain*>(std::uintptr_t{2});
+    }
+
+    [[nodiscard]] static auto
+    is_sentinel(chain* c) noexcept -> bool
+    {
+        return c == nullptr || c == unmigrated() || c == migrated();
+    }
+
+    // Mixes the bits so that the low bits used as bucket index depend on the
+    // whole hash (std::hash of integers is the identity).
+    [[nodiscard]] auto
+    hash(K const & key) const noexcept -> std::size_t
+    {
+        std::uint64_t h = m_hash(key);
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15;
+        h ^= h >> 29;
+        return static_cast<std::size_t>(h);
+    }
+
+    // Returns the protected chain of the bucket of hash, or nullptr if it is
+    // empty.
+    auto
+    protect_chain(hazard_pointer<chain>& hp, std::size_t h) const noexcept
+        -> chain*
+    {
+        auto t = m_table.load(std::memory_order_acquire);
+        while (true)
+        {
+            auto c = hp.protect(t->get_bucket(h).head);
+            if (c == unmigrated())
+            {
+                c = hp.protect(t->prev->get_bucket(h).head);
+                // migrated meanwhile, read the bucket of t again
+                if (c == migrated()) continue;
+            }
+            else if (c == migrated())
+            {
+                t = m_table.load(std::memory_order_acquire);
+                continue;
+            }
+            return c;
+        }
+    }
+
+    static void
+    lock(bucket& b) noexcept
+    {
+        for (int i = 0; b.locked.exchange(true, std::memory_order_acquire);
+             ++i)
+        {
+            if (i >= spins_before_yield) std::this_thread::yield();
+        }
+    }
+
+    static void
+    unlock(bucket& b) noexcept
+    {
+        b.locked.store(false, std::memory_order_release);
+    }
+
+    // Calls write(bucket, chain) with the bucket of hash locked, in the table
+    // that currently holds the chain of the bucket, then helps the migration.
+    template <typename F>
+    auto
+    write_bucket(std::size_t h, F&& write) -> bool
+    {
+        while (true)
+        {
+            auto const t = m_table.load(std::memory_order_acquire);
+            auto&      b = t->get_bucket(h);
+            lock(b);
+            auto const c = b.head.load(std::memory_order_relaxed);
+            if (c == migrated())
+            {
+                unlock(b);
+                continue;
+            }
+            if (c == unmigrated())
+            {
+                unlock(b);
+                migrate_bucket(t, h & t->prev->mask);
+                continue;
+            }
+
+            bool result;
+            try
+            {
+                result = write(b, c);
+            }
+            catch (...)
+            {
+                unlock(b);
+                throw;
+            }
+            unlock(b);
+            help_migrate(t);
+            return result;
+        }
+    }
+
+    auto
+    find_entry(chain* c, std::size_t h, K const & key) const -> std::size_t
+    {
+        if (c == nullptr) return npos;
+        auto const entries = c->entries();
+        for (std::size_t i = 0; i < c->size; ++i)
+        {
+            if (entries[i].hash == h && m_equal(entries[i].n->key, key))
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    static auto
+    chain_bytes(std::size_t size) noexcept -> std::size_t
+    {
+        return sizeof(chain) + size * sizeof(entry);
+    }
+
+    // small chains are recycled through size_class_cache
+    static auto
+    allocate_chain(std::size_t size) -> chain*
+    {
+        auto const bytes = chain_bytes(size);
+        auto const ptr   = bytes <= size_class_cache::max_size
+                             ? size_class_cache::allocate(bytes)
+                             : ::operator new(bytes);
+        return std::construct_at(static_cast<chain*>(ptr), size);
+    }
+
+    // drops the count of every node of c, then frees c
+    static void
+    release_chain(chain* c) noexcept
+    {
+        auto const entries = c->entries();
+        for (std::size_t i = 0; i < c->size; ++i)
+        {
+            auto const n = entries[i].n;
+            if (n->num_chains.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                pooled_delete(n);
+            }
+        }
+        auto const bytes = chain_bytes(c->size);
+        if (bytes <= size_class_cache::max_size)
+        {
+            size_class_cache::deallocate(c, bytes);
+        }
+        else { ::operator delete(c, bytes); }
+    }
+
+    // Copy of c without its entry at index skip (npos to keep all entries)
+    // and with extra prepended, nullptr if it is empty.
+    static auto
+    copy_chain(chain* c, std::size_t skip, std::optional<entry> extra)
+        -> chain*
+    {
+        auto const old_size = c ? c->size : 0;
+        auto const size     = old_size - (skip != npos) + extra.has_value();
+        if (size == 0) return nullptr;
+
+        auto const  result  = allocate_chain(size);
+        auto const  entries = result->entries();
+        std::size_t j       = 0;
+        if (extra) entries[j++] = *extra;
+        for (std::size_t i = 0; i < old_size; ++i)
+        {
+            if (i != skip) entries[j++] = c->entries()[i];
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            entries[i].n->num_chains.fetch_add(1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // replaces old_chain of the locked bucket b by new_chain
+    static void
+    publish(bucket& b, chain* old_chain, chain* new_chain) noexcept
+    {
+        b.head.store(new_chain, std::memory_order_release);
+        if (old_chain)
+        {
+            hazard_pointer<chain>::retire(old_chain, &release_chain);
+        }
+    }
+
+    void
+    grow_if_needed(std::size_t size)
+    {
+        auto const t = m_table.load(std::memory_order_acquire);
+        if (size <= t->size() || t->migrating()) return;
+
+        std::unique_lock lock{m_resize_mutex, std::try_to_lock};
+        if (!lock || m_table.load(std::memory_order_relaxed) != t) return;
+        m_table.store(new table(t->size() * 2, t), std::memory_order_release);
+    }
+
+    // migrates a few buckets of the previous table of t
+    void
+    help_migrate(table* t) noexcept
+    {
+        if (!t->migrating()) return;
+        auto const prev_size = t->prev->size();
+        auto const begin     = t->migrate_cursor.fetch_add(
+            migration_batch, std::memory_order_relaxed
+        );
+        auto const end = std::min(begin + migration_batch, prev_size);
+        for (auto i = begin; i < end; ++i) migrate_bucket(t, i);
+    }
+
+    // Splits the chain of bucket i of the previous table of t into buckets i
+    // and i + prev_size of t. Lock order: low and high bucket of t, then the
+    // bucket of the previous table. The buckets stay unusable if a chain
+    // cannot be allocated, so running out of memory here terminates.
+    void
+    migrate_bucket(table* t, std::size_t i) noexcept
+    {
+        auto const prev      = t->prev;
+        auto const prev_size = prev->size();
+        auto&      low       = t->buckets[i];
+        auto&      high      = t->buckets[i + prev_size];
+        auto&      old       = prev->buckets[i];
+        lock(low);
+        lock(high);
+        lock(old);
+        auto const c = old.head.load(std::memory_order_relaxed);
+        if (c != migrated())
+        {
+            auto [low_chain, high_chain] = split_chain(c, prev_size);
+            low.head.store(low_chain, std::memory_order_release);
+            high.head.store(high_chain, std::memory_order_release);
+            // readers seeing migrated find the chains above in t
+            old.head.store(migrated(), std::memory_order_release);
+            if (c) hazard_pointer<chain>::retire(c, &release_chain);
+            t->num_migrated.fetch_add(1, std::memory_order_release);
+        }
+        unlock(old);
+        unlock(high);
+        unlock(low);
+    }
+
+    // entries whose hash has the bit prev_size set go to the high chain
+    static auto
+    split_chain(chain* c, std::size_t prev_size) noexcept
+        -> std::pair<chain*, chain*>
+    {
+        if (c == nullptr) return {nullptr, nullptr};
+        std::size_t num_high = 0;
+        for (std::size_t i = 0; i < c->size; ++i)
+        {
+            num_high += (c->entries()[i].hash & prev_size) != 0;
+        }
+        auto const fill = [&](bool is_high, std::size_t size) -> chain*
+        {
+            if (size == 0) return nullptr;
+            auto const  result = allocate_chain(size);
+            std::size_t j      = 0;
+            for (std::size_t i = 0; i < c->size; ++i)
+            {
+                auto const e = c->entries()[i];
+                if (((e.hash & prev_size) != 0) != is_high) continue;
+                e.n->num_chains.fetch_add(1, std::memory_order_relaxed);
+                result->entries()[j++] = e;
+            }
+            return result;
+        };
+        return {fill(false, c->size - num_high), fill(true, num_high)};
+    }
+};
+
+} // namespace tinystd
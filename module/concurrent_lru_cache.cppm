@@ -0,0 +1,284 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:concurrent_lru_cache;
+
+import std;
+import :shared_ptr;
+import :concurrent_hash_map;
+
+namespace tinystd
+{
+
+// Default weight of a cache entry: the bytes of the key and the value
+// themselves, without the memory they own.
+export struct sizeof_weigher
+{
+    template <typename K, typename V>
+    auto
+    operator()(K const &, V const &) const noexcept -> std::size_t
+    {
+        return sizeof(K) + sizeof(V);
+    }
+};
+
+// Concurrent cache with a capacity in bytes and CLOCK eviction, an
+// approximation of LRU.
+// - Lookups go through a concurrent_hash_map, lock-free. A hit sets the
+//   referenced bit of the entry (only if it is clear, so that hot entries do
+//   not bounce their cache line between readers) and copies the shared_ptr
+//   to the value.
+// - Values are immutable and handed out as shared_ptr<V const>: an evicted
+//   or replaced value stays alive as long as a reader holds it. The entry
+//   itself is reclaimed through the hazard pointers of the map.
+// - Writes are serialized per shard (by hash of the key). Every shard owns
+//   capacity / num_shards bytes and a ring of its entries swept by a clock
+//   hand: a referenced entry gets its bit cleared and a second chance, an
+//   unreferenced one is evicted.
+// - Entries weigh weigher(key, value) bytes, an entry heavier than the
+//   capacity of a shard is never cached.
+export template <
+    typename K,
+    typename V,
+    typename Hash     = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>,
+    typename Weigher  = sizeof_weigher>
+    requires std::copy_constructible<K>
+class concurrent_lru_cache
+{
+    struct entry
+    {
+        K                   key;
+        shared_ptr<V const> value;
+        std::size_t         bytes;
+        std::size_t         index; // in the ring of its shard
+        std::atomic<bool>   referenced{false};
+    };
+
+    struct alignas(std::hardware_destructive_interference_size) shard
+    {
+        std::mutex               mutex;
+        std::vector<entry*>      ring;
+        std::size_t              hand{0};
+        std::atomic<std::size_t> bytes{0}; // written with mutex held
+    };
+
+public:
+    using key_type    = K;
+    using mapped_type = V;
+
+    explicit concurrent_lru_cache(
+        std::size_t capacity_bytes, std::size_t num_shards = 16
+    )
+        : m_shard_mask{std::bit_ceil(std::max<std::size_t>(num_shards, 1)) - 1}
+        , m_shard_capacity{capacity_bytes / (m_shard_mask + 1)}
+        , m_shards{std::make_unique<shard[]>(m_shard_mask + 1)}
+    {
+    }
+
+    // no copy/move semantics
+    concurrent_lru_cache(concurrent_lru_cache const &) = delete;
+    auto
+    operator=(concurrent_lru_cache const &) = delete;
+
+    // Returns the cached value, or nullptr on a miss. Lock-free.
+    [[nodiscard]] auto
+    find(K const & key) const -> shared_ptr<V const>
+    {
+        shared_ptr<V const> result;
+        m_map.visit(
+            key, [&](std::unique_ptr<entry> const & e) { result = touch(*e); }
+        );
+        return result;
+    }
+
+    [[nodiscard]] auto
+    contains(K const & key) const -> bool
+    {
+        return m_map.contains(key);
+    }
+
+    // Returns the cached value of key. On a miss, calls make() without any
+    // lock held and caches its result, unless another thread cached a value
+    // meanwhile, which is returned instead.
+    template <std::invocable F>
+        requires std::convertible_to<std::invoke_result_t<F>, V>
+    auto
+    get_or_insert(K const & key, F&& make) -> shared_ptr<V const>
+    {
+        if (auto value = find(key)) return value;
+        return store(key, std::invoke(std::forward<F>(make)), false);
+    }
+
+    // caches value unless key is already cached, returns the cached value
+    auto
+    insert(K key, V value) -> shared_ptr<V const>
+    {
+        return store(std::move(key), std::move(value), false);
+    }
+
+    // caches value, replacing the value of key if any, returns value
+    auto
+    insert_or_assign(K key, V value) -> shared_ptr<V const>
+    {
+        return store(std::move(key), std::move(value), true);
+    }
+
+    // returns whether key is removed, readers holding the value keep it
+    auto
+    erase(K const & key) -> bool
+    {
+        auto&            s = shard_of(key);
+        std::scoped_lock lock{s.mutex};
+        return erase_locked(s, key);
+    }
+
+    // might be outdated once it returns
+    [[nodiscard]] auto
+    size() const noexcept -> std::size_t
+    {
+        return m_map.size();
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+    // total weight of the cached entries, might be outdated once it returns
+    [[nodiscard]] auto
+    weight() const noexcept -> std::size_t
+    {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i <= m_shard_mask; ++i)
+        {
+            result += m_shards[i].bytes.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    [[nodiscard]] auto
+    capacity() const noexcept -> std::size_t
+    {
+        return m_shard_capacity * (m_shard_mask + 1);
+    }
+
+private:
+    std::size_t              m_shard_mask;
+    std::size_t              m_shard_capacity;
+    std::unique_ptr<shard[]> m_shards;
+
+    // owns the entries, they are destroyed once no reader protects them
+    concurrent_hash_map<K, std::unique_ptr<entry>, Hash, KeyEqual> m_map;
+
+    [[no_unique_address]] Hash    m_hash;
+    [[no_unique_address]] Weigher m_weigher;
+
+    static auto
+    touch(entry& e) noexcept -> shared_ptr<V const>
+    {
+        if (!e.referenced.load(std::memory_order_relaxed))
+        {
+            e.referenced.store(true, std::memory_order_relaxed);
+        }
+        return e.value;
+    }
+
+    // The map mixes the low bits of the hash for its buckets, shards are
+    // picked by the high bits.
+    auto
+    shard_of(K const & key) -> shard&
+    {
+        std::uint64_t h = m_hash(key);
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15;
+        return m_shards[static_cast<std::size_t>(h >> 40) & m_shard_mask];
+    }
+
+    auto
+    store(K key, V value, bool assign) -> shared_ptr<V const>
+    {
+        auto const bytes = m_weigher(std::as_const(key), std::as_const(value));
+        shared_ptr<V const> ptr = make_shared<V>(std::move(value));
+
+        auto&            s = shard_of(key);
+        std::scoped_lock lock{s.mutex};
+        if (assign) { erase_locked(s, key); }
+        else
+        {
+            shared_ptr<V const> cached;
+            m_map.visit(
+                key,
+                [&](std::unique_ptr<entry> const & e) { cached = touch(*e); }
+            );
+            if (cached) return cached;
+        }
+        if (bytes > m_shard_capacity) return ptr;
+
+        evict_locked(s, bytes);
+        auto e = std::make_unique<entry>(key, ptr, bytes, s.ring.size());
+        s.ring.push_back(e.get());
+        try
+        {
+            m_map.emplace(std::move(key), std::move(e));
+        }
+        catch (...)
+        {
+            s.ring.pop_back();
+            throw;
+        }
+        s.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    // sweeps the clock hand until bytes more fit into the shard
+    void
+    evict_locked(shard& s, std::size_t bytes)
+    {
+        while (!s.ring.empty()
+               && s.bytes.load(std::memory_order_relaxed) + bytes
+                      > m_shard_capacity)
+        {
+            if (s.hand >= s.ring.size()) s.hand = 0;
+            auto const e = s.ring[s.hand];
+            if (e->referenced.load(std::memory_order_relaxed))
+            {
+                e->referenced.store(false, std::memory_order_relaxed);
+                ++s.hand;
+                continue;
+            }
+            // The entry may be reclaimed during the erase, which must not
+            // read its key anymore.
+            K const key = e->key;
+            remove_from_ring(s, *e);
+            m_map.erase(key);
+        }
+    }
+
+    auto
+    erase_locked(shard& s, K const & key) -> bool
+    {
+        entry* found = nullptr;
+        m_map.visit(
+            key, [&](std::unique_ptr<entry> const & e) { found = e.get(); }
+        );
+        if (found == nullptr) return false;
+        remove_from_ring(s, *found);
+        m_map.erase(key);
+        return true;
+    }
+
+    // the last entry of the ring takes the place of e, the hand stays put
+    static void
+    remove_from_ring(shard& s, entry& e) noexcept
+    {
+        auto const last = s.ring.back();
+        last->index     = e.index;
+        s.ring[e.index] = last;
+        s.ring.pop_back();
+        s.bytes.fetch_sub(e.bytes, std::memory_order_relaxed);
+    }
+};
+
+} // namespace tinystd
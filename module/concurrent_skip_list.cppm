@@ -0,0 +1,536 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:concurrent_skip_list;
+
+import std;
+import :size_class_cache;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Lock-free ordered map (Fraser's skip list with Michael's hazard pointer
+// traversal).
+// - A node is a tower: the key, the value and one link per level. The low bit
+//   of a link marks the node as removed at that level. erase marks the links
+//   top-down, the thread that marks the bottom link removes the node.
+// - Every traversal, including find, unlinks the marked nodes it passes. It
+//   moves hand-over-hand with two hazard pointers: the successor is protected
+//   and then validated by checking that the link of the predecessor still
+//   points to it unmarked, so it cannot be retired yet.
+// - Inserts link the bottom level first, then search again for the
+//   predecessor of every upper level. A node is retired only after both its
+//   inserter (which may link upper levels late) and its remover have made
+//   sure that it is unlinked from every level.
+// - Towers are allocated from size_class_cache in whole cache lines.
+export template <typename K, typename V, typename Compare = std::less<K>>
+class concurrent_skip_list
+{
+    // node pointer with the removal mark in the low bit
+    using link = std::atomic<std::uintptr_t>;
+
+    // allocated with its links right after it
+    struct alignas(link) node
+    {
+        K key;
+        V value;
+        // the inserter and the remover, the last one retires the node
+        std::atomic<std::uint32_t> owners{2};
+        std::uint32_t              height;
+
+        template <typename... Args>
+        node(std::uint32_t h, K k, Args&&... args)
+            : key(std::move(k))
+            , value(std::forward<Args>(args)...)
+            , height{h}
+        {
+        }
+
+        auto
+        links() noexcept -> link*
+        {
+            return reinterpret_cast<link*>(this + 1);
+        }
+    };
+
+public:
+    using key_type    = K;
+    using mapped_type = V;
+
+    concurrent_skip_list() = default;
+
+    // no copy/move semantics
+    concurrent_skip_list(concurrent_skip_list const &) = delete;
+    auto
+    operator=(concurrent_skip_list const &) = delete;
+
+    // No other thread may access the list. Nodes that are still linked are
+    // freed directly, removed ones are already retired.
+    ~concurrent_skip_list() noexcept
+    {
+        auto n = pointer(m_head[0].load(std::memory_order_relaxed));
+        while (n)
+        {
+            auto const next =
+                pointer(n->links()[0].load(std::memory_order_relaxed));
+            free_node(n);
+            n = next;
+        }
+    }
+
+    // returns whether the key is inserted, an existing value is kept
+    template <typename... Args>
+    auto
+    emplace(K key, Args&&... args) -> bool
+    {
+        auto       hp_pred = make_hazard_pointer<node>(0);
+        auto       hp_succ = make_hazard_pointer<node>(1);
+        auto const n       = allocate_node(
+            random_height(), std::move(key), std::forward<Args>(args)...
+        );
+
+        while (true)
+        {
+            auto [pred, succ] = search(n->key, 0, false, hp_pred, hp_succ);
+            if (succ && !m_less(n->key, succ->key))
+            {
+                free_node(n);
+                return false;
+            }
+            n->links()[0].store(word(succ), std::memory_order_relaxed);
+            auto expected = word(succ);
+            if (pred[0].compare_exchange_strong(
+                    expected,
+                    word(n),
+                    std::memory_order_release,
+                    std::memory_order_relaxed
+                ))
+            {
+                break;
+            }
+        }
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        // n is not retired before it is released below
+        for (std::uint32_t i = 1; i < n->height; ++i)
+        {
+            if (!link_level(n, i, hp_pred, hp_succ)) break;
+        }
+        // A remover may have unlinked n before its upper levels were linked.
+        // Pairs with the fence in erase: either we see the mark, or the
+        // remover's search sees the levels linked above.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (is_marked(n->links()[0].load(std::memory_order_acquire)))
+        {
+            unlink(n->key, hp_pred, hp_succ);
+        }
+        release(n);
+        return true;
+    }
+
+    auto
+    insert(K key, V value) -> bool
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    // returns whether the key is erased
+    auto
+    erase(K const & key) -> bool
+    {
+        auto hp_pred = make_hazard_pointer<node>(0);
+        auto hp_succ = make_hazard_pointer<node>(1);
+        auto n       = search(key, 0, false, hp_pred, hp_succ).succ;
+        if (n == nullptr || m_less(key, n->key)) return false;
+
+        // n is protected by hp_succ until the bottom link is marked, then it
+        // is not retired before it is released below
+        for (auto i = n->height; i-- > 1;)
+        {
+            n->links()[i].fetch_or(mark, std::memory_order_release);
+        }
+        if (is_marked(n->links()[0].fetch_or(mark, std::memory_order_acq_rel)))
+        {
+            // removed by another thread
+            return false;
+        }
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        // pairs with the fence in emplace, after its upper levels are linked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        unlink(key, hp_pred, hp_succ);
+        release(n);
+        return true;
+    }
+
+    [[nodiscard]] auto
+    find(K const & key) const -> std::optional<V>
+    {
+        auto hp_pred = make_hazard_pointer<node>(0);
+        auto hp_succ = make_hazard_pointer<node>(1);
+        auto n       = search(key, 0, false, hp_pred, hp_succ).succ;
+        if (n == nullptr || m_less(key, n->key)) return std::nullopt;
+        return n->value;
+    }
+
+    [[nodiscard]] auto
+    contains(K const & key) const -> bool
+    {
+        auto hp_pred = make_hazard_pointer<node>(0);
+        auto hp_succ = make_hazard_pointer<node>(1);
+        auto n       = search(key, 0, false, hp_pred, hp_succ).succ;
+        return n != nullptr && !m_less(key, n->key);
+    }
+
+    // the first entry whose key is not less than key
+    [[nodiscard]] auto
+    lower_bound(K const & key) const -> std::optional<std::pair<K, V>>
+    {
+        auto hp_pred = make_hazard_pointer<node>(0);
+        auto hp_succ = make_hazard_pointer<node>(1);
+        auto n       = search(key, 0, false, hp_pred, hp_succ).succ;
+        if (n == nullptr) return std::nullopt;
+        return std::pair<K, V>{n->key, n->value};
+    }
+
+    // Calls fn(key, value) for every entry in key order. Weakly consistent:
+    // an entry present during the whole call is visited exactly once, one
+    // inserted or erased meanwhile may or may not be. fn must not access a
+    // concurrent_skip_list of the same type.
+    template <std::invocable<K const &, V const &> F>
+    void
+    for_each(F&& fn) const
+    {
+        scan(nullptr, nullptr, fn);
+    }
+
+    // same as for_each, restricted to the keys in [first, last)
+    template <std::invocable<K const &, V const &> F>
+    void
+    for_each(K const & first, K const & last, F&& fn) const
+    {
+        scan(&first, &last, fn);
+    }
+
+    // might be outdated once it returns
+    [[nodiscard]] auto
+    size() const noexcept -> std::size_t
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+private:
+    // a node of height h + 1 is 4 times less likely than one of height h
+    constexpr static std::uint32_t  max_height = 16;
+    constexpr static std::uintptr_t mark       = 1;
+
+    constexpr static std::size_t cache_line =
+        std::hardware_destructive_interference_size;
+
+    constexpr static bool cacheable_alignment =
+        alignof(node) <= size_class_cache::granularity;
+
+    struct position
+    {
+        link* pred; // links of the predecessor or of the head
+        node* succ;
+    };
+
+    // Readers unlink removed nodes too, hence mutable. The links of nodes
+    // are modified through pointers anyway.
+    alignas(cache_line) mutable std::array<link, max_height> m_head{};
+
+    alignas(cache_line) std::atomic<std::size_t> m_size{0};
+
+    [[no_unique_address]] Compare m_less;
+
+    [[nodiscard]] static auto
+    pointer(std::uintptr_t w) noexcept -> node*
+    {
+        return reinterpret_cast<node*>(w & ~mark);
+    }
+
+    [[nodiscard]] static auto
+    word(node* n) noexcept -> std::uintptr_t
+    {
+        return reinterpret_cast<std::uintptr_t>(n);
+    }
+
+    [[nodiscard]] static auto
+    is_marked(std::uintptr_t w) noexcept -> bool
+    {
+        return (w & mark) != 0;
+    }
+
+    static auto
+    random_height() noexcept -> std::uint32_t
+    {
+        thread_local std::uint64_t state =
+            std::hash<std::thread::id>{}(std::this_thread::get_id())
+            | 1; // xorshift state must not be 0
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        // two random bits per level, capped at max_height
+        auto const bits = state | (std::uint64_t{1} << (2 * (max_height - 1)));
+        return 1 + static_cast<std::uint32_t>(std::countr_zero(bits)) / 2;
+    }
+
+    // whole cache lines, so that towers of close heights share a size class
+    static auto
+    node_bytes(std::uint32_t height) noexcept -> std::size_t
+    {
+        auto const bytes = sizeof(node) + height * sizeof(link);
+        return (bytes + cache_line - 1) / cache_line * cache_line;
+    }
+
+    static auto
+    is_cached(std::size_t bytes) noexcept -> bool
+    {
+        return cacheable_alignment && bytes <= size_class_cache::max_size;
+    }
+
+    template <typename... Args>
+    static auto
+    allocate_node(std::uint32_t height, Args&&... args) -> node*
+    {
+        auto const bytes = node_bytes(height);
+        auto const ptr =
+            is_cached(bytes)
+                ? size_class_cache::allocate(bytes)
+                : ::operator new(bytes, std::align_val_t{alignof(node)});
+        node* n;
+        try
+        {
+            n = std::construct_at(
+                static_cast<node*>(ptr), height, std::forward<Args>(args)...
+            );
+        }
+        catch (...)
+        {
+            deallocate_node(ptr, bytes);
+            throw;
+        }
+        for (std::uint32_t i = 0; i < height; ++i)
+        {
+            std::construct_at(n->links() + i, 0);
+        }
+        return n;
+    }
+
+    static void
+    deallocate_node(void* ptr, std::size_t bytes) noexcept
+    {
+        if (is_cached(bytes)) { size_class_cache::deallocate(ptr, bytes); }
+        else
+        {
+            ::operator delete(ptr, bytes, std::align_val_t{alignof(node)});
+        }
+    }
+
+    static void
+    free_node(node* n) noexcept
+    {
+        auto const bytes = node_bytes(n->height);
+        std::destroy_at(n);
+        deallocate_node(n, bytes);
+    }
+
+    // called by the inserter and the remover of n once n is unlinked as far
+    // as they are concerned
+    static void
+    release(node* n)
+    {
+        if (n->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            hazard_pointer<node>::retire(n, &free_node);
+        }
+    }
+
+    // Protects n, read from src, and returns whether src still points to n
+    // unmarked after the protection is visible. If so, n is reachable and
+    // not retired yet.
+    static auto
+    protect(hazard_pointer<node>& hp, node* n, link const & src) noexcept
+        -> bool
+    {
+        hp.reset_protection(n);
+        // see hazard_pointer::try_protect
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return src.load(std::memory_order_acquire) == word(n);
+    }
+
+    // Searches from the top level down to level for the last node whose key
+    // is less than key (not greater with pass_equal) and unlinks the marked
+    // nodes on the way. The predecessor is protected by hp_pred and the
+    // successor by hp_succ.
+    auto
+    search(
+        K const &             key,
+        std::uint32_t         level,
+        bool                  pass_equal,
+        hazard_pointer<node>& hp_pred,
+        hazard_pointer<node>& hp_succ
+    ) const -> position
+    {
+        while (true)
+        {
+            if (auto const pos =
+                    try_search(key, level, pass_equal, hp_pred, hp_succ))
+            {
+                return *pos;
+            }
+        }
+    }
+
+    // returns nullopt if a concurrent update invalidates the traversal
+    auto
+    try_search(
+        K const &             key,
+        std::uint32_t         level,
+        bool                  pass_equal,
+        hazard_pointer<node>& hp_pred,
+        hazard_pointer<node>& hp_succ
+    ) const -> std::optional<position>
+    {
+        link* pred = m_head.data();
+        for (auto i = max_height; i-- > level;)
+        {
+            auto curr = pointer(pred[i].load(std::memory_order_acquire));
+            while (curr)
+            {
+                if (!protect(hp_succ, curr, pred[i])) return std::nullopt;
+                auto const next =
+                    curr->links()[i].load(std::memory_order_acquire);
+                if (is_marked(next))
+                {
+                    auto expected = word(curr);
+                    if (!pred[i].compare_exchange_strong(
+                            expected,
+                            next & ~mark,
+                            std::memory_order_release,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        return std::nullopt;
+                    }
+                    curr = pointer(next);
+                    continue;
+                }
+                if (m_less(key, curr->key)
+                    || (!pass_equal && !m_less(curr->key, key)))
+                {
+                    break;
+                }
+                pred = curr->links();
+                hp_pred.swap(hp_succ);
+                curr = pointer(next);
+            }
+            if (i == level) return position{pred, curr};
+        }
+        std::unreachable();
+    }
+
+    // Links n at level i unless it is being removed, returns whether it is
+    // linked.
+    auto
+    link_level(
+        node*                 n,
+        std::uint32_t         i,
+        hazard_pointer<node>& hp_pred,
+        hazard_pointer<node>& hp_succ
+    ) -> bool
+    {
+        while (true)
+        {
+            auto [pred, succ] = search(n->key, i, false, hp_pred, hp_succ);
+            auto current      = n->links()[i].load(std::memory_order_relaxed);
+            // a remover marks the links of n before they are linked
+            if (is_marked(current)
+                || !n->links()[i].compare_exchange_strong(
+                    current,
+                    word(succ),
+                    std::memory_order_relaxed,
+                    std::memory_order_relaxed
+                ))
+            {
+                return false;
+            }
+            auto expected = word(succ);
+            if (pred[i].compare_exchange_strong(
+                    expected,
+                    word(n),
+                    std::memory_order_release,
+                    std::memory_order_relaxed
+                ))
+            {
+                return true;
+            }
+        }
+    }
+
+    // Unlinks the marked nodes of key from every level. Nodes with an equal
+    // key are passed too, a removed node may still follow a live one.
+    void
+    unlink(
+        K const &             key,
+        hazard_pointer<node>& hp_pred,
+        hazard_pointer<node>& hp_succ
+    ) const
+    {
+        search(key, 0, true, hp_pred, hp_succ);
+    }
+
+    template <typename F>
+    void
+    scan(K const * first, K const * last, F& fn) const
+    {
+        auto  hp_next = make_hazard_pointer<node>(0);
+        auto  hp_curr = make_hazard_pointer<node>(1);
+        node* curr    = nullptr;
+        if (first) { curr = search(*first, 0, false, hp_next, hp_curr).succ; }
+        else
+        {
+            do {
+                curr = pointer(m_head[0].load(std::memory_order_acquire));
+            } while (curr && !protect(hp_curr, curr, m_head[0]));
+        }
+
+        // curr is protected by hp_curr
+        while (curr && (last == nullptr || m_less(curr->key, *last)))
+        {
+            auto const next = curr->links()[0].load(std::memory_order_acquire);
+            if (is_marked(next))
+            {
+                // unlink curr and go on from its key
+                K const key = curr->key;
+                curr        = search(key, 0, false, hp_next, hp_curr).succ;
+                continue;
+            }
+
+            std::invoke(
+                fn, std::as_const(curr->key), std::as_const(curr->value)
+            );
+
+            auto const succ = pointer(next);
+            if (succ && !protect(hp_next, succ, curr->links()[0]))
+            {
+                // curr is removed or a node is inserted after it meanwhile,
+                // go on after its key
+                K const key = curr->key;
+                curr        = search(key, 0, true, hp_next, hp_curr).succ;
+                continue;
+            }
+            hp_next.swap(hp_curr);
+            curr = succ;
+        }
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,538 @@
+module;
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+export module tinystd:dynamic_bitset;
+
+import std;
+import :cpu_features;
+import :span;
+import :vector;
+import :inplace_vector;
+
+namespace tinystd
+{
+
+enum class bit_op
+{
+    and_,
+    or_,
+    xor_,
+    and_not
+};
+
+// Word kernels of dynamic_bitset: AVX2 versions when the CPU has it, scalar
+// ones otherwise. The scalar loops are simple enough for the compiler to
+// vectorize for the baseline ISA.
+class bitset_kernels
+{
+public:
+    template <bit_op Op>
+    static void
+    combine(std::uint64_t* dst, std::uint64_t const * src, std::size_t n)
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx2()) return combine_avx2<Op>(dst, src, n);
+#endif
+        for (std::size_t i = 0; i < n; ++i) dst[i] = apply<Op>(dst[i], src[i]);
+    }
+
+    [[nodiscard]] static auto
+    popcount(std::uint64_t const * words, std::size_t n) -> std::size_t
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx2()) return popcount_avx2(words, n);
+#endif
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) count += std::popcount(words[i]);
+        return count;
+    }
+
+    // index of the first non-zero word at or after `first`, `n` if none
+    [[nodiscard]] static auto
+    first_nonzero(std::uint64_t const * words, std::size_t first, std::size_t n)
+        -> std::size_t
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx2()) return first_nonzero_avx2(words, first, n);
+#endif
+        while (first < n && words[first] == 0) ++first;
+        return first;
+    }
+
+private:
+    template <bit_op Op>
+    [[nodiscard]] static constexpr auto
+    apply(std::uint64_t lhs, std::uint64_t rhs) noexcept -> std::uint64_t
+    {
+        if constexpr (Op == bit_op::and_) { return lhs & rhs; }
+        else if constexpr (Op == bit_op::or_) { return lhs | rhs; }
+        else if constexpr (Op == bit_op::xor_) { return lhs ^ rhs; }
+        else { return lhs & ~rhs; }
+    }
+
+#if defined(__x86_64__)
+    [[nodiscard, gnu::target("avx2")]] static auto
+    load(std::uint64_t const * p) noexcept -> __m256i
+    {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+    }
+
+    template <bit_op Op>
+    [[gnu::target("avx2")]] static void
+    combine_avx2(std::uint64_t* dst, std::uint64_t const * src, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i const lhs = load(dst + i);
+            __m256i const rhs = load(src + i);
+            __m256i       result;
+            if constexpr (Op == bit_op::and_)
+            {
+                result = _mm256_and_si256(lhs, rhs);
+            }
+            else if constexpr (Op == bit_op::or_)
+            {
+                result = _mm256_or_si256(lhs, rhs);
+            }
+            else if constexpr (Op == bit_op::xor_)
+            {
+                result = _mm256_xor_si256(lhs, rhs);
+            }
+            else { result = _mm256_andnot_si256(rhs, lhs); }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+        }
+        for (; i < n; ++i) dst[i] = apply<Op>(dst[i], src[i]);
+    }
+
+    // nibble lookup with vpshufb, bytes summed with vpsadbw (Mula et al.)
+    [[nodiscard, gnu::target("avx2")]] static auto
+    popcount_avx2(std::uint64_t const * words, std::size_t n) -> std::size_t
+    {
+        __m256i const lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+        );
+        __m256i const low_nibble = _mm256_set1_epi8(0x0f);
+        __m256i       total      = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i const v  = load(words + i);
+            __m256i const lo = _mm256_and_si256(v, low_nibble);
+            __m256i const hi =
+                _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble);
+            __m256i const per_byte = _mm256_add_epi8(
+                _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi)
+            );
+            total = _mm256_add_epi64(
+                total, _mm256_sad_epu8(per_byte, _mm256_setzero_si256())
+            );
+        }
+
+        std::size_t count = _mm256_extract_epi64(total, 0)
+                          + _mm256_extract_epi64(total, 1)
+                          + _mm256_extract_epi64(total, 2)
+                          + _mm256_extract_epi64(total, 3);
+        for (; i < n; ++i) count += std::popcount(words[i]);
+        return count;
+    }
+
+    [[nodiscard, gnu::target("avx2")]] static auto
+    first_nonzero_avx2(
+        std::uint64_t const * words, std::size_t first, std::size_t n
+    ) -> std::size_t
+    {
+        // skip 4 zero words per test
+        for (; first + 4 <= n; first += 4)
+        {
+            __m256i const v = load(words + first);
+            if (!_mm256_testz_si256(v, v)) break;
+        }
+        while (first < n && words[first] == 0) ++first;
+        return first;
+    }
+#endif
+};
+
+// Bitset with a run-time size, packed into 64-bit words stored in `Words`.
+// - Bits past size() in the last word are kept zero, so count() and the
+//   find functions need no masking.
+// - Bitwise operations, count and find work a word at a time, with AVX2 when
+//   the CPU has it.
+// - Binary operations require both bitsets to have the same size.
+export template <typename Words>
+class basic_dynamic_bitset
+{
+    using word_t = std::uint64_t;
+
+    static constexpr std::size_t word_bits = 64;
+
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    // forward iterator over the indices of the set bits
+    class set_bit_iterator
+    {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type       = size_type;
+        using difference_type  = std::ptrdiff_t;
+
+        set_bit_iterator() noexcept = default;
+
+        set_bit_iterator(word_t const * words, size_type word_count) noexcept
+            : m_words{words}
+            , m_word_count{word_count}
+        {
+            skip_to_word(0);
+        }
+
+        [[nodiscard]] auto
+        operator*() const noexcept -> size_type
+        {
+            return m_index * word_bits + std::countr_zero(m_current);
+        }
+
+        auto
+        operator++() noexcept -> set_bit_iterator&
+        {
+            // clear the lowest set bit
+            m_current &= m_current - 1;
+            if (m_current == 0) skip_to_word(m_index + 1);
+            return *this;
+        }
+
+        auto
+        operator++(int) noexcept -> set_bit_iterator
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] friend auto
+        operator==(
+            set_bit_iterator const & lhs, set_bit_iterator const & rhs
+        ) noexcept -> bool
+        {
+            return lhs.m_index == rhs.m_index && lhs.m_current == rhs.m_current;
+        }
+
+        [[nodiscard]] friend auto
+        operator==(
+            set_bit_iterator const & it, std::default_sentinel_t
+        ) noexcept -> bool
+        {
+            return it.m_index == it.m_word_count;
+        }
+
+    private:
+        word_t const * m_words      = nullptr;
+        size_type      m_word_count = 0;
+        size_type      m_index      = 0;
+        word_t         m_current    = 0;
+
+        void
+        skip_to_word(size_type first) noexcept
+        {
+            m_index =
+                bitset_kernels::first_nonzero(m_words, first, m_word_count);
+            m_current = m_index == m_word_count ? 0 : m_words[m_index];
+        }
+    };
+
+    // constructors
+    basic_dynamic_bitset() = default;
+
+    explicit basic_dynamic_bitset(size_type count, bool value = false)
+    {
+        resize(count, value);
+    }
+
+    // access and observers
+    [[nodiscard]] auto
+    size() const noexcept -> size_type
+    {
+        return m_sz;
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return m_sz == 0;
+    }
+
+    [[nodiscard]] auto
+    test(size_type i) const noexcept -> bool
+    {
+        return (m_words[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    [[nodiscard]] auto
+    operator[](size_type i) const noexcept -> bool
+    {
+        return test(i);
+    }
+
+    // the packed words, bits past size() are zero
+    [[nodiscard]] auto
+    words() const noexcept -> span<word_t const>
+    {
+        return {m_words.data(), m_words.size()};
+    }
+
+    [[nodiscard]] auto
+    count() const -> size_type
+    {
+        return bitset_kernels::popcount(m_words.data(), m_words.size());
+    }
+
+    [[nodiscard]] auto
+    any() const -> bool
+    {
+        return find_first() != npos;
+    }
+
+    [[nodiscard]] auto
+    none() const -> bool
+    {
+        return !any();
+    }
+
+    [[nodiscard]] auto
+    all() const -> bool
+    {
+        return count() == m_sz;
+    }
+
+    // index of the first set bit, npos if none
+    [[nodiscard]] auto
+    find_first() const -> size_type
+    {
+        return find_from_word(0);
+    }
+
+    // index of the first set bit after `pos`, npos if none
+    [[nodiscard]] auto
+    find_next(size_type pos) const -> size_type
+    {
+        if (m_sz == 0 || pos >= m_sz - 1) return npos;
+        ++pos;
+        size_type const index = pos / word_bits;
+        word_t const    word =
+            m_words[index] & (~word_t{0} << pos % word_bits);
+        if (word != 0) return index * word_bits + std::countr_zero(word);
+        return find_from_word(index + 1);
+    }
+
+    // the indices of the set bits, in increasing order
+    [[nodiscard]] auto
+    set_bits() const noexcept
+    {
+        return std::ranges::subrange(
+            set_bit_iterator{m_words.data(), m_words.size()},
+            std::default_sentinel
+        );
+    }
+
+    [[nodiscard]] friend auto
+    operator==(
+        basic_dynamic_bitset const & lhs, basic_dynamic_bitset const & rhs
+    ) noexcept -> bool
+    {
+        return lhs.m_sz == rhs.m_sz
+            && std::ranges::equal(lhs.words(), rhs.words());
+    }
+
+    // modifiers
+    auto
+    set(size_type i, bool value = true) noexcept -> basic_dynamic_bitset&
+    {
+        word_t const bit = word_t{1} << i % word_bits;
+        if (value) { m_words[i / word_bits] |= bit; }
+        else { m_words[i / word_bits] &= ~bit; }
+        return *this;
+    }
+
+    auto
+    reset(size_type i) noexcept -> basic_dynamic_bitset&
+    {
+        return set(i, false);
+    }
+
+    auto
+    flip(size_type i) noexcept -> basic_dynamic_bitset&
+    {
+        m_words[i / word_bits] ^= word_t{1} << i % word_bits;
+        return *this;
+    }
+
+    auto
+    set() noexcept -> basic_dynamic_bitset&
+    {
+        std::ranges::fill(m_words, ~word_t{0});
+        clear_unused_bits();
+        return *this;
+    }
+
+    auto
+    reset() noexcept -> basic_dynamic_bitset&
+    {
+        std::ranges::fill(m_words, word_t{0});
+        return *this;
+    }
+
+    auto
+    flip() noexcept -> basic_dynamic_bitset&
+    {
+        for (word_t& word : m_words) word = ~word;
+        clear_unused_bits();
+        return *this;
+    }
+
+    auto
+    operator&=(basic_dynamic_bitset const & rhs) -> basic_dynamic_bitset&
+    {
+        return combine<bit_op::and_>(rhs);
+    }
+
+    auto
+    operator|=(basic_dynamic_bitset const & rhs) -> basic_dynamic_bitset&
+    {
+        return combine<bit_op::or_>(rhs);
+    }
+
+    auto
+    operator^=(basic_dynamic_bitset const & rhs) -> basic_dynamic_bitset&
+    {
+        return combine<bit_op::xor_>(rhs);
+    }
+
+    // clears the bits that are set in `rhs`, *this & ~rhs
+    auto
+    and_not(basic_dynamic_bitset const & rhs) -> basic_dynamic_bitset&
+    {
+        return combine<bit_op::and_not>(rhs);
+    }
+
+    [[nodiscard]] friend auto
+    operator&(basic_dynamic_bitset lhs, basic_dynamic_bitset const & rhs)
+        -> basic_dynamic_bitset
+    {
+        return lhs &= rhs;
+    }
+
+    [[nodiscard]] friend auto
+    operator|(basic_dynamic_bitset lhs, basic_dynamic_bitset const & rhs)
+        -> basic_dynamic_bitset
+    {
+        return lhs |= rhs;
+    }
+
+    [[nodiscard]] friend auto
+    operator^(basic_dynamic_bitset lhs, basic_dynamic_bitset const & rhs)
+        -> basic_dynamic_bitset
+    {
+        return lhs ^= rhs;
+    }
+
+    void
+    push_back(bool value)
+    {
+        if (m_sz % word_bits == 0) m_words.push_back(0);
+        ++m_sz;
+        set(m_sz - 1, value);
+    }
+
+    void
+    resize(size_type count, bool value = false)
+    {
+        size_type const old_size = m_sz;
+        m_words.resize(words_for(count), value ? ~word_t{0} : word_t{0});
+        if (value && count > old_size && old_size % word_bits != 0)
+        {
+            // the rest of the old last word
+            m_words[old_size / word_bits] |= ~word_t{0} << old_size % word_bits;
+        }
+        m_sz = count;
+        clear_unused_bits();
+    }
+
+    void
+    clear() noexcept
+    {
+        m_words.clear();
+        m_sz = 0;
+    }
+
+    void
+    swap(basic_dynamic_bitset& other) noexcept
+    {
+        m_words.swap(other.m_words);
+        std::swap(m_sz, other.m_sz);
+    }
+
+private:
+    Words     m_words;
+    size_type m_sz = 0;
+
+    [[nodiscard]] static constexpr auto
+    words_for(size_type bits) noexcept -> size_type
+    {
+        return (bits + word_bits - 1) / word_bits;
+    }
+
+    template <bit_op Op>
+    auto
+    combine(basic_dynamic_bitset const & rhs) -> basic_dynamic_bitset&
+    {
+        bitset_kernels::combine<Op>(
+            m_words.data(), rhs.m_words.data(), m_words.size()
+        );
+        return *this;
+    }
+
+    [[nodiscard]] auto
+    find_from_word(size_type first) const -> size_type
+    {
+        size_type const word_count = m_words.size();
+        size_type const index =
+            bitset_kernels::first_nonzero(m_words.data(), first, word_count);
+        if (index == word_count) return npos;
+        return index * word_bits + std::countr_zero(m_words[index]);
+    }
+
+    void
+    clear_unused_bits() noexcept
+    {
+        if (m_sz % word_bits != 0)
+        {
+            m_words[m_sz / word_bits] &= ~(~word_t{0} << m_sz % word_bits);
+        }
+    }
+};
+
+export template <typename Words>
+void
+swap(basic_dynamic_bitset<Words>& lhs, basic_dynamic_bitset<Words>& rhs)
+    noexcept
+{
+    lhs.swap(rhs);
+}
+
+export using dynamic_bitset = basic_dynamic_bitset<vector<std::uint64_t>>;
+
+// storage for `MaxBits` bits, rounded up to whole words, inside the object.
+// push_back and resize past it throw `std::bad_alloc` from the inplace_vector
+// of words and leave the bitset unchanged.
+export template <std::size_t MaxBits>
+using inplace_dynamic_bitset = basic_dynamic_bitset<
+    inplace_vector<std::uint64_t, (MaxBits + 63) / 64>>;
+
+} // namespace tinystd
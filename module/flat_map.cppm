@@ -0,0 +1,744 @@
+export module tinystd:flat_map;
+
+import std;
+import :vector;
+
+namespace tinystd
+{
+
+export struct sorted_unique_t
+{
+    explicit sorted_unique_t() = default;
+};
+
+// tag for inserts and constructors whose input is sorted and has no
+// duplicate keys, so it is merged without sorting it first
+export inline constexpr sorted_unique_t sorted_unique{};
+
+// heterogeneous lookup, as for the std associative containers
+template <typename Compare>
+concept transparent = requires { typename Compare::is_transparent; };
+
+// lower_bound over a sorted array without a data-dependent branch: every
+// step halves the range with a conditional move, so there is nothing to
+// mispredict; the loop runs ceil(log2(n)) times for every key
+template <typename Key, typename K, typename Compare>
+[[nodiscard]] auto
+branchless_lower_bound(
+    Key const * first, std::size_t n, K const & key, Compare const & comp
+) -> Key const *
+{
+    if (n == 0) return first;
+    while (n > 1)
+    {
+        std::size_t const half = n / 2;
+        // both halves of the next step, to hide the cache miss of big arrays
+        __builtin_prefetch(first + half / 2);
+        __builtin_prefetch(first + half + half / 2);
+        first  = comp(first[half], key) ? first + half : first;
+        n     -= half;
+    }
+    return first + comp(*first, key);
+}
+
+// Sorted associative container in two sorted parallel arrays, keys and
+// mapped values, as C++23 `std::flat_map`.
+// - A lookup is a branchless binary search over the keys alone, the values
+//   are only touched on a hit.
+// - Inserting one element shifts the tail of both containers, bulk inserts
+//   append, sort the new elements and merge once.
+// - If an insert or erase throws, the map is cleared, as for `std::flat_map`.
+export template <
+    typename Key,
+    typename T,
+    typename Compare         = std::less<Key>,
+    typename KeyContainer    = vector<Key>,
+    typename MappedContainer = vector<T>>
+    requires std::ranges::contiguous_range<KeyContainer>
+          && std::ranges::contiguous_range<MappedContainer>
+class flat_map
+{
+    // random access iterator over both containers, dereferences to a pair
+    // of references
+    template <bool Const>
+    class pair_iterator
+    {
+        using mapped_t = std::conditional_t<Const, T const, T>;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::pair<Key, T>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::pair<Key const &, mapped_t&>;
+
+        // `it->second` on a proxy reference
+        struct pointer
+        {
+            reference ref;
+
+            auto
+            operator->() noexcept -> reference*
+            {
+                return &ref;
+            }
+        };
+
+        pair_iterator() noexcept = default;
+
+        pair_iterator(Key const * key, mapped_t* value) noexcept
+            : m_key{key}
+            , m_value{value}
+        {
+        }
+
+        // iterator to const_iterator
+        pair_iterator(pair_iterator<!Const> const & other) noexcept
+            requires Const
+            : m_key{other.m_key}
+            , m_value{other.m_value}
+        {
+        }
+
+        [[nodiscard]] auto
+        operator*() const noexcept -> reference
+        {
+            return {*m_key, *m_value};
+        }
+
+        [[nodiscard]] auto
+        operator->() const noexcept -> pointer
+        {
+            return {**this};
+        }
+
+        [[nodiscard]] auto
+        operator[](difference_type n) const noexcept -> reference
+        {
+            return {m_key[n], m_value[n]};
+        }
+
+        auto
+        operator++() noexcept -> pair_iterator&
+        {
+            ++m_key;
+            ++m_value;
+            return *this;
+        }
+
+        auto
+        operator++(int) noexcept -> pair_iterator
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto
+        operator--() noexcept -> pair_iterator&
+        {
+            --m_key;
+            --m_value;
+            return *this;
+        }
+
+        auto
+        operator--(int) noexcept -> pair_iterator
+        {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        auto
+        operator+=(difference_type n) noexcept -> pair_iterator&
+        {
+            m_key   += n;
+            m_value += n;
+            return *this;
+        }
+
+        auto
+        operator-=(difference_type n) noexcept -> pair_iterator&
+        {
+            return *this += -n;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(pair_iterator it, difference_type n) noexcept -> pair_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(difference_type n, pair_iterator it) noexcept -> pair_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(pair_iterator it, difference_type n) noexcept -> pair_iterator
+        {
+            return it -= n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(pair_iterator const & lhs, pair_iterator const & rhs) noexcept
+            -> difference_type
+        {
+            return lhs.m_key - rhs.m_key;
+        }
+
+        [[nodiscard]] friend auto
+        operator==(
+            pair_iterator const & lhs, pair_iterator const & rhs
+        ) noexcept -> bool
+        {
+            return lhs.m_key == rhs.m_key;
+        }
+
+        [[nodiscard]] friend auto
+        operator<=>(
+            pair_iterator const & lhs, pair_iterator const & rhs
+        ) noexcept
+        {
+            return lhs.m_key <=> rhs.m_key;
+        }
+
+    private:
+        friend class pair_iterator<!Const>;
+
+        Key const * m_key   = nullptr;
+        mapped_t*   m_value = nullptr;
+    };
+
+public:
+    using key_type              = Key;
+    using mapped_type           = T;
+    using value_type            = std::pair<Key, T>;
+    using key_compare           = Compare;
+    using reference             = std::pair<Key const &, T&>;
+    using const_reference       = std::pair<Key const &, T const &>;
+    using size_type             = std::size_t;
+    using key_container_type    = KeyContainer;
+    using mapped_container_type = MappedContainer;
+    using iterator              = pair_iterator<false>;
+    using const_iterator        = pair_iterator<true>;
+
+    struct containers
+    {
+        KeyContainer    keys;
+        MappedContainer values;
+    };
+
+    // constructors
+    flat_map() = default;
+
+    explicit flat_map(Compare const & comp) : m_compare{comp} {}
+
+    // sorts the elements and drops duplicate keys
+    flat_map(
+        KeyContainer    keys,
+        MappedContainer values,
+        Compare const & comp = Compare()
+    )
+        : m_keys{std::move(keys)}
+        , m_values{std::move(values)}
+        , m_compare{comp}
+    {
+        guarded([&] { sort_and_unique(0); });
+    }
+
+    flat_map(
+        sorted_unique_t,
+        KeyContainer    keys,
+        MappedContainer values,
+        Compare const & comp = Compare()
+    )
+        : m_keys{std::move(keys)}
+        , m_values{std::move(values)}
+        , m_compare{comp}
+    {
+    }
+
+    flat_map(
+        std::initializer_list<value_type> list,
+        Compare const &                   comp = Compare()
+    )
+        : m_compare{comp}
+    {
+        insert_range(list);
+    }
+
+    // access and observers
+    [[nodiscard]] auto
+    size() const noexcept -> size_type
+    {
+        return std::ranges::size(m_keys);
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] auto
+    keys() const noexcept -> KeyContainer const &
+    {
+        return m_keys;
+    }
+
+    [[nodiscard]] auto
+    values() const noexcept -> MappedContainer const &
+    {
+        return m_values;
+    }
+
+    [[nodiscard]] auto
+    key_comp() const -> key_compare
+    {
+        return m_compare;
+    }
+
+    [[nodiscard]] auto
+    begin() noexcept -> iterator
+    {
+        return {key_data(), value_data()};
+    }
+
+    [[nodiscard]] auto
+    end() noexcept -> iterator
+    {
+        return begin() + size();
+    }
+
+    [[nodiscard]] auto
+    begin() const noexcept -> const_iterator
+    {
+        return {key_data(), value_data()};
+    }
+
+    [[nodiscard]] auto
+    end() const noexcept -> const_iterator
+    {
+        return begin() + size();
+    }
+
+    [[nodiscard]] auto
+    lower_bound(Key const & key) -> iterator
+    {
+        return begin() + lower_bound_index(key);
+    }
+
+    [[nodiscard]] auto
+    lower_bound(Key const & key) const -> const_iterator
+    {
+        return begin() + lower_bound_index(key);
+    }
+
+    [[nodiscard]] auto
+    find(Key const & key) -> iterator
+    {
+        return begin() + find_index(key);
+    }
+
+    [[nodiscard]] auto
+    find(Key const & key) const -> const_iterator
+    {
+        return begin() + find_index(key);
+    }
+
+    [[nodiscard]] auto
+    contains(Key const & key) const -> bool
+    {
+        return find_index(key) != size();
+    }
+
+    template <typename K>
+        requires transparent<Compare>
+    [[nodiscard]] auto
+    find(K const & key) -> iterator
+    {
+        return begin() + find_index(key);
+    }
+
+    template <typename K>
+        requires transparent<Compare>
+    [[nodiscard]] auto
+    find(K const & key) const -> const_iterator
+    {
+        return begin() + find_index(key);
+    }
+
+    template <typename K>
+        requires transparent<Compare>
+    [[nodiscard]] auto
+    contains(K const & key) const -> bool
+    {
+        return find_index(key) != size();
+    }
+
+    [[nodiscard]] auto
+    count(Key const & key) const -> size_type
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    [[nodiscard]] auto
+    at(Key const & key) -> T&
+    {
+        size_type const i = find_index(key);
+        if (i == size()) throw std::out_of_range("flat_map::at");
+        return value_data()[i];
+    }
+
+    [[nodiscard]] auto
+    at(Key const & key) const -> T const &
+    {
+        size_type const i = find_index(key);
+        if (i == size()) throw std::out_of_range("flat_map::at");
+        return value_data()[i];
+    }
+
+    auto
+    operator[](Key const & key) -> T&
+    {
+        return value_data()[try_emplace(key).first - begin()];
+    }
+
+    auto
+    operator[](Key&& key) -> T&
+    {
+        return value_data()[try_emplace(std::move(key)).first - begin()];
+    }
+
+    [[nodiscard]] friend auto
+    operator==(flat_map const & lhs, flat_map const & rhs) -> bool
+    {
+        return std::ranges::equal(lhs.m_keys, rhs.m_keys)
+            && std::ranges::equal(lhs.m_values, rhs.m_values);
+    }
+
+    // modifiers
+    // inserts `T(args...)` unless the key is present, nothing is
+    // constructed from args if it is
+    template <typename... Args>
+    auto
+    try_emplace(Key const & key, Args&&... args) -> std::pair<iterator, bool>
+    {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    auto
+    try_emplace(Key&& key, Args&&... args) -> std::pair<iterator, bool>
+    {
+        return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    auto
+    insert_or_assign(Key const & key, M&& mapped) -> std::pair<iterator, bool>
+    {
+        auto result = try_emplace(key, std::forward<M>(mapped));
+        if (!result.second)
+        {
+            value_data()[result.first - begin()] = std::forward<M>(mapped);
+        }
+        return result;
+    }
+
+    auto
+    insert(value_type const & value) -> std::pair<iterator, bool>
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    auto
+    insert(value_type&& value) -> std::pair<iterator, bool>
+    {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+    auto
+    emplace(Args&&... args) -> std::pair<iterator, bool>
+    {
+        value_type value(std::forward<Args>(args)...);
+        return insert(std::move(value));
+    }
+
+    // appends the range, sorts the new elements and merges them in once,
+    // O(n + m log m) instead of O(n m) for m single inserts; keys that are
+    // already present keep their value
+    template <std::ranges::input_range R>
+    void
+    insert_range(R&& range)
+    {
+        size_type const old_size = size();
+        guarded(
+            [&]
+            {
+                append(std::forward<R>(range));
+                sort_and_unique(old_size);
+            }
+        );
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void
+    insert(It first, Sentinel last)
+    {
+        insert_range(std::ranges::subrange(first, last));
+    }
+
+    // as insert_range for a sorted range without duplicates, only merges
+    template <std::ranges::input_range R>
+    void
+    insert_range(sorted_unique_t, R&& range)
+    {
+        size_type const old_size = size();
+        guarded(
+            [&]
+            {
+                append(std::forward<R>(range));
+                merge_and_unique(old_size);
+            }
+        );
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void
+    insert(sorted_unique_t, It first, Sentinel last)
+    {
+        insert_range(sorted_unique, std::ranges::subrange(first, last));
+    }
+
+    auto
+    erase(const_iterator pos) -> iterator
+    {
+        size_type const i = pos - begin();
+        guarded(
+            [&]
+            {
+                m_keys.erase(std::ranges::begin(m_keys) + i);
+                m_values.erase(std::ranges::begin(m_values) + i);
+            }
+        );
+        return begin() + i;
+    }
+
+    auto
+    erase(iterator pos) -> iterator
+    {
+        return erase(const_iterator{pos});
+    }
+
+    auto
+    erase(Key const & key) -> size_type
+    {
+        size_type const i = find_index(key);
+        if (i == size()) return 0;
+        erase(begin() + i);
+        return 1;
+    }
+
+    void
+    clear() noexcept
+    {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    // moves the containers out, the map is empty afterwards
+    [[nodiscard]] auto
+    extract() && -> containers
+    {
+        containers result{std::move(m_keys), std::move(m_values)};
+        clear();
+        return result;
+    }
+
+    // takes containers that are sorted and without duplicates
+    void
+    replace(KeyContainer&& keys, MappedContainer&& values)
+    {
+        guarded(
+            [&]
+            {
+                m_keys   = std::move(keys);
+                m_values = std::move(values);
+            }
+        );
+    }
+
+    void
+    swap(flat_map& other) noexcept
+    {
+        using std::swap;
+        swap(m_keys, other.m_keys);
+        swap(m_values, other.m_values);
+        swap(m_compare, other.m_compare);
+    }
+
+private:
+    KeyContainer                  m_keys;
+    MappedContainer               m_values;
+    [[no_unique_address]] Compare m_compare;
+
+    [[nodiscard]] auto
+    key_data() const noexcept -> Key const *
+    {
+        return std::ranges::data(m_keys);
+    }
+
+    [[nodiscard]] auto
+    value_data() noexcept -> T*
+    {
+        return std::ranges::data(m_values);
+    }
+
+    [[nodiscard]] auto
+    value_data() const noexcept -> T const *
+    {
+        return std::ranges::data(m_values);
+    }
+
+    template <typename K>
+    [[nodiscard]] auto
+    lower_bound_index(K const & key) const -> size_type
+    {
+        return branchless_lower_bound(key_data(), size(), key, m_compare)
+             - key_data();
+    }
+
+    // index of the element with `key`, size() if there is none
+    template <typename K>
+    [[nodiscard]] auto
+    find_index(K const & key) const -> size_type
+    {
+        size_type const i = lower_bound_index(key);
+        if (i == size() || m_compare(key, key_data()[i])) return size();
+        return i;
+    }
+
+    template <typename K, typename... Args>
+    auto
+    try_emplace_impl(K&& key, Args&&... args) -> std::pair<iterator, bool>
+    {
+        size_type const i = lower_bound_index(key);
+        if (i != size() && !m_compare(key, key_data()[i]))
+        {
+            return {begin() + i, false};
+        }
+        m_keys.emplace(std::ranges::begin(m_keys) + i, std::forward<K>(key));
+        try
+        {
+            m_values.emplace(
+                std::ranges::begin(m_values) + i, std::forward<Args>(args)...
+            );
+        }
+        catch (...)
+        {
+            m_keys.erase(std::ranges::begin(m_keys) + i);
+            throw;
+        }
+        return {begin() + i, true};
+    }
+
+    // clears the map if `f` throws, the two containers might not match
+    // anymore
+    template <typename F>
+    void
+    guarded(F&& f)
+    {
+        try
+        {
+            std::forward<F>(f)();
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template <typename R>
+    void
+    append(R&& range)
+    {
+        // Forwarded per element: moved from only when the range yields
+        // rvalue pairs. std::get keeps the references of a proxy element
+        // such as pair_iterator::reference, so they are copied from.
+        for (auto&& element : range)
+        {
+            using element_t = decltype(element);
+            m_keys.emplace_back(std::get<0>(std::forward<element_t>(element)));
+            m_values.emplace_back(
+                std::get<1>(std::forward<element_t>(element))
+            );
+        }
+    }
+
+    [[nodiscard]] auto
+    zipped() noexcept
+    {
+        return std::views::zip(m_keys, m_values);
+    }
+
+    // compares zipped elements by key
+    [[nodiscard]] auto
+    by_key() const noexcept
+    {
+        return [](auto const & element) -> decltype(auto)
+        { return std::get<0>(element); };
+    }
+
+    // sorts the elements from `first` on, then merges them into the sorted
+    // elements before
+    void
+    sort_and_unique(size_type first)
+    {
+        auto zip = zipped();
+        std::ranges::sort(zip.begin() + first, zip.end(), m_compare, by_key());
+        merge_and_unique(first);
+    }
+
+    // merges the sorted elements from `first` on into the sorted elements
+    // before, keeps the first of equivalent keys
+    void
+    merge_and_unique(size_type first)
+    {
+        auto zip = zipped();
+        std::ranges::inplace_merge(
+            zip.begin(), zip.begin() + first, zip.end(), m_compare, by_key()
+        );
+        auto const duplicates = std::ranges::unique(
+            zip,
+            [this](Key const & lhs, Key const & rhs)
+            { return !m_compare(lhs, rhs); },
+            by_key()
+        );
+        size_type const new_size = duplicates.begin() - zip.begin();
+        m_keys.erase(std::ranges::begin(m_keys) + new_size, m_keys.end());
+        m_values.erase(std::ranges::begin(m_values) + new_size, m_values.end());
+    }
+};
+
+export template <
+    typename Key,
+    typename T,
+    typename Compare,
+    typename KeyContainer,
+    typename MappedContainer>
+void
+swap(
+    flat_map<Key, T, Compare, KeyContainer, MappedContainer>& lhs,
+    flat_map<Key, T, Compare, KeyContainer, MappedContainer>& rhs
+) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tinystd
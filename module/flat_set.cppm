@@ -0,0 +1,338 @@
+export module tinystd:flat_set;
+
+import std;
+import :vector;
+import :flat_map;
+
+namespace tinystd
+{
+
+// Sorted set in one sorted array, as C++23 `std::flat_set`; lookups and bulk
+// inserts work as for flat_map.
+export template <
+    typename Key,
+    typename Compare      = std::less<Key>,
+    typename KeyContainer = vector<Key>>
+    requires std::ranges::contiguous_range<KeyContainer>
+class flat_set
+{
+public:
+    using key_type        = Key;
+    using value_type      = Key;
+    using key_compare     = Compare;
+    using reference       = Key const &;
+    using const_reference = Key const &;
+    using size_type       = std::size_t;
+    using container_type  = KeyContainer;
+    using iterator        = Key const *;
+    using const_iterator  = Key const *;
+
+    // constructors
+    flat_set() = default;
+
+    explicit flat_set(Compare const & comp) : m_compare{comp} {}
+
+    // sorts the keys and drops duplicates
+    explicit flat_set(KeyContainer keys, Compare const & comp = Compare())
+        : m_keys{std::move(keys)}
+        , m_compare{comp}
+    {
+        guarded([&] { sort_and_unique(0); });
+    }
+
+    flat_set(
+        sorted_unique_t,
+        KeyContainer    keys,
+        Compare const & comp = Compare()
+    )
+        : m_keys{std::move(keys)}
+        , m_compare{comp}
+    {
+    }
+
+    flat_set(std::initializer_list<Key> list, Compare const & comp = Compare())
+        : m_compare{comp}
+    {
+        insert_range(list);
+    }
+
+    // access and observers
+    [[nodiscard]] auto
+    size() const noexcept -> size_type
+    {
+        return std::ranges::size(m_keys);
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] auto
+    key_comp() const -> key_compare
+    {
+        return m_compare;
+    }
+
+    [[nodiscard]] auto
+    begin() const noexcept -> const_iterator
+    {
+        return std::ranges::data(m_keys);
+    }
+
+    [[nodiscard]] auto
+    end() const noexcept -> const_iterator
+    {
+        return begin() + size();
+    }
+
+    [[nodiscard]] auto
+    lower_bound(Key const & key) const -> const_iterator
+    {
+        return branchless_lower_bound(begin(), size(), key, m_compare);
+    }
+
+    [[nodiscard]] auto
+    find(Key const & key) const -> const_iterator
+    {
+        return find_impl(key);
+    }
+
+    [[nodiscard]] auto
+    contains(Key const & key) const -> bool
+    {
+        return find_impl(key) != end();
+    }
+
+    template <typename K>
+        requires transparent<Compare>
+    [[nodiscard]] auto
+    find(K const & key) const -> const_iterator
+    {
+        return find_impl(key);
+    }
+
+    template <typename K>
+        requires transparent<Compare>
+    [[nodiscard]] auto
+    contains(K const & key) const -> bool
+    {
+        return find_impl(key) != end();
+    }
+
+    [[nodiscard]] auto
+    count(Key const & key) const -> size_type
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    [[nodiscard]] friend auto
+    operator==(flat_set const & lhs, flat_set const & rhs) -> bool
+    {
+        return std::ranges::equal(lhs.m_keys, rhs.m_keys);
+    }
+
+    // modifiers
+    auto
+    insert(Key const & key) -> std::pair<iterator, bool>
+    {
+        return insert_impl(key);
+    }
+
+    auto
+    insert(Key&& key) -> std::pair<iterator, bool>
+    {
+        return insert_impl(std::move(key));
+    }
+
+    template <typename... Args>
+    auto
+    emplace(Args&&... args) -> std::pair<iterator, bool>
+    {
+        return insert(Key(std::forward<Args>(args)...));
+    }
+
+    // appends the range, sorts the new keys and merges them in once
+    template <std::ranges::input_range R>
+    void
+    insert_range(R&& range)
+    {
+        size_type const old_size = size();
+        guarded(
+            [&]
+            {
+                append(std::forward<R>(range));
+                sort_and_unique(old_size);
+            }
+        );
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void
+    insert(It first, Sentinel last)
+    {
+        insert_range(std::ranges::subrange(first, last));
+    }
+
+    // as insert_range for a sorted range without duplicates, only merges
+    template <std::ranges::input_range R>
+    void
+    insert_range(sorted_unique_t, R&& range)
+    {
+        size_type const old_size = size();
+        guarded(
+            [&]
+            {
+                append(std::forward<R>(range));
+                merge_and_unique(old_size);
+            }
+        );
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void
+    insert(sorted_unique_t, It first, Sentinel last)
+    {
+        insert_range(sorted_unique, std::ranges::subrange(first, last));
+    }
+
+    auto
+    erase(const_iterator pos) -> iterator
+    {
+        size_type const i = pos - begin();
+        guarded([&] { m_keys.erase(std::ranges::begin(m_keys) + i); });
+        return begin() + i;
+    }
+
+    auto
+    erase(Key const & key) -> size_type
+    {
+        const_iterator const it = find(key);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    void
+    clear() noexcept
+    {
+        m_keys.clear();
+    }
+
+    // moves the container out, the set is empty afterwards
+    [[nodiscard]] auto
+    extract() && -> KeyContainer
+    {
+        KeyContainer result = std::move(m_keys);
+        clear();
+        return result;
+    }
+
+    // takes a container that is sorted and without duplicates
+    void
+    replace(KeyContainer&& keys)
+    {
+        m_keys = std::move(keys);
+    }
+
+    void
+    swap(flat_set& other) noexcept
+    {
+        using std::swap;
+        swap(m_keys, other.m_keys);
+        swap(m_compare, other.m_compare);
+    }
+
+private:
+    KeyContainer                  m_keys;
+    [[no_unique_address]] Compare m_compare;
+
+    template <typename K>
+    [[nodiscard]] auto
+    find_impl(K const & key) const -> const_iterator
+    {
+        const_iterator const it =
+            branchless_lower_bound(begin(), size(), key, m_compare);
+        if (it == end() || m_compare(key, *it)) return end();
+        return it;
+    }
+
+    template <typename K>
+    auto
+    insert_impl(K&& key) -> std::pair<iterator, bool>
+    {
+        const_iterator const it = lower_bound(key);
+        if (it != end() && !m_compare(key, *it)) return {it, false};
+        size_type const i = it - begin();
+        m_keys.emplace(std::ranges::begin(m_keys) + i, std::forward<K>(key));
+        return {begin() + i, true};
+    }
+
+    // clears the set if `f` throws, the keys might not be sorted anymore
+    template <typename F>
+    void
+    guarded(F&& f)
+    {
+        try
+        {
+            std::forward<F>(f)();
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template <typename R>
+    void
+    append(R&& range)
+    {
+        for (auto&& key : range)
+        {
+            m_keys.emplace_back(std::forward<decltype(key)>(key));
+        }
+    }
+
+    // sorts the keys from `first` on, then merges them into the sorted keys
+    // before
+    void
+    sort_and_unique(size_type first)
+    {
+        auto const keys_begin = std::ranges::begin(m_keys);
+        std::ranges::sort(
+            keys_begin + first, std::ranges::end(m_keys), m_compare
+        );
+        merge_and_unique(first);
+    }
+
+    // merges the sorted keys from `first` on into the sorted keys before,
+    // keeps the first of equivalent keys
+    void
+    merge_and_unique(size_type first)
+    {
+        auto const keys_begin = std::ranges::begin(m_keys);
+        std::ranges::inplace_merge(
+            keys_begin, keys_begin + first, std::ranges::end(m_keys), m_compare
+        );
+        auto const duplicates = std::ranges::unique(
+            m_keys,
+            [this](Key const & lhs, Key const & rhs)
+            { return !m_compare(lhs, rhs); }
+        );
+        m_keys.erase(duplicates.begin(), duplicates.end());
+    }
+};
+
+export template <typename Key, typename Compare, typename KeyContainer>
+void
+swap(
+    flat_set<Key, Compare, KeyContainer>& lhs,
+    flat_set<Key, Compare, KeyContainer>& rhs
+) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tinystd
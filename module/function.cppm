@@ -168,4 +168,163 @@ operator==(function<R(Args...)> const & f, std::nullptr_t) noexcept
     return !static_cast<bool>(f);
 }
 
+export template <class>
+class move_only_function;
+
+template <typename F, typename R, typename... Args>
+concept move_only_function_constructible =
+    (!std::same_as<std::decay_t<F>, move_only_function<R(Args...)>>)
+    && std::move_constructible<std::decay_t<F>> && std::invocable<F&, Args...>
+    && std::convertible_to<std::invoke_result_t<F&, Args...>, R>;
+
+// Move-only counterpart of function with a larger buffer: callables of up to
+// three pointers that are nothrow move constructible, e.g. lambdas capturing
+// a few references or a unique_ptr, are stored without heap allocation.
+export template <typename R, typename... Args>
+class move_only_function<R(Args...)>
+{
+    constexpr static std::size_t buffer_size = 3 * sizeof(void*);
+
+    // moves the target from src to dst and destroys the source, or only
+    // destroys src if dst is nullptr
+    using relocate_t = void (*)(char*, char*) noexcept;
+    using invoke_t   = R (*)(char*, Args...);
+
+    template <typename F>
+    constexpr static bool inplace = sizeof(F) <= buffer_size
+                                 && alignof(F) <= alignof(void*)
+                                 && std::is_nothrow_move_constructible_v<F>;
+
+public:
+    move_only_function() noexcept : m_relocate{nullptr}, m_invoke{nullptr} {}
+    move_only_function(std::nullptr_t) noexcept : move_only_function() {}
+
+    move_only_function(move_only_function&& other) noexcept
+        : m_relocate{std::exchange(other.m_relocate, nullptr)}
+        , m_invoke{std::exchange(other.m_invoke, nullptr)}
+    {
+        if (m_relocate) m_relocate(other.m_buf.data(), m_buf.data());
+    }
+
+    move_only_function(move_only_function const &) = delete;
+
+    template <move_only_function_constructible<R, Args...> F>
+    move_only_function(F&& f)
+    {
+        using func_t = std::decay_t<F>;
+        if constexpr (inplace<func_t>)
+        {
+            std::construct_at(
+                reinterpret_cast<func_t*>(m_buf.data()), std::forward<F>(f)
+            );
+        }
+        else
+        {
+            std::construct_at(
+                reinterpret_cast<func_t**>(m_buf.data()),
+                ::new func_t{std::forward<F>(f)}
+            );
+        }
+
+        m_relocate = [](char* src, char* dst) noexcept
+        {
+            if constexpr (inplace<func_t>)
+            {
+                auto const ptr = reinterpret_cast<func_t*>(src);
+                if (dst)
+                {
+                    std::construct_at(
+                        reinterpret_cast<func_t*>(dst), std::move(*ptr)
+                    );
+                }
+                std::destroy_at(ptr);
+            }
+            else
+            {
+                auto const ptr = *reinterpret_cast<func_t**>(src);
+                if (dst)
+                {
+                    std::construct_at(reinterpret_cast<func_t**>(dst), ptr);
+                }
+                else { delete ptr; }
+            }
+        };
+        m_invoke = [](char* buf, Args... args) -> R
+        {
+            return std::invoke(
+                *get_ptr<func_t>(buf), std::forward<Args>(args)...
+            );
+        };
+    }
+
+    ~move_only_function() noexcept { reset(); }
+
+    auto
+    operator=(move_only_function&& other) noexcept -> move_only_function&
+    {
+        if (this != &other)
+        {
+            reset();
+            m_relocate = std::exchange(other.m_relocate, nullptr);
+            m_invoke   = std::exchange(other.m_invoke, nullptr);
+            if (m_relocate) m_relocate(other.m_buf.data(), m_buf.data());
+        }
+        return *this;
+    }
+
+    auto
+    operator=(move_only_function const &) = delete;
+
+    // UB if *this does not store a callable target
+    auto
+    operator()(Args... args) -> R
+    {
+        return m_invoke(m_buf.data(), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+    void
+    reset() noexcept
+    {
+        if (m_relocate) m_relocate(m_buf.data(), nullptr);
+        m_relocate = nullptr;
+        m_invoke   = nullptr;
+    }
+
+    void
+    swap(move_only_function& rhs) noexcept
+    {
+        std::swap(*this, rhs);
+    }
+
+private:
+    alignas(void*) std::array<char, buffer_size> m_buf;
+    relocate_t m_relocate;
+    invoke_t   m_invoke;
+
+    template <typename F>
+    static auto
+    get_ptr(char* buf) noexcept -> F*
+    {
+        if constexpr (inplace<F>) { return reinterpret_cast<F*>(buf); }
+        else { return *reinterpret_cast<F**>(buf); }
+    }
+};
+
+export template <typename R, typename... Args>
+void
+swap(move_only_function<R(Args...)>& lhs, move_only_function<R(Args...)>& rhs)
+    noexcept
+{
+    lhs.swap(rhs);
+}
+
+export template <typename R, typename... Args>
+bool
+operator==(move_only_function<R(Args...)> const & f, std::nullptr_t) noexcept
+{
+    return !static_cast<bool>(f);
+}
+
 } // namespace tinystd
\ No newline at end of file
@@ -8,6 +8,10 @@ import std;
 namespace tinystd
 {
 
+// Number of hazard pointers a thread can own for a given type, see
+// make_hazard_pointer.
+export constexpr std::size_t hazard_pointers_per_thread = 2;
+
 template <typename T>
 class hp_slot_list
 {
@@ -20,10 +24,11 @@ public:
         // slot so that resources in this slot can be reused by another thread.
         std::atomic<bool> in_use{false};
 
-        // The *actual* "Hazard Pointer" that protects the object that it points
-        // to. Other threads scan for the set of all such pointers before they
-        // clean up.
-        std::atomic<T const *> protected_ptr{nullptr};
+        // The *actual* "Hazard Pointers" that protect the objects that they
+        // point to. Other threads scan for the set of all such pointers before
+        // they clean up.
+        std::array<std::atomic<T const *>, hazard_pointers_per_thread>
+            protected_ptrs{};
 
         // The list of hp_slots are in the form of linked list, so that when
         // multiple threads are trying to append new hp_slot, they can use CAS
@@ -43,11 +48,16 @@ public:
         std::span<hp_slot*>   init_slots; // init_slots part of the list cache
 
         // Local retired list for a thread, protected by in_use.
-        // When the size exceeds 2 * numOfThreads (estimated by
-        // hp_slot_list_cache.size()), we will perform a cleanup and it is
-        // guaranteed that we can clean up at least numOfThreads objects. So
-        // there are at most O(numOfThreads ^ 2) unreclaimed objects.
-        std::vector<std::unique_ptr<T>> retired_list;
+        // When the size exceeds 2 * numOfHazardPointers (numOfThreads is
+        // estimated by hp_slot_list_cache.size()), we will perform a cleanup
+        // and it is guaranteed that we can clean up at least
+        // numOfHazardPointers objects. So there are at most
+        // O(numOfThreads ^ 2) unreclaimed objects.
+        //
+        // Each retired pointer carries the function that reclaims it, which
+        // is `delete ptr` unless specified otherwise.
+        using reclaim_t = void (*)(T*) noexcept;
+        std::vector<std::unique_ptr<T, reclaim_t>> retired_list;
 
         // During cleanup, the list of hazard pointers will be added to
         // protected_set, this is used to avoid scanning the list of hazard
@@ -70,52 +80,79 @@ public:
         };
 
         void
-        retire(T* ptr)
+        retire(T* ptr, reclaim_t reclaim)
         {
-            retired_list.emplace_back(ptr);
+            retired_list.emplace_back(ptr, reclaim);
             auto const cleanup_threshold =
-                (init_slots.size() + hp_slot_list_cache.size()) * 2;
-            if (retired_list.size() > cleanup_threshold)
+                (init_slots.size() + hp_slot_list_cache.size())
+                * hazard_pointers_per_thread * 2;
+            if (retired_list.size() > cleanup_threshold) cleanup();
+        }
+
+        // reclaims every object of the retired list that is not protected
+        void
+        cleanup()
+        {
+            if (retired_list.empty()) return;
+
+            // Pairs with the fence in hazard_pointer::try_protect: either
+            // the protecting thread sees the retired pointer unlinked, or
+            // we see its protection.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::unordered_set<T const *> protected_set;
+            // Scanning the hazard pointer list to populate protected_set
+            for (auto slot_ptr : init_slots)
             {
-                std::unordered_set<T const *> protected_set;
-                // Scanning the hazard pointer list to populate protected_set
-                for (auto slot_ptr : init_slots)
-                {
-                    protected_set.insert(
-                        slot_ptr->protected_ptr.load(std::memory_order_acquire)
-                    );
-                }
-
-                for (auto slot_ptr : hp_slot_list_cache)
-                {
-                    protected_set.insert(
-                        slot_ptr->protected_ptr.load(std::memory_order_acquire)
-                    );
-                }
-
-                auto slot_ptr = hp_slot_list_cache.empty()
-                                  ? init_slots.back()
-                                  : hp_slot_list_cache.back();
-                do {
-                    auto next = slot_ptr->next.load(std::memory_order_acquire);
-                    if (!next) break;
-                    slot_ptr = next;
-                    hp_slot_list_cache.push_back(slot_ptr);
-                    protected_set.insert(
-                        slot_ptr->protected_ptr.load(std::memory_order_acquire)
-                    );
-                } while (true);
-
-                // Complete scanning, try to reclaim any object that is not
-                // protected
-                std::erase_if(
-                    retired_list,
-                    [&](auto& ptr)
-                    { return !protected_set.contains(ptr.get()); }
-                );
+                insert_protected(protected_set, slot_ptr);
+            }
 
-                // clear all elements while maintaining the memory for next use
-                // protected_set.clear();
+            for (auto slot_ptr : hp_slot_list_cache)
+            {
+                insert_protected(protected_set, slot_ptr);
+            }
+
+            auto slot_ptr = hp_slot_list_cache.empty()
+                              ? init_slots.back()
+                              : hp_slot_list_cache.back();
+            do {
+                auto next = slot_ptr->next.load(std::memory_order_acquire);
+                if (!next) break;
+                slot_ptr = next;
+                hp_slot_list_cache.push_back(slot_ptr);
+                insert_protected(protected_set, slot_ptr);
+            } while (true);
+
+            // Complete scanning, try to reclaim any object that is not
+            // protected. Objects are reclaimed only after they are
+            // removed from retired_list, because reclaiming an object may
+            // retire other objects.
+            auto const first_unprotected = std::partition(
+                retired_list.begin(),
+                retired_list.end(),
+                [&](auto& ptr) { return protected_set.contains(ptr.get()); }
+            );
+            std::vector<std::unique_ptr<T, reclaim_t>> reclaimed(
+                std::make_move_iterator(first_unprotected),
+                std::make_move_iterator(retired_list.end())
+            );
+            retired_list.erase(first_unprotected, retired_list.end());
+            reclaimed.clear();
+
+            // clear all elements while maintaining the memory for next use
+            // protected_set.clear();
+        }
+
+        static void
+        insert_protected(
+            std::unordered_set<T const *>& protected_set, hp_slot* slot_ptr
+        )
+        {
+            for (auto& protected_ptr : slot_ptr->protected_ptrs)
+            {
+                protected_set.insert(
+                    protected_ptr.load(std::memory_order_acquire)
+                );
             }
         }
     };
@@ -197,6 +234,17 @@ private:
     std::vector<hp_slot*> init_slots;
 };
 
+export template <typename T>
+class hazard_pointer;
+
+// Returns the hazard pointer number index (< hazard_pointers_per_thread) of
+// the calling thread for type T. Hazard pointers obtained with the same index
+// share their protection, so an algorithm that must protect two objects of
+// the same type at once uses two indices.
+export template <typename T>
+auto
+make_hazard_pointer(std::size_t index = 0) -> hazard_pointer<T>;
+
 // main interface for user
 //
 export template <typename T>
@@ -208,7 +256,24 @@ public:
     static void
     retire(T* ptr)
     {
-        local_slot.owned_slot->retire(ptr);
+        local_slot.owned_slot->retire(ptr, [](T* p) noexcept { delete p; });
+    }
+
+    // reclaim(ptr) is called instead of `delete ptr` once ptr is not
+    // protected by any hazard pointer
+    static void
+    retire(T* ptr, void (*reclaim)(T*) noexcept)
+    {
+        local_slot.owned_slot->retire(ptr, reclaim);
+    }
+
+    // Reclaims the objects retired by the calling thread that are no longer
+    // protected now, instead of waiting for the retired list to grow past the
+    // cleanup threshold. Costs a scan of all hazard pointers.
+    static void
+    cleanup()
+    {
+        local_slot.owned_slot->cleanup();
     }
 
     // default constructor will not acquire a hp_slot
@@ -224,7 +289,10 @@ public:
     {
         if (this != &other)
         {
-            if (!empty()) reset_protection();
+            // hazard pointers of the same index share a slot, `other` may
+            // have just published a protection in it, as in
+            // `hp = make_hazard_pointer<T>(); hp.protect(src);`
+            if (!empty() && m_slot != other.m_slot) reset_protection();
             m_slot = std::exchange(other.m_slot, nullptr);
         }
         return *this;
@@ -265,6 +333,10 @@ public:
     {
         auto old = ptr;
         reset_protection(old);
+        // The protection must be visible to the reclaiming thread before we
+        // validate it by reloading src, a release store followed by an
+        // acquire load can be reordered.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         ptr = src.load(std::memory_order_acquire);
         return old == ptr;
     }
@@ -272,15 +344,16 @@ public:
     void
     reset_protection(T const * ptr = nullptr) noexcept
     {
-        m_slot->protected_ptr.store(ptr, std::memory_order_release);
+        m_slot->store(ptr, std::memory_order_release);
     }
 
 private:
-    hp_slot* m_slot;
+    // one of the protected pointers of the hp_slot of the thread
+    std::atomic<T const *>* m_slot;
 
     template <typename U>
     friend auto
-    make_hazard_pointer() -> hazard_pointer<U>;
+    make_hazard_pointer(std::size_t index) -> hazard_pointer<U>;
 
     // Initialize on first use.
     inline static thread_local hp_slot::Owner const local_slot{};
@@ -288,10 +361,11 @@ private:
 
 export template <typename T>
 auto
-make_hazard_pointer() -> hazard_pointer<T>
+make_hazard_pointer(std::size_t index) -> hazard_pointer<T>
 {
     hazard_pointer<T> hp;
-    hp.m_slot = hazard_pointer<T>::local_slot.owned_slot;
+    hp.m_slot =
+        &hazard_pointer<T>::local_slot.owned_slot->protected_ptrs[index];
     return hp;
 }
 
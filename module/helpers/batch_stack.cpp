@@ -0,0 +1,143 @@
+export module tinystd:batch_stack;
+
+import std;
+
+namespace tinystd
+{
+
+// A free memory block of a pool, its first bytes are reused to link it into
+// a free list and into a batch_stack.
+struct free_block
+{
+    // next block in the same local free list or batch
+    free_block* next;
+
+    // number of blocks in the batch, only valid in the head of a batch
+    std::size_t count;
+
+    // next batch in the global stack, only valid in the head of a batch.
+    // It is atomic since a popping thread may read it while the batch is
+    // popped and reused by another thread, in which case the CAS of the
+    // popping thread fails due to the tag.
+    std::atomic<free_block*> next_batch;
+};
+
+// Treiber stack of batches. The head is a tagged pointer: the upper 16 bits
+// of a user-space pointer on x86-64 and AArch64 are unused and hold a counter
+// bumped on every successful CAS, which avoids ABA when a batch is popped and
+// pushed back while another thread is popping.
+class batch_stack
+{
+public:
+    void
+    push(free_block* batch) noexcept
+    {
+        auto old_head = m_head.load(std::memory_order_relaxed);
+        do {
+            batch->next_batch.store(
+                unpack(old_head), std::memory_order_relaxed
+            );
+        } while (!m_head.compare_exchange_weak(
+            old_head,
+            pack(batch, old_head),
+            std::memory_order_release,
+            std::memory_order_relaxed
+        ));
+    }
+
+    [[nodiscard]] auto
+    pop() noexcept -> free_block*
+    {
+        auto        old_head = m_head.load(std::memory_order_acquire);
+        free_block* batch;
+        do {
+            batch = unpack(old_head);
+            if (batch == nullptr) return nullptr;
+        } while (!m_head.compare_exchange_weak(
+            old_head,
+            pack(batch->next_batch.load(std::memory_order_relaxed), old_head),
+            std::memory_order_acquire,
+            std::memory_order_acquire
+        ));
+        return batch;
+    }
+
+private:
+    constexpr static std::uint64_t ptr_mask = (std::uint64_t{1} << 48) - 1;
+
+    std::atomic<std::uint64_t> m_head{0};
+
+    [[nodiscard]] static auto
+    unpack(std::uint64_t head) noexcept -> free_block*
+    {
+        return reinterpret_cast<free_block*>(head & ptr_mask);
+    }
+
+    [[nodiscard]] static auto
+    pack(free_block* ptr, std::uint64_t old_head) noexcept -> std::uint64_t
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr)
+             | ((old_head & ~ptr_mask) + (ptr_mask + 1));
+    }
+};
+
+// Per-thread free list that exchanges whole batches with a global
+// batch_stack. Trivially destructible, see size_class_cache::thread_cache.
+struct local_free_list
+{
+    free_block* head;
+    std::size_t size;
+
+    // takes a batch from global if the list is empty, returns whether the
+    // list is non-empty
+    auto
+    refill(batch_stack& global) noexcept -> bool
+    {
+        if (head) return true;
+        auto const batch = global.pop();
+        if (batch == nullptr) return false;
+        head = batch;
+        size = batch->count;
+        return true;
+    }
+
+    // the list must be non-empty
+    [[nodiscard]] auto
+    pop() noexcept -> free_block*
+    {
+        auto const block = head;
+        head             = block->next;
+        --size;
+        return block;
+    }
+
+    // Once the list grows to 2 * batch_size blocks, keeps the most recently
+    // freed (hot) blocks and hands over the rest to global as one batch.
+    void
+    push(free_block* block, batch_stack& global, std::size_t batch_size)
+        noexcept
+    {
+        block->next = std::exchange(head, block);
+        if (++size < 2 * batch_size) return;
+
+        auto last = head;
+        for (std::size_t i = 1; i < batch_size; ++i) last = last->next;
+        auto batch   = std::exchange(last->next, nullptr);
+        batch->count = size - batch_size;
+        size         = batch_size;
+        global.push(batch);
+    }
+
+    // hands over all blocks to global, e.g. when the thread exits
+    void
+    drain(batch_stack& global) noexcept
+    {
+        if (head == nullptr) return;
+        head->count = size;
+        global.push(head);
+        head = nullptr;
+        size = 0;
+    }
+};
+
+} // namespace tinystd
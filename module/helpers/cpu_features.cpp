@@ -0,0 +1,36 @@
+export module tinystd:cpu_features;
+
+import std;
+
+namespace tinystd
+{
+
+// Runtime CPU feature checks, evaluated once per process. Kernels compiled
+// with `[[gnu::target(...)]]` may only be called when the matching check
+// returns true, the library itself is built for the baseline ISA.
+[[nodiscard]] inline auto
+cpu_has_avx2() noexcept -> bool
+{
+#if defined(__x86_64__)
+    static bool const avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+// AVX-512 with byte and word lanes (F and BW), for 512-bit kernels over
+// 8- and 16-bit elements as well
+[[nodiscard]] inline auto
+cpu_has_avx512() noexcept -> bool
+{
+#if defined(__x86_64__)
+    static bool const avx512 = __builtin_cpu_supports("avx512f")
+                            && __builtin_cpu_supports("avx512bw");
+    return avx512;
+#else
+    return false;
+#endif
+}
+
+} // namespace tinystd
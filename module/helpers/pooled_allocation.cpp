@@ -0,0 +1,52 @@
+export module tinystd:pooled_allocation;
+
+import std;
+import :size_class_cache;
+
+namespace tinystd
+{
+
+// Allocation of the fixed-size nodes of concurrent containers. Nodes that fit
+// in a size class of size_class_cache are recycled through the per-thread
+// cache, other nodes go through the global allocator.
+template <typename Node, typename... Args>
+[[nodiscard]] auto
+pooled_new(Args&&... args) -> Node*
+{
+    if constexpr (size_class_cache::cacheable<Node>)
+    {
+        auto const ptr = size_class_cache::allocate(sizeof(Node));
+        try
+        {
+            return std::construct_at(
+                static_cast<Node*>(ptr), std::forward<Args>(args)...
+            );
+        }
+        catch (...)
+        {
+            size_class_cache::deallocate(ptr, sizeof(Node));
+            throw;
+        }
+    }
+    else
+    {
+        return ::new Node(std::forward<Args>(args)...);
+    }
+}
+
+template <typename Node>
+void
+pooled_delete(Node* node) noexcept
+{
+    if constexpr (size_class_cache::cacheable<Node>)
+    {
+        std::destroy_at(node);
+        size_class_cache::deallocate(node, sizeof(Node));
+    }
+    else
+    {
+        ::delete node;
+    }
+}
+
+} // namespace tinystd
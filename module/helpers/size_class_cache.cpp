@@ -0,0 +1,145 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:size_class_cache;
+
+import std;
+import :batch_stack;
+
+namespace tinystd
+{
+
+// Recycles memory blocks of small size classes without going through the
+// global allocator.
+//
+// - Every thread keeps one free list per size class, allocate/deallocate only
+//   touch the local free list in the common case.
+// - When a local free list grows to 2 * batch_size blocks, batch_size blocks
+//   are handed over to a global lock-free stack of batches in one CAS. When a
+//   local free list is empty, a whole batch is taken from the global stack in
+//   one CAS. Memory freed by a consumer thread can thus be reused by a
+//   producer thread.
+// - Memory of recycled blocks is never given back to the global allocator.
+// - Blocks of size classes that are whole cache lines are aligned to a cache
+//   line, an object filling such a block touches no more lines than needed.
+class size_class_cache
+{
+public:
+    constexpr static std::size_t granularity = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    constexpr static std::size_t max_size    = 512;
+    constexpr static std::size_t batch_size  = 32;
+
+    // whether objects of type T can be placed in a recycled block
+    template <typename T>
+    constexpr static bool cacheable =
+        sizeof(T) <= max_size && alignof(T) <= granularity;
+
+    [[nodiscard]] static auto
+    allocate(std::size_t size) -> void*
+    {
+        auto const cls = size_class(size);
+        if (local_cache.closed)
+        {
+            // The thread is exiting and its local free lists are already
+            // drained, take one block of a batch and hand the rest back.
+            auto const batch = global_stacks[cls].pop();
+            if (batch == nullptr) return allocate_block(cls);
+            if (auto const rest = batch->next)
+            {
+                rest->count = batch->count - 1;
+                global_stacks[cls].push(rest);
+            }
+            return batch;
+        }
+
+        auto& list = local_cache.lists[cls];
+        if (list.head == nullptr)
+        {
+            if (!list.refill(global_stacks[cls])) return allocate_block(cls);
+
+            // register the drainer of the local free lists on first use
+            [[maybe_unused]] auto& drainer = local_drainer;
+        }
+        return list.pop();
+    }
+
+    static void
+    deallocate(void* ptr, std::size_t size) noexcept
+    {
+        auto const cls   = size_class(size);
+        auto       block = std::construct_at(static_cast<free_block*>(ptr));
+        if (local_cache.closed)
+        {
+            // The thread is exiting and its local free lists are already
+            // drained, hand the block over as a batch of 1.
+            block->count = 1;
+            global_stacks[cls].push(block);
+            return;
+        }
+
+        // register the drainer of the local free lists on first use
+        [[maybe_unused]] auto& drainer = local_drainer;
+
+        local_cache.lists[cls].push(block, global_stacks[cls], batch_size);
+    }
+
+private:
+    constexpr static std::size_t num_classes = max_size / granularity;
+
+    [[nodiscard]] constexpr static auto
+    size_class(std::size_t size) noexcept -> std::size_t
+    {
+        return (std::max(size, sizeof(free_block)) - 1) / granularity;
+    }
+
+    [[nodiscard]] constexpr static auto
+    class_size(std::size_t cls) noexcept -> std::size_t
+    {
+        return (cls + 1) * granularity;
+    }
+
+    [[nodiscard]] static auto
+    allocate_block(std::size_t cls) -> void*
+    {
+        constexpr auto cache_line = std::hardware_destructive_interference_size;
+        auto const     size       = class_size(cls);
+        // never given back, so the aligned and the plain operator delete
+        // cannot be mixed up
+        if (size % cache_line == 0)
+        {
+            return ::operator new(size, std::align_val_t{cache_line});
+        }
+        return ::operator new(size);
+    }
+
+    // Trivially destructible so that it stays accessible while the thread is
+    // exiting, e.g. when the destructor of another thread_local object
+    // releases a shared_ptr.
+    struct thread_cache
+    {
+        std::array<local_free_list, num_classes> lists;
+        bool                                     closed;
+    };
+
+    struct drainer
+    {
+        ~drainer()
+        {
+            for (std::size_t cls = 0; cls < num_classes; ++cls)
+            {
+                local_cache.lists[cls].drain(global_stacks[cls]);
+            }
+            local_cache.closed = true;
+        }
+    };
+
+    // Global stacks are never destroyed, a detached thread can still return
+    // blocks after main exits.
+    inline static constinit std::array<batch_stack, num_classes>
+        global_stacks{};
+
+    inline static thread_local constinit thread_cache local_cache{};
+    inline static thread_local drainer                local_drainer{};
+};
+
+} // namespace tinystd
@@ -0,0 +1,188 @@
+module;
+#include <sys/mman.h>
+#include <unistd.h>
+
+export module tinystd:huge_buffer_allocator;
+
+import std;
+
+namespace tinystd
+{
+
+// Raw storage for huge_buffer_allocator: blocks of at least `threshold` bytes
+// are anonymous mappings that grow with mremap, smaller ones come from
+// malloc and grow with realloc.
+class huge_buffer_storage
+{
+public:
+    [[nodiscard]] static auto
+    allocate(std::size_t bytes, std::size_t threshold, bool hugepages)
+        -> void*
+    {
+        if (bytes < threshold)
+        {
+            void* const p = std::malloc(bytes);
+            if (p == nullptr) throw std::bad_alloc{};
+            return p;
+        }
+        void* const p = ::mmap(
+            nullptr,
+            page_round(bytes),
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0
+        );
+        if (p == MAP_FAILED) throw std::bad_alloc{};
+        if (hugepages) advise_hugepages(p, bytes);
+        return p;
+    }
+
+    static void
+    deallocate(void* p, std::size_t bytes, std::size_t threshold) noexcept
+    {
+        if (bytes < threshold) { std::free(p); }
+        else { ::munmap(p, page_round(bytes)); }
+    }
+
+    // keeps the first min(old_bytes, new_bytes) bytes, the block may move
+    [[nodiscard]] static auto
+    reallocate(
+        void*       p,
+        std::size_t old_bytes,
+        std::size_t new_bytes,
+        std::size_t threshold,
+        bool        hugepages
+    ) -> void*
+    {
+        bool const old_mapped = old_bytes >= threshold;
+        bool const new_mapped = new_bytes >= threshold;
+        if (old_mapped && new_mapped)
+        {
+            // only page table entries are moved, the data is not copied
+            void* const q = ::mremap(
+                p, page_round(old_bytes), page_round(new_bytes), MREMAP_MAYMOVE
+            );
+            if (q == MAP_FAILED) throw std::bad_alloc{};
+            if (hugepages) advise_hugepages(q, new_bytes);
+            return q;
+        }
+        if (!old_mapped && !new_mapped)
+        {
+            void* const q = std::realloc(p, new_bytes);
+            if (q == nullptr) throw std::bad_alloc{};
+            return q;
+        }
+
+        // crossing the threshold, copy once
+        void* const q = allocate(new_bytes, threshold, hugepages);
+        std::memcpy(q, p, std::min(old_bytes, new_bytes));
+        deallocate(p, old_bytes, threshold);
+        return q;
+    }
+
+private:
+    [[nodiscard]] static auto
+    page_round(std::size_t bytes) noexcept -> std::size_t
+    {
+        static std::size_t const page_size = ::sysconf(_SC_PAGESIZE);
+        return (bytes + page_size - 1) & ~(page_size - 1);
+    }
+
+    static void
+    advise_hugepages(void* p, std::size_t bytes) noexcept
+    {
+        // only a hint, the mapping works with regular pages as well
+        ::madvise(p, page_round(bytes), MADV_HUGEPAGE);
+    }
+};
+
+// Stateless allocator for huge vectors of trivially relocatable elements.
+// - Blocks of `Threshold` bytes or more are anonymous mappings, a vector
+//   grows them with `reallocate`, i.e. mremap(MREMAP_MAYMOVE): a page table
+//   update instead of a copy, and no second block alive during growth.
+// - Smaller blocks come from malloc and grow with realloc.
+// - With `TransparentHugePages`, mappings are advised to be backed by huge
+//   pages.
+export template <
+    typename T,
+    std::size_t Threshold            = std::size_t{1} << 20,
+    bool        TransparentHugePages = false>
+class huge_buffer_allocator
+{
+    static_assert(
+        alignof(T) <= alignof(std::max_align_t),
+        "malloc/realloc do not keep larger alignments"
+    );
+
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = huge_buffer_allocator<U, Threshold, TransparentHugePages>;
+    };
+
+    constexpr huge_buffer_allocator() noexcept = default;
+
+    template <typename U>
+    constexpr huge_buffer_allocator(
+        huge_buffer_allocator<U, Threshold, TransparentHugePages> const &
+    ) noexcept
+    {
+    }
+
+    [[nodiscard]] auto
+    allocate(size_type n) -> T*
+    {
+        return static_cast<T*>(huge_buffer_storage::allocate(
+            bytes_for(n), Threshold, TransparentHugePages
+        ));
+    }
+
+    void
+    deallocate(T* p, size_type n) noexcept
+    {
+        huge_buffer_storage::deallocate(p, bytes_for(n), Threshold);
+    }
+
+    // Resizes a block from allocate(old_n) to new_n objects, keeping the
+    // bytes of the first min(old_n, new_n). The block may move, `p` is
+    // invalid afterwards unless this throws. Containers only use this for
+    // trivially relocatable types.
+    [[nodiscard]] auto
+    reallocate(T* p, size_type old_n, size_type new_n) -> T*
+    {
+        return static_cast<T*>(huge_buffer_storage::reallocate(
+            p,
+            bytes_for(old_n),
+            bytes_for(new_n),
+            Threshold,
+            TransparentHugePages
+        ));
+    }
+
+    friend constexpr auto
+    operator==(huge_buffer_allocator, huge_buffer_allocator) noexcept -> bool
+    {
+        return true;
+    }
+
+private:
+    [[nodiscard]] static auto
+    bytes_for(size_type n) -> std::size_t
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length{};
+        }
+        // malloc(0) may return nullptr
+        return std::max(n * sizeof(T), std::size_t{1});
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,237 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:lockfree_queue;
+
+import std;
+import :manual_lifetime;
+import :pooled_allocation;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Michael-Scott queue.
+// - The head is always a dummy node, the front element lives in the node
+//   after it. A successful pop makes that node the new dummy and retires the
+//   old one through hazard_pointer.
+// - Only one hazard pointer per thread is available for a node type, but a
+//   pop must read the old head and then move the element out of the next
+//   node. The head is therefore protected only while its next pointer is
+//   read, then the protection moves to the next node, which is still
+//   reachable if the head is unchanged. The head is a tagged pointer (16-bit
+//   counter in the unused upper bits) so that the final CAS on the head has
+//   no ABA although the old head is no longer protected.
+// - Nodes are allocated from the per-thread size_class_cache instead of the
+//   global allocator.
+export template <typename T>
+    requires std::is_nothrow_move_constructible_v<T>
+class lockfree_queue
+{
+    struct node
+    {
+        // constructed in a node after the dummy, destroyed by the pop that
+        // makes the node the dummy
+        manual_lifetime<T> data;
+        std::atomic<node*> next{nullptr};
+    };
+
+    static_assert(sizeof(node*) == sizeof(std::uint64_t));
+
+public:
+    using value_type = T;
+
+    lockfree_queue()
+        : m_head{pack(pooled_new<node>(), 0)}
+        , m_tail{unpack(m_head.load(std::memory_order_relaxed))}
+    {
+    }
+
+    // no copy/move semantics
+    lockfree_queue(lockfree_queue const &) = delete;
+    auto
+    operator=(lockfree_queue const &) = delete;
+
+    // no other thread may access the queue, nodes are freed directly
+    ~lockfree_queue() noexcept
+    {
+        auto n = unpack(m_head.load(std::memory_order_relaxed));
+        // the dummy does not hold an element
+        auto next = n->next.load(std::memory_order_relaxed);
+        pooled_delete(n);
+        while (next)
+        {
+            n    = next;
+            next = n->next.load(std::memory_order_relaxed);
+            n->data.destroy();
+            pooled_delete(n);
+        }
+    }
+
+    void
+    push(T const & value)
+    {
+        emplace(value);
+    }
+
+    void
+    push(T&& value)
+    {
+        emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    void
+    emplace(Args&&... args)
+    {
+        auto const n = pooled_new<node>();
+        try
+        {
+            n->data.emplace(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            pooled_delete(n);
+            throw;
+        }
+
+        auto hp = make_hazard_pointer<node>();
+        while (true)
+        {
+            // the head never passes the tail, so the tail is not retired
+            // while it is still the tail
+            auto tail = hp.protect(m_tail);
+            auto next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+            {
+                if (tail->next.compare_exchange_weak(
+                        next,
+                        n,
+                        std::memory_order_release,
+                        std::memory_order_relaxed
+                    ))
+                {
+                    // failure means another thread has helped
+                    m_tail.compare_exchange_strong(
+                        tail,
+                        n,
+                        std::memory_order_release,
+                        std::memory_order_relaxed
+                    );
+                    return;
+                }
+            }
+            else
+            {
+                // the tail is lagging behind, help to advance it
+                m_tail.compare_exchange_weak(
+                    tail,
+                    next,
+                    std::memory_order_release,
+                    std::memory_order_relaxed
+                );
+            }
+        }
+    }
+
+    auto
+    pop() noexcept -> std::optional<T>
+    {
+        auto hp = make_hazard_pointer<node>();
+        while (true)
+        {
+            auto       head = m_head.load(std::memory_order_acquire);
+            auto const dummy = unpack(head);
+            if (!protect(hp, dummy, head)) continue;
+
+            auto next = dummy->next.load(std::memory_order_acquire);
+            if (next == nullptr) return std::nullopt;
+
+            auto tail = m_tail.load(std::memory_order_acquire);
+            if (dummy == tail)
+            {
+                // the tail is lagging behind, help to advance it before the
+                // head passes it
+                m_tail.compare_exchange_strong(
+                    tail,
+                    next,
+                    std::memory_order_release,
+                    std::memory_order_relaxed
+                );
+                continue;
+            }
+
+            // next is reachable from the head as long as the head is unchanged
+            if (!protect(hp, next, head)) continue;
+
+            if (m_head.compare_exchange_strong(
+                    head,
+                    pack(next, head + tag_one),
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed
+                ))
+            {
+                // next is the new dummy, it stays protected while the element
+                // is moved out
+                std::optional<T> item(std::move(next->data.get()));
+                next->data.destroy();
+                hp.reset_protection();
+                hazard_pointer<node>::retire(dummy, &pooled_delete<node>);
+                return item;
+            }
+        }
+    }
+
+    // might be outdated once it returns
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        auto hp    = make_hazard_pointer<node>();
+        auto head  = m_head.load(std::memory_order_acquire);
+        auto dummy = unpack(head);
+        while (!protect(hp, dummy, head))
+        {
+            head  = m_head.load(std::memory_order_acquire);
+            dummy = unpack(head);
+        }
+        return dummy->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    constexpr static std::uint64_t ptr_mask = (std::uint64_t{1} << 48) - 1;
+    constexpr static std::uint64_t tag_one  = ptr_mask + 1;
+
+    // pointer to the dummy node in the low 48 bits, tag in the high 16 bits
+    alignas(std::hardware_destructive_interference_size)
+        std::atomic<std::uint64_t> m_head;
+
+    alignas(std::hardware_destructive_interference_size)
+        std::atomic<node*> m_tail;
+
+    [[nodiscard]] static auto
+    unpack(std::uint64_t head) noexcept -> node*
+    {
+        return reinterpret_cast<node*>(head & ptr_mask);
+    }
+
+    // keeps the tag of old_head
+    [[nodiscard]] static auto
+    pack(node* ptr, std::uint64_t old_head) noexcept -> std::uint64_t
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr) | (old_head & ~ptr_mask);
+    }
+
+    // Protects ptr, which is reachable from head, and returns whether the
+    // head is still unchanged after the protection is visible.
+    auto
+    protect(hazard_pointer<node>& hp, node* ptr, std::uint64_t head)
+        const noexcept -> bool
+    {
+        hp.reset_protection(ptr);
+        // see hazard_pointer::try_protect
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return m_head.load(std::memory_order_acquire) == head;
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,226 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:lockfree_stack;
+
+import std;
+import :manual_lifetime;
+import :pooled_allocation;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Treiber stack.
+// - pop protects the head with a hazard pointer before reading its next
+//   pointer, popped nodes are retired through hazard_pointer. A protected
+//   node is never reused, so there is no ABA on the head.
+// - Nodes are allocated from the per-thread size_class_cache instead of the
+//   global allocator.
+// - Elimination backoff: a push and a pop that fail their CAS on the head
+//   try to meet in a slot of a small elimination array and hand the node
+//   over directly, without touching the head again.
+export template <typename T>
+    requires std::is_nothrow_move_constructible_v<T>
+class lockfree_stack
+{
+    struct node
+    {
+        manual_lifetime<T> data;
+        node*              next;
+    };
+
+public:
+    using value_type = T;
+
+    lockfree_stack() noexcept : m_head{nullptr} {}
+
+    // no copy/move semantics
+    lockfree_stack(lockfree_stack const &) = delete;
+    auto
+    operator=(lockfree_stack const &) = delete;
+
+    // no other thread may access the stack, nodes are freed directly
+    ~lockfree_stack() noexcept
+    {
+        auto n = m_head.load(std::memory_order_relaxed);
+        while (n)
+        {
+            auto const next = n->next;
+            n->data.destroy();
+            pooled_delete(n);
+            n = next;
+        }
+    }
+
+    void
+    push(T const & value)
+    {
+        emplace(value);
+    }
+
+    void
+    push(T&& value)
+    {
+        emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    void
+    emplace(Args&&... args)
+    {
+        auto const n = pooled_new<node>();
+        try
+        {
+            n->data.emplace(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            pooled_delete(n);
+            throw;
+        }
+
+        n->next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(
+            n->next, n, std::memory_order_release, std::memory_order_relaxed
+        ))
+        {
+            if (try_eliminate_push(n)) return;
+        }
+    }
+
+    auto
+    pop() noexcept -> std::optional<T>
+    {
+        auto hp = make_hazard_pointer<node>();
+        auto n  = hp.protect(m_head);
+        while (n)
+        {
+            if (m_head.compare_exchange_strong(
+                    n,
+                    n->next,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed
+                ))
+            {
+                auto item = take(n);
+                hp.reset_protection();
+                hazard_pointer<node>::retire(n, &pooled_delete<node>);
+                return item;
+            }
+            // the node taken from an elimination slot was never in the stack,
+            // nobody else can see it
+            if (auto const offered = try_eliminate_pop())
+            {
+                auto item = take(offered);
+                pooled_delete(offered);
+                return item;
+            }
+            n = hp.protect(m_head);
+        }
+        return std::nullopt;
+    }
+
+    // might be outdated once it returns
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return m_head.load(std::memory_order_relaxed) == nullptr;
+    }
+
+private:
+    constexpr static std::size_t elimination_size  = 8;
+    constexpr static int         elimination_spins = 128;
+
+    // An offered node, or taken() after a pop takes it. Only the pushing
+    // thread resets it to nullptr, so a taken slot cannot be offered again
+    // before the pusher notices that its node is taken.
+    struct alignas(std::hardware_destructive_interference_size)
+        elimination_slot
+    {
+        std::atomic<node*> offer{nullptr};
+    };
+
+    alignas(std::hardware_destructive_interference_size)
+        std::atomic<node*> m_head;
+
+    std::array<elimination_slot, elimination_size> m_elimination{};
+
+    [[nodiscard]] static auto
+    taken() noexcept -> node*
+    {
+        // never dereferenced
+        return reinterpret_cast<node*>(std::uintptr_t{1});
+    }
+
+    // spreads the threads over the slots
+    auto
+    next_slot() noexcept -> elimination_slot&
+    {
+        thread_local std::size_t index =
+            std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return m_elimination[++index % elimination_size];
+    }
+
+    // returns whether n is handed over to a pop
+    auto
+    try_eliminate_push(node* n) noexcept -> bool
+    {
+        auto& offer    = next_slot().offer;
+        node* expected = nullptr;
+        if (!offer.compare_exchange_strong(
+                expected,
+                n,
+                std::memory_order_release,
+                std::memory_order_relaxed
+            ))
+        {
+            return false;
+        }
+
+        for (int i = 0; i < elimination_spins; ++i)
+        {
+            if (offer.load(std::memory_order_relaxed) == taken())
+            {
+                offer.store(nullptr, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // withdraw the offer, unless a pop takes it meanwhile
+        expected = n;
+        if (offer.compare_exchange_strong(
+                expected, nullptr, std::memory_order_relaxed
+            ))
+        {
+            return false;
+        }
+        offer.store(nullptr, std::memory_order_relaxed);
+        return true;
+    }
+
+    auto
+    try_eliminate_pop() noexcept -> node*
+    {
+        auto& offer = next_slot().offer;
+        auto  n     = offer.load(std::memory_order_relaxed);
+        if (n == nullptr || n == taken()) return nullptr;
+        if (offer.compare_exchange_strong(
+                n, taken(), std::memory_order_acquire, std::memory_order_relaxed
+            ))
+        {
+            return n;
+        }
+        return nullptr;
+    }
+
+    static auto
+    take(node* n) noexcept -> std::optional<T>
+    {
+        std::optional<T> item(std::move(n->data.get()));
+        n->data.destroy();
+        return item;
+    }
+};
+
+} // namespace tinystd
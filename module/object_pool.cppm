@@ -0,0 +1,310 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+#include <sys/mman.h>
+
+export module tinystd:object_pool;
+
+import std;
+import :batch_stack;
+import :shared_ptr;
+
+namespace tinystd
+{
+
+// slabs are taken from the global allocator
+export struct heap_slab_policy
+{
+};
+
+// slabs are 2 MiB aligned anonymous mappings advised to be backed by
+// transparent huge pages, fewer TLB misses for large pools
+export struct hugepage_slab_policy
+{
+};
+
+// Pool of fixed-size blocks for objects of type T.
+// - Every thread keeps a magazine of free blocks, allocate/deallocate only
+//   touch it in the common case.
+// - A magazine that reaches 2 * magazine_size blocks hands magazine_size of
+//   them over to a global lock-free stack of batches in one CAS, an empty
+//   magazine takes a whole batch back in one CAS. The head of the stack is a
+//   tagged pointer against ABA.
+// - When both are empty, blocks are carved from the thread's current slab
+//   with a bump pointer. A block is first touched by the thread that
+//   allocates it, so with the first-touch policy of Linux its page is placed
+//   on the NUMA node of that thread.
+// - An exiting thread hands the uncarved rest of its slab over as one range
+//   without touching it, the next thread that needs a slab carves from it.
+// - Slabs are never given back, neither are the blocks in them.
+// - One pool per (T, Policy), all members are static.
+export template <typename T, typename Policy = heap_slab_policy>
+class object_pool
+{
+    static_assert(
+        std::same_as<Policy, heap_slab_policy>
+        || std::same_as<Policy, hugepage_slab_policy>
+    );
+
+public:
+    constexpr static std::size_t block_align =
+        std::max(alignof(T), alignof(free_block));
+    constexpr static std::size_t block_size =
+        (std::max(sizeof(T), sizeof(free_block)) + block_align - 1)
+        / block_align * block_align;
+    constexpr static std::size_t magazine_size = 32;
+    constexpr static std::size_t slab_size =
+        std::same_as<Policy, hugepage_slab_policy> ? std::size_t{2} << 20
+                                                   : std::size_t{64} << 10;
+
+    static_assert(block_size <= slab_size);
+
+    // for std::unique_ptr<T, deleter> and shared_ptr(ptr, deleter)
+    struct deleter
+    {
+        void
+        operator()(T* ptr) const noexcept
+        {
+            destroy(ptr);
+        }
+    };
+
+    using unique_ptr = std::unique_ptr<T, deleter>;
+
+    // uninitialized storage for a T
+    [[nodiscard]] static auto
+    allocate() -> void*
+    {
+        if (local_state.closed) return allocate_closed();
+
+        auto& magazine = local_state.magazine;
+        if (magazine.head == nullptr)
+        {
+            if (!magazine.refill(global_stack)) return carve();
+
+            // register the drainer of the magazine on first use
+            [[maybe_unused]] auto& drainer = local_drainer;
+        }
+        return magazine.pop();
+    }
+
+    static void
+    deallocate(void* ptr) noexcept
+    {
+        auto block = std::construct_at(static_cast<free_block*>(ptr));
+        if (local_state.closed)
+        {
+            // The thread is exiting and its magazine is already drained,
+            // hand the block over as a batch of 1.
+            block->count = 1;
+            global_stack.push(block);
+            return;
+        }
+
+        // register the drainer of the magazine on first use
+        [[maybe_unused]] auto& drainer = local_drainer;
+
+        local_state.magazine.push(block, global_stack, magazine_size);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] static auto
+    create(Args&&... args) -> T*
+    {
+        auto const ptr = allocate();
+        try
+        {
+            return std::construct_at(
+                static_cast<T*>(ptr), std::forward<Args>(args)...
+            );
+        }
+        catch (...)
+        {
+            deallocate(ptr);
+            throw;
+        }
+    }
+
+    // also usable as the reclaim function of hazard_pointer<T>::retire
+    static void
+    destroy(T* ptr) noexcept
+    {
+        if (ptr == nullptr) return;
+        std::destroy_at(ptr);
+        deallocate(ptr);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] static auto
+    make_unique(Args&&... args) -> unique_ptr
+    {
+        return unique_ptr{create(std::forward<Args>(args)...)};
+    }
+
+    template <typename... Args>
+    [[nodiscard]] static auto
+    make_shared(Args&&... args) -> shared_ptr<T>
+    {
+        return shared_ptr<T>{create(std::forward<Args>(args)...), deleter{}};
+    }
+
+private:
+    // Trivially destructible so that it stays accessible while the thread is
+    // exiting, e.g. when the destructor of another thread_local object
+    // destroys a pooled object.
+    struct thread_state
+    {
+        local_free_list magazine;
+        std::byte*      slab_cursor;
+        std::byte*      slab_end;
+        bool            closed;
+    };
+
+    struct drainer
+    {
+        ~drainer()
+        {
+            auto& state = local_state;
+            // the rest of the slab is handed over untouched, so that exiting
+            // threads do not leak it and the thread that carves it touches
+            // it first
+            auto const rest =
+                static_cast<std::size_t>(state.slab_end - state.slab_cursor)
+                / block_size;
+            push_range(state.slab_cursor, rest);
+            state.slab_cursor = state.slab_end;
+            state.magazine.drain(global_stack);
+            state.closed = true;
+        }
+    };
+
+    // never destroyed, a detached thread can still return blocks after main
+    // exits
+    inline static constinit batch_stack global_stack{};
+
+    // uncarved rests of the slabs of exited threads, the count of a range is
+    // its number of blocks
+    inline static constinit batch_stack slab_ranges{};
+
+    inline static thread_local constinit thread_state local_state{};
+    inline static thread_local drainer                local_drainer{};
+
+    // The thread is exiting and its magazine and slab are already handed
+    // over, takes one block of a batch or of a slab range and hands the
+    // rest back.
+    [[nodiscard]] static auto
+    allocate_closed() -> void*
+    {
+        if (auto const batch = global_stack.pop())
+        {
+            if (auto const rest = batch->next)
+            {
+                rest->count = batch->count - 1;
+                global_stack.push(rest);
+            }
+            return batch;
+        }
+
+        std::byte*  block;
+        std::size_t blocks;
+        if (auto const range = slab_ranges.pop())
+        {
+            block  = reinterpret_cast<std::byte*>(range);
+            blocks = range->count;
+        }
+        else
+        {
+            block  = allocate_slab();
+            blocks = slab_size / block_size;
+        }
+        push_range(block + block_size, blocks - 1);
+        return block;
+    }
+
+    // hands `blocks` uncarved blocks from `first` over as one range, only
+    // the first block is written
+    static void
+    push_range(std::byte* first, std::size_t blocks) noexcept
+    {
+        if (blocks == 0) return;
+        auto const range =
+            std::construct_at(reinterpret_cast<free_block*>(first));
+        range->count = blocks;
+        slab_ranges.push(range);
+    }
+
+    [[nodiscard]] static auto
+    carve() -> void*
+    {
+        auto& state = local_state;
+        if (state.slab_end - state.slab_cursor
+            < static_cast<std::ptrdiff_t>(block_size))
+        {
+            // register the drainer of the slab on first use
+            [[maybe_unused]] auto& drainer = local_drainer;
+
+            if (auto const range = slab_ranges.pop())
+            {
+                auto const blocks = range->count;
+                state.slab_cursor = reinterpret_cast<std::byte*>(range);
+                state.slab_end    = state.slab_cursor + blocks * block_size;
+            }
+            else
+            {
+                state.slab_cursor = allocate_slab();
+                state.slab_end    = state.slab_cursor + slab_size;
+            }
+        }
+        auto const block = state.slab_cursor;
+        state.slab_cursor += block_size;
+        return block;
+    }
+
+    [[nodiscard]] static auto
+    allocate_slab() -> std::byte*
+    {
+        if constexpr (std::same_as<Policy, hugepage_slab_policy>)
+        {
+            // mmap only aligns to a page, map twice the size and trim it to a
+            // huge page boundary
+            auto const raw = ::mmap(
+                nullptr,
+                2 * slab_size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0
+            );
+            if (raw == MAP_FAILED) throw std::bad_alloc{};
+            auto const begin   = reinterpret_cast<std::uintptr_t>(raw);
+            auto const aligned = (begin + slab_size - 1) & ~(slab_size - 1);
+            if (aligned != begin)
+            {
+                ::munmap(raw, aligned - begin);
+                ::munmap(
+                    reinterpret_cast<void*>(aligned + slab_size),
+                    begin + slab_size - aligned
+                );
+            }
+            else
+            {
+                ::munmap(reinterpret_cast<void*>(begin + slab_size), slab_size);
+            }
+            // only a hint, the slab works with regular pages as well
+            ::madvise(
+                reinterpret_cast<void*>(aligned), slab_size, MADV_HUGEPAGE
+            );
+            return reinterpret_cast<std::byte*>(aligned);
+        }
+        else
+        {
+            constexpr auto align = std::max(
+                block_align, std::hardware_destructive_interference_size
+            );
+            return static_cast<std::byte*>(
+                ::operator new(slab_size, std::align_val_t{align})
+            );
+        }
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,173 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:rcu_cell;
+
+import std;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Read-mostly published value, e.g. a routing table replaced a few times a
+// minute and read millions of times a second.
+// - Readers protect the current version with a hazard pointer. The only write
+//   is to the hazard slot owned by the reading thread, no reference count or
+//   other shared cache line is touched.
+// - Writers are serialized by a mutex, publish a new version with a single
+//   exchange and retire the old one to the hazard pointer retired list, then
+//   scan it: updates are rare, so every old version that no reader protects
+//   is destroyed right away instead of waiting for the retired list to fill
+//   up.
+export template <typename T>
+class rcu_cell
+{
+    struct version
+    {
+        T value;
+    };
+
+public:
+    using value_type = T;
+
+    // Scoped read access to the version that is current when it is created,
+    // later updates do not affect it.
+    //
+    // A guard occupies the hazard pointer of the calling thread for
+    // rcu_cell<T> (one per thread and T), so a thread must not hold two
+    // guards of rcu_cell<T> at the same time, replacing one
+    // (`guard = cell.read();`) is fine. A guard must be destroyed on the
+    // thread that created it.
+    class read_guard
+    {
+    public:
+        read_guard(read_guard&& other) noexcept
+            : m_hp{std::move(other.m_hp)}
+            , m_version{std::exchange(other.m_version, nullptr)}
+        {
+        }
+        read_guard(read_guard const &) = delete;
+
+        ~read_guard() noexcept = default;
+
+        auto
+        operator=(read_guard&& other) noexcept -> read_guard&
+        {
+            if (this != &other)
+            {
+                m_hp      = std::move(other.m_hp);
+                m_version = std::exchange(other.m_version, nullptr);
+            }
+            return *this;
+        }
+        auto
+        operator=(read_guard const &) = delete;
+
+        [[nodiscard]] auto
+        get() const noexcept -> T const *
+        {
+            return std::addressof(m_version->value);
+        }
+
+        [[nodiscard]] auto
+        operator*() const noexcept -> T const &
+        {
+            return m_version->value;
+        }
+
+        [[nodiscard]] auto
+        operator->() const noexcept -> T const *
+        {
+            return get();
+        }
+
+    private:
+        hazard_pointer<version> m_hp;
+        version const *         m_version;
+
+        read_guard(hazard_pointer<version>&& hp, version const * v) noexcept
+            : m_hp{std::move(hp)}
+            , m_version{v}
+        {
+        }
+
+        friend class rcu_cell;
+    };
+
+    // Constructors
+    rcu_cell()
+        requires std::default_initializable<T>
+        : m_current{new version{}}
+    {
+    }
+    explicit rcu_cell(T value) : m_current{new version{std::move(value)}} {}
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    explicit rcu_cell(std::in_place_t, Args&&... args)
+        : m_current{new version{T(std::forward<Args>(args)...)}}
+    {
+    }
+
+    // no copy/move semantics
+    rcu_cell(rcu_cell const &) = delete;
+    auto
+    operator=(rcu_cell const &) = delete;
+
+    // no reader may be alive, old versions are owned by the retired lists
+    ~rcu_cell() noexcept { delete m_current.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] auto
+    read() const noexcept -> read_guard
+    {
+        auto hp = make_hazard_pointer<version>();
+        auto v  = hp.protect(m_current);
+        return read_guard(std::move(hp), v);
+    }
+
+    // copy of the current value
+    [[nodiscard]] auto
+    load() const -> T
+    {
+        return *read();
+    }
+
+    void
+    update(T new_value)
+    {
+        auto next = std::make_unique<version>(std::move(new_value));
+        std::scoped_lock lock{m_writer_mutex};
+        publish(next.release());
+    }
+
+    // Copy-on-write: fn is applied to a copy of the current value, which is
+    // then published. Nothing is published if fn throws.
+    template <std::invocable<T&> F>
+    void
+    modify(F&& fn)
+    {
+        std::scoped_lock lock{m_writer_mutex};
+        // writers are serialized, the current version cannot be retired
+        auto const current = m_current.load(std::memory_order_relaxed);
+        auto       next    = std::make_unique<version>(current->value);
+        std::invoke(std::forward<F>(fn), next->value);
+        publish(next.release());
+    }
+
+private:
+    // read by every reader, keep it away from the mutex written by writers
+    alignas(std::hardware_destructive_interference_size)
+        std::atomic<version*> m_current;
+
+    alignas(std::hardware_destructive_interference_size)
+        std::mutex m_writer_mutex;
+
+    void
+    publish(version* next) noexcept
+    {
+        auto const old = m_current.exchange(next, std::memory_order_acq_rel);
+        hazard_pointer<version>::retire(old);
+        hazard_pointer<version>::cleanup();
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,191 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:seqlock_cell;
+
+import std;
+
+namespace tinystd
+{
+
+// Policies of seqlock_cell:
+// - single_writer_policy: store/modify must not be called concurrently, a
+//   write is two plain stores to the sequence counter
+// - multi_writer_policy: writers acquire the cell by a CAS of the sequence
+//   counter from even to odd
+export struct single_writer_policy
+{
+};
+
+export struct multi_writer_policy
+{
+};
+
+// Sequence lock for small trivially copyable values, e.g. top-of-book prices.
+// - The sequence counter is odd while a write is in progress. A reader copies
+//   the value and retries if the counter was odd or changed meanwhile.
+// - The value is stored as an array of relaxed atomic words, so a torn read
+//   is not a data race, the fences order the words against the counter as in
+//   Hans Boehm, "Can Seqlocks Get Along With Programming Language Memory
+//   Models?".
+// - Neither a read nor a write allocates, a read does not write to any
+//   shared memory.
+export template <typename T, typename Policy = single_writer_policy>
+    requires std::is_trivially_copyable_v<T>
+class alignas(std::hardware_destructive_interference_size) seqlock_cell
+{
+    static_assert(
+        std::same_as<Policy, single_writer_policy>
+        || std::same_as<Policy, multi_writer_policy>
+    );
+
+    using word = std::uint64_t;
+
+    constexpr static std::size_t num_words =
+        (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+    using words = std::array<word, num_words>;
+
+public:
+    using value_type = T;
+
+    // Constructors
+    seqlock_cell()
+        requires std::default_initializable<T>
+        : seqlock_cell(T{})
+    {
+    }
+    explicit seqlock_cell(T const & value) noexcept : m_seq{0}
+    {
+        write_words(to_words(value));
+    }
+
+    // no copy/move semantics
+    seqlock_cell(seqlock_cell const &) = delete;
+    auto
+    operator=(seqlock_cell const &) = delete;
+
+    [[nodiscard]] auto
+    load() const noexcept -> T
+    {
+        while (true)
+        {
+            auto const seq = m_seq.load(std::memory_order_acquire);
+            if (seq & 1) continue; // a write is in progress
+
+            auto const value = read_words();
+            // the words must be read before the counter is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == seq)
+            {
+                return from_words(value);
+            }
+        }
+    }
+
+    void
+    store(T const & value) noexcept
+    {
+        auto const seq = begin_write();
+        write_words(to_words(value));
+        end_write(seq);
+    }
+
+    // Applies fn to the current value and stores the result within a single
+    // write, e.g. to increment a counter. With single_writer_policy, this is
+    // only atomic with respect to readers.
+    template <std::invocable<T&> F>
+    void
+    modify(F&& fn) noexcept(std::is_nothrow_invocable_v<F, T&>)
+    {
+        auto const seq = begin_write();
+        // no other writer, the words cannot change while we read them
+        auto value = from_words(read_words());
+        try
+        {
+            std::invoke(std::forward<F>(fn), value);
+        }
+        catch (...)
+        {
+            // nothing is written, give the counter back unchanged
+            m_seq.store(seq, std::memory_order_release);
+            throw;
+        }
+        write_words(to_words(value));
+        end_write(seq);
+    }
+
+private:
+    std::atomic<std::uint64_t>               m_seq;
+    std::array<std::atomic<word>, num_words> m_words;
+
+    // returns the (even) counter before the write
+    auto
+    begin_write() noexcept -> std::uint64_t
+    {
+        auto seq = m_seq.load(std::memory_order_relaxed);
+        if constexpr (std::same_as<Policy, multi_writer_policy>)
+        {
+            // acquire: the words written by the previous writer happen
+            // before ours
+            while ((seq & 1)
+                   || !m_seq.compare_exchange_weak(
+                       seq,
+                       seq + 1,
+                       std::memory_order_acquire,
+                       std::memory_order_relaxed
+                   ))
+            {
+                seq = m_seq.load(std::memory_order_relaxed);
+            }
+        }
+        else { m_seq.store(seq + 1, std::memory_order_relaxed); }
+        // the odd counter must be visible before any of the words
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    void
+    end_write(std::uint64_t seq) noexcept
+    {
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    auto
+    read_words() const noexcept -> words
+    {
+        words value;
+        for (std::size_t i = 0; i < num_words; ++i)
+        {
+            value[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    void
+    write_words(words const & value) noexcept
+    {
+        for (std::size_t i = 0; i < num_words; ++i)
+        {
+            m_words[i].store(value[i], std::memory_order_relaxed);
+        }
+    }
+
+    static auto
+    to_words(T const & value) noexcept -> words
+    {
+        words result{};
+        std::memcpy(result.data(), std::addressof(value), sizeof(T));
+        return result;
+    }
+
+    static auto
+    from_words(words const & value) noexcept -> T
+    {
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), value.data(), sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+};
+
+} // namespace tinystd
@@ -0,0 +1,467 @@
+export module tinystd:simd_algorithms;
+
+import std;
+import :cpu_features;
+
+namespace tinystd
+{
+
+// element types of the vectorized algorithms, the types a vector_size
+// vector can hold with a lane of sizeof(T) bytes: no bool, long double or
+// 128-bit integers
+template <typename T>
+concept simd_element =
+    (std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 8)
+    || std::same_as<T, float> || std::same_as<T, double>;
+
+// contiguous ranges of them: vector, small_vector, inplace_vector, span, ...
+template <typename R>
+concept simd_range = std::ranges::contiguous_range<R>
+                  && std::ranges::sized_range<R>
+                  && simd_element<std::ranges::range_value_t<R>>;
+
+// integers are summed in 64 bits, floating point numbers in their own type
+template <typename T>
+using sum_t = std::conditional_t<
+    std::is_floating_point_v<T>,
+    T,
+    std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+// `Bytes / sizeof(T)` lanes of T, one register of the target
+template <typename T, std::size_t Bytes>
+using simd_vec = T __attribute__((vector_size(Bytes)));
+
+// lane type of a comparison result: all bits set where it holds
+template <typename T>
+using simd_mask_lane = std::conditional_t<
+    sizeof(T) == 1,
+    std::int8_t,
+    std::conditional_t<
+        sizeof(T) == 2,
+        std::int16_t,
+        std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>>>;
+
+// Kernels of the simd algorithms over `n` elements at `p`: AVX-512 or AVX2
+// versions when the CPU has them, scalar loops otherwise.
+// - The vector kernels are written once with clang vector extensions for a
+//   register width and inlined into functions compiled for the target
+//   (`[[gnu::target(...)]]`), which get only pointers and scalars, no vector
+//   crosses a call between code for different targets.
+// - The ends of the arrays that do not fill a register are done by the
+//   scalar loops.
+class simd_kernels
+{
+public:
+    // index of the first element equal to `value`, `n` if there is none
+    template <typename T>
+    [[nodiscard]] static auto
+    find(T const * p, std::size_t n, T value) -> std::size_t
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx512()) return find_avx512(p, n, value);
+        if (cpu_has_avx2()) return find_avx2(p, n, value);
+#endif
+        return find_scalar(p, 0, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    count(T const * p, std::size_t n, T value) -> std::size_t
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx512()) return count_avx512(p, n, value);
+        if (cpu_has_avx2()) return count_avx2(p, n, value);
+#endif
+        return count_scalar(p, 0, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    sum(T const * p, std::size_t n) -> sum_t<T>
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx512()) return sum_avx512(p, n);
+        if (cpu_has_avx2()) return sum_avx2(p, n);
+#endif
+        return sum_scalar(p, 0, n, sum_t<T>{});
+    }
+
+    // the smallest (or largest, if `Max`) element, `n` must not be 0
+    template <bool Max, typename T>
+    [[nodiscard]] static auto
+    extremum(T const * p, std::size_t n) -> T
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx512()) return extremum_avx512<Max>(p, n);
+        if (cpu_has_avx2()) return extremum_avx2<Max>(p, n);
+#endif
+        return extremum_scalar<Max>(p, 1, n, p[0]);
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    equal(T const * lhs, T const * rhs, std::size_t n) -> bool
+    {
+#if defined(__x86_64__)
+        if (cpu_has_avx512()) return equal_avx512(lhs, rhs, n);
+        if (cpu_has_avx2()) return equal_avx2(lhs, rhs, n);
+#endif
+        return equal_scalar(lhs, rhs, 0, n);
+    }
+
+private:
+    // scalar loops over [first, n)
+    template <typename T>
+    [[nodiscard]] static auto
+    find_scalar(T const * p, std::size_t first, std::size_t n, T value)
+        -> std::size_t
+    {
+        while (first < n && p[first] != value) ++first;
+        return first;
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    count_scalar(T const * p, std::size_t first, std::size_t n, T value)
+        -> std::size_t
+    {
+        std::size_t count = 0;
+        for (; first < n; ++first) count += p[first] == value;
+        return count;
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    sum_scalar(T const * p, std::size_t first, std::size_t n, sum_t<T> total)
+        -> sum_t<T>
+    {
+        for (; first < n; ++first) total += p[first];
+        return total;
+    }
+
+    template <bool Max, typename T>
+    [[nodiscard]] static auto
+    extremum_scalar(T const * p, std::size_t first, std::size_t n, T best)
+        -> T
+    {
+        for (; first < n; ++first)
+        {
+            best = Max ? std::max(best, p[first]) : std::min(best, p[first]);
+        }
+        return best;
+    }
+
+    template <typename T>
+    [[nodiscard]] static auto
+    equal_scalar(
+        T const * lhs, T const * rhs, std::size_t first, std::size_t n
+    ) -> bool
+    {
+        while (first < n && lhs[first] == rhs[first]) ++first;
+        return first == n;
+    }
+
+    // vector kernels for `Bytes` wide registers; always inlined, so they are
+    // compiled for the target of their caller
+    template <std::size_t Bytes, typename T>
+    [[nodiscard, gnu::always_inline]] static auto
+    find_n(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        using vec  = simd_vec<T, Bytes>;
+        using mask = simd_vec<simd_mask_lane<T>, Bytes>;
+
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+
+        vec wanted{};
+        for (std::size_t l = 0; l < lanes; ++l) wanted[l] = value;
+
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            vec v;
+            std::memcpy(&v, p + i, Bytes);
+            // stop at the first register with a match, the scalar loop finds
+            // its lane
+            if (__builtin_reduce_or(__builtin_bit_cast(mask, v == wanted)))
+            {
+                break;
+            }
+        }
+        return find_scalar(p, i, n, value);
+    }
+
+    template <std::size_t Bytes, typename T>
+    [[nodiscard, gnu::always_inline]] static auto
+    count_n(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        using vec  = simd_vec<T, Bytes>;
+        using lane = simd_mask_lane<T>;
+        using mask = simd_vec<lane, Bytes>;
+
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+
+        vec wanted{};
+        for (std::size_t l = 0; l < lanes; ++l) wanted[l] = value;
+
+        // every lane counts its matches (a match is -1), and is added to the
+        // total before it can overflow, after 127 steps for 8-bit lanes
+        constexpr std::size_t max_steps = std::numeric_limits<lane>::max();
+
+        std::size_t count = 0;
+        std::size_t i     = 0;
+        while (i + lanes <= n)
+        {
+            std::size_t const steps = std::min((n - i) / lanes, max_steps);
+            mask              acc{};
+            for (std::size_t step = 0; step < steps; ++step, i += lanes)
+            {
+                vec v;
+                std::memcpy(&v, p + i, Bytes);
+                acc -= __builtin_bit_cast(mask, v == wanted);
+            }
+            for (std::size_t l = 0; l < lanes; ++l) count += acc[l];
+        }
+        return count + count_scalar(p, i, n, value);
+    }
+
+    template <std::size_t Bytes, typename T>
+    [[nodiscard, gnu::always_inline]] static auto
+    sum_n(T const * p, std::size_t n) -> sum_t<T>
+    {
+        // narrow elements are widened to the sum type lane by lane, so a
+        // register holds fewer of them
+        constexpr std::size_t lanes = Bytes / sizeof(sum_t<T>);
+
+        using total_t = sum_t<T>;
+        using wide    = simd_vec<total_t, Bytes>;
+        using narrow  = simd_vec<T, lanes * sizeof(T)>;
+
+        // independent accumulators, to not wait for the latency of an add
+        wide        acc0{};
+        wide        acc1{};
+        std::size_t i = 0;
+        for (; i + 2 * lanes <= n; i += 2 * lanes)
+        {
+            narrow v0;
+            narrow v1;
+            std::memcpy(&v0, p + i, sizeof(narrow));
+            std::memcpy(&v1, p + i + lanes, sizeof(narrow));
+            acc0 += __builtin_convertvector(v0, wide);
+            acc1 += __builtin_convertvector(v1, wide);
+        }
+        acc0 += acc1;
+
+        total_t total{};
+        for (std::size_t l = 0; l < lanes; ++l) total += acc0[l];
+        return sum_scalar(p, i, n, total);
+    }
+
+    template <bool Max, std::size_t Bytes, typename T>
+    [[nodiscard, gnu::always_inline]] static auto
+    extremum_n(T const * p, std::size_t n) -> T
+    {
+        using vec = simd_vec<T, Bytes>;
+
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        if (n < lanes) return extremum_scalar<Max>(p, 1, n, p[0]);
+
+        vec best;
+        std::memcpy(&best, p, Bytes);
+        std::size_t i = lanes;
+        for (; i + lanes <= n; i += lanes)
+        {
+            vec v;
+            std::memcpy(&v, p + i, Bytes);
+            if constexpr (Max) { best = __builtin_elementwise_max(best, v); }
+            else { best = __builtin_elementwise_min(best, v); }
+        }
+
+        T result;
+        if constexpr (Max) { result = __builtin_reduce_max(best); }
+        else { result = __builtin_reduce_min(best); }
+        return extremum_scalar<Max>(p, i, n, result);
+    }
+
+    template <std::size_t Bytes, typename T>
+    [[nodiscard, gnu::always_inline]] static auto
+    equal_n(T const * lhs, T const * rhs, std::size_t n) -> bool
+    {
+        using vec  = simd_vec<T, Bytes>;
+        using mask = simd_vec<simd_mask_lane<T>, Bytes>;
+
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            vec l;
+            vec r;
+            std::memcpy(&l, lhs + i, Bytes);
+            std::memcpy(&r, rhs + i, Bytes);
+            if (__builtin_reduce_or(__builtin_bit_cast(mask, l != r)))
+            {
+                return false;
+            }
+        }
+        return equal_scalar(lhs, rhs, i, n);
+    }
+
+#if defined(__x86_64__)
+    template <typename T>
+    [[nodiscard, gnu::target("avx2")]] static auto
+    find_avx2(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        return find_n<32>(p, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx512f,avx512bw")]] static auto
+    find_avx512(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        return find_n<64>(p, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx2")]] static auto
+    count_avx2(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        return count_n<32>(p, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx512f,avx512bw")]] static auto
+    count_avx512(T const * p, std::size_t n, T value) -> std::size_t
+    {
+        return count_n<64>(p, n, value);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx2")]] static auto
+    sum_avx2(T const * p, std::size_t n) -> sum_t<T>
+    {
+        return sum_n<32>(p, n);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx512f,avx512bw")]] static auto
+    sum_avx512(T const * p, std::size_t n) -> sum_t<T>
+    {
+        return sum_n<64>(p, n);
+    }
+
+    template <bool Max, typename T>
+    [[nodiscard, gnu::target("avx2")]] static auto
+    extremum_avx2(T const * p, std::size_t n) -> T
+    {
+        return extremum_n<Max, 32>(p, n);
+    }
+
+    template <bool Max, typename T>
+    [[nodiscard, gnu::target("avx512f,avx512bw")]] static auto
+    extremum_avx512(T const * p, std::size_t n) -> T
+    {
+        return extremum_n<Max, 64>(p, n);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx2")]] static auto
+    equal_avx2(T const * lhs, T const * rhs, std::size_t n) -> bool
+    {
+        return equal_n<32>(lhs, rhs, n);
+    }
+
+    template <typename T>
+    [[nodiscard, gnu::target("avx512f,avx512bw")]] static auto
+    equal_avx512(T const * lhs, T const * rhs, std::size_t n) -> bool
+    {
+        return equal_n<64>(lhs, rhs, n);
+    }
+#endif
+};
+
+// Vectorized versions of the std::ranges algorithms for contiguous ranges of
+// arithmetic types, e.g. `simd::count(v, 0)` for a `tinystd::vector<int>`.
+// Results are those of the std algorithms, except that floating point sums
+// are added in a different order; min/max of ranges with NaNs are
+// unspecified.
+namespace simd
+{
+
+export template <typename R>
+    requires simd_range<R>
+[[nodiscard]] auto
+find(R&& range, std::ranges::range_value_t<R> const & value)
+    -> std::ranges::borrowed_iterator_t<R>
+{
+    std::size_t const i = simd_kernels::find(
+        std::ranges::cdata(range), std::ranges::size(range), value
+    );
+    if constexpr (std::ranges::borrowed_range<R>)
+    {
+        return std::ranges::begin(range) + i;
+    }
+    else { return std::ranges::dangling{}; }
+}
+
+export template <typename R>
+    requires simd_range<R>
+[[nodiscard]] auto
+count(R const & range, std::ranges::range_value_t<R> const & value)
+    -> std::ranges::range_difference_t<R>
+{
+    return simd_kernels::count(
+        std::ranges::cdata(range), std::ranges::size(range), value
+    );
+}
+
+// integers are added in 64 bits, so 8- to 32-bit elements do not overflow
+export template <typename R>
+    requires simd_range<R>
+[[nodiscard]] auto
+sum(R const & range) -> sum_t<std::ranges::range_value_t<R>>
+{
+    return simd_kernels::sum(
+        std::ranges::cdata(range), std::ranges::size(range)
+    );
+}
+
+// the range must not be empty, as for std::ranges::min
+export template <typename R>
+    requires simd_range<R>
+[[nodiscard]] auto
+min(R const & range) -> std::ranges::range_value_t<R>
+{
+    return simd_kernels::extremum<false>(
+        std::ranges::cdata(range), std::ranges::size(range)
+    );
+}
+
+// the range must not be empty, as for std::ranges::max
+export template <typename R>
+    requires simd_range<R>
+[[nodiscard]] auto
+max(R const & range) -> std::ranges::range_value_t<R>
+{
+    return simd_kernels::extremum<true>(
+        std::ranges::cdata(range), std::ranges::size(range)
+    );
+}
+
+export template <typename R1, typename R2>
+    requires simd_range<R1> && simd_range<R2>
+          && std::same_as<
+                 std::ranges::range_value_t<R1>,
+                 std::ranges::range_value_t<R2>>
+[[nodiscard]] auto
+equal(R1 const & lhs, R2 const & rhs) -> bool
+{
+    std::size_t const n = std::ranges::size(lhs);
+    return n == std::ranges::size(rhs)
+        && simd_kernels::equal(
+               std::ranges::cdata(lhs), std::ranges::cdata(rhs), n
+        );
+}
+
+} // namespace simd
+
+} // namespace tinystd
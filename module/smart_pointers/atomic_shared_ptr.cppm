@@ -9,9 +9,128 @@ import :hazard_pointer;
 namespace tinystd
 {
 
+// Policies of atomic_shared_ptr to protect the control block in load:
+// - hazard_pointer_policy: protect the control block with a hazard pointer
+//   and increment its shared count if it is not zero
+// - snapshot_policy: as hazard_pointer_policy, and additionally supports
+//   load_snapshot(). The shared count owned by the atomic_shared_ptr is
+//   released through the hazard pointer retired list when the control block
+//   is replaced, so the old object is destroyed at a later hazard pointer
+//   scan rather than immediately.
+// - split_count_policy: split reference counting, borrow one of the shared
+//   counts reserved by the atomic_shared_ptr by incrementing a local count
+//   packed in the spare high bits of the pointer word
+export struct hazard_pointer_policy
+{
+};
+
+export struct snapshot_policy
+{
+};
+
+export struct split_count_policy
+{
+};
+
+// Scoped, move-only read access to the object stored in an
+// atomic_shared_ptr<T, snapshot_policy>, see load_snapshot(). The object is
+// kept alive by the hazard pointer of the snapshot instead of a shared count.
+//
+// A snapshot occupies the second hazard pointer of the calling thread for
+// control blocks, loads of atomic_shared_ptr and atomic_weak_ptr use the
+// first one and can go on while it is alive. There is one such hazard
+// pointer per thread, so a thread holds one snapshot at a time; replacing
+// it (`snap = asp.load_snapshot();`) is fine. It must be destroyed on the
+// thread that created it.
 export template <non_array T>
+class snapshot_ptr
+{
+public:
+    using element_type = T;
+
+    snapshot_ptr() noexcept : m_ptr{nullptr}, m_cb{nullptr} {}
+    snapshot_ptr(snapshot_ptr&& other) noexcept
+        : m_hp{std::move(other.m_hp)}
+        , m_ptr{std::exchange(other.m_ptr, nullptr)}
+        , m_cb{std::exchange(other.m_cb, nullptr)}
+    {
+    }
+    snapshot_ptr(snapshot_ptr const &) = delete;
+
+    ~snapshot_ptr() noexcept = default;
+
+    auto
+    operator=(snapshot_ptr&& other) noexcept -> snapshot_ptr&
+    {
+        if (this != &other)
+        {
+            m_hp  = std::move(other.m_hp);
+            m_ptr = std::exchange(other.m_ptr, nullptr);
+            m_cb  = std::exchange(other.m_cb, nullptr);
+        }
+        return *this;
+    }
+    auto
+    operator=(snapshot_ptr const &) = delete;
+
+    // Takes a shared count, the result stays valid after the snapshot is
+    // destroyed.
+    [[nodiscard]] auto
+    to_shared() const noexcept -> shared_ptr<T>
+    {
+        if (m_cb == nullptr) return shared_ptr<T>();
+        // the atomic_shared_ptr's own count cannot be released while m_cb is
+        // protected, so the shared count is not zero
+        m_cb->increment_shared();
+        return shared_ptr<T>(m_ptr, m_cb);
+    }
+
+    operator shared_ptr<T>() const noexcept { return to_shared(); }
+
+    [[nodiscard]] auto
+    get() const noexcept -> T*
+    {
+        return m_ptr;
+    }
+
+    [[nodiscard]] auto
+    operator*() const noexcept -> T&
+    {
+        return *m_ptr;
+    }
+
+    [[nodiscard]] auto
+    operator->() const noexcept -> T*
+    {
+        return m_ptr;
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return m_cb; }
+
+private:
+    hazard_pointer<control_block> m_hp;
+    T*                            m_ptr;
+    control_block*                m_cb;
+
+    snapshot_ptr(hazard_pointer<control_block>&& hp, control_block* cb) noexcept
+        : m_hp{std::move(hp)}
+        , m_ptr{cb ? static_cast<T*>(cb->get_ptr()) : nullptr}
+        , m_cb{cb}
+    {
+    }
+
+    template <non_array U, typename Policy>
+    friend class atomic_shared_ptr;
+};
+
+export template <non_array T, typename Policy = hazard_pointer_policy>
 class atomic_shared_ptr
 {
+    static_assert(
+        std::same_as<Policy, hazard_pointer_policy>
+        || std::same_as<Policy, snapshot_policy>
+    );
+
 public:
     constexpr static bool is_always_lock_free =
         std::atomic<void*>::is_always_lock_free;
@@ -57,6 +176,19 @@ public:
         return make_shared_from_cb(cb);
     }
 
+    // Borrows the stored object without touching its counts: the control
+    // block stays protected by the hazard pointer of the snapshot, and the
+    // shared count owned by *this is only released after the protection is
+    // reset (see snapshot_policy).
+    [[nodiscard]] auto
+    load_snapshot() const noexcept -> snapshot_ptr<T>
+        requires std::same_as<Policy, snapshot_policy>
+    {
+        auto hp = make_hazard_pointer<control_block>(snapshot_hazard_index);
+        auto cb = hp.protect(m_cb);
+        return snapshot_ptr<T>(std::move(hp), cb);
+    }
+
     void
     store(
         shared_ptr<T>     desired,
@@ -66,7 +198,7 @@ public:
         desired.m_ptr = nullptr;
         auto new_cb   = std::exchange(desired.m_cb, nullptr);
         auto old_cb   = m_cb.exchange(new_cb, order);
-        if (old_cb) old_cb->decrement_shared();
+        if (old_cb) release_installed(old_cb);
     }
 
     auto
@@ -78,6 +210,13 @@ public:
         desired.m_ptr = nullptr;
         auto new_cb   = std::exchange(desired.m_cb, nullptr);
         auto old_cb   = m_cb.exchange(new_cb, order);
+        if (deferred_release && old_cb)
+        {
+            // the returned shared_ptr gets its own count, as a snapshot might
+            // still borrow the count of *this
+            old_cb->increment_shared();
+            release_installed(old_cb);
+        }
         return make_shared_from_cb(old_cb);
     }
 
@@ -102,7 +241,7 @@ public:
         {
             desired.m_ptr = nullptr;
             desired.m_cb  = nullptr;
-            if (expected_cb) expected_cb->decrement_shared();
+            if (expected_cb) release_installed(expected_cb);
             return true;
         }
         else
@@ -165,9 +304,360 @@ public:
         );
     }
 
+    // Blocks until *this no longer holds the control block of old, wakes up
+    // only when notify_one/notify_all is called.
+    void
+    wait(
+        shared_ptr<T>     old,
+        std::memory_order order = std::memory_order_seq_cst
+    ) const noexcept
+    {
+        m_waiters.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in notify_*: either the notifier sees the
+        // waiter, or the waiter sees the new control block.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_cb.wait(old.m_cb, order);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // skip the futex wake-up if nobody is waiting
+    void
+    notify_one() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0) m_cb.notify_one();
+    }
+
+    void
+    notify_all() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0) m_cb.notify_all();
+    }
+
 private:
+    constexpr static bool deferred_release =
+        std::same_as<Policy, snapshot_policy>;
+
+    // hazard pointer index of snapshots, load() uses index 0
+    constexpr static std::size_t snapshot_hazard_index = 1;
+
     std::atomic<control_block*> m_cb;
 
+    // number of threads blocked in wait()
+    mutable std::atomic<std::uint32_t> m_waiters{0};
+
+    // releases the shared count owned by *this of a replaced control block
+    static void
+    release_installed(control_block* cb) noexcept
+    {
+        if constexpr (deferred_release)
+        {
+            hazard_pointer<control_block>::retire(
+                cb,
+                [](control_block* block) noexcept { block->decrement_shared(); }
+            );
+        }
+        else { cb->decrement_shared(); }
+    }
+
+    static auto
+    make_shared_from_cb(control_block* cb) noexcept -> shared_ptr<T>
+    {
+        if (cb == nullptr) return shared_ptr<T>();
+        return shared_ptr<T>(static_cast<T*>(cb->get_ptr()), cb);
+    }
+};
+
+// Split reference counting, as folly::atomic_shared_ptr:
+// - m_packed holds the control block pointer in the low 48 bits and a local
+//   count in the high 16 bits (user-space pointers on x86-64 and AArch64 only
+//   use the low 48 bits)
+// - While a control block is installed, the atomic_shared_ptr owns `reserved`
+//   shared counts of it, the local count is the number of them that are
+//   handed out by load.
+// - load is a single CAS incrementing the local count, the returned
+//   shared_ptr takes one of the reserved counts. There is neither hazard
+//   pointer nor RMW on the control block.
+// - When the local count reaches refill_threshold, the loader adds
+//   refill_threshold counts to the control block and subtracts them from the
+//   local count.
+// - store/exchange/compare_exchange gives back the counts of the old control
+//   block that are reserved but not handed out.
+template <non_array T>
+class atomic_shared_ptr<T, split_count_policy>
+{
+    using count_type = control_block::count_type;
+
+    static_assert(sizeof(control_block*) == sizeof(std::uint64_t));
+
+    constexpr static std::uint64_t ptr_mask  = (std::uint64_t{1} << 48) - 1;
+    constexpr static std::uint64_t local_one = ptr_mask + 1;
+
+    constexpr static count_type max_local        = 0xFFFF;
+    constexpr static count_type reserved         = max_local + 1;
+    constexpr static count_type refill_threshold = reserved / 2;
+
+public:
+    constexpr static bool is_always_lock_free =
+        std::atomic<std::uint64_t>::is_always_lock_free;
+
+    // Constructors
+    atomic_shared_ptr() noexcept : m_packed{0} {}
+    atomic_shared_ptr(shared_ptr<T> desired) noexcept
+        : m_packed{install(std::move(desired))}
+    {
+    }
+    atomic_shared_ptr(atomic_shared_ptr const &) = delete;
+
+    ~atomic_shared_ptr() noexcept { store(nullptr); }
+
+    // Assignments
+    void
+    operator=(shared_ptr<T> desired)
+    {
+        store(std::move(desired));
+    }
+    auto
+    operator=(atomic_shared_ptr const &) = delete;
+
+    [[nodiscard("no side effect")]] auto
+    is_lock_free() const noexcept -> bool
+    {
+        return m_packed.is_lock_free();
+    }
+
+    // memory_order does not matter for load operation
+    auto
+    load([[maybe_unused]] std::memory_order order = std::memory_order_seq_cst)
+        const noexcept -> shared_ptr<T>
+    {
+        auto packed = m_packed.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if (get_cb(packed) == nullptr) return shared_ptr<T>();
+            if (get_local(packed) == max_local)
+            {
+                // all reserved counts are handed out, wait for the refill
+                std::this_thread::yield();
+                packed = m_packed.load(std::memory_order_relaxed);
+            }
+            else if (m_packed.compare_exchange_weak(
+                         packed,
+                         packed + local_one,
+                         std::memory_order_acquire,
+                         std::memory_order_relaxed
+                     ))
+            {
+                break;
+            }
+        }
+
+        // we own one count of cb from here on, so it stays alive
+        auto cb = get_cb(packed);
+        if (get_local(packed) + 1 == refill_threshold) refill(cb);
+        return make_shared_from_cb(cb);
+    }
+
+    void
+    store(
+        shared_ptr<T>     desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept
+    {
+        release_unused(m_packed.exchange(install(std::move(desired)), order));
+    }
+
+    auto
+    exchange(
+        shared_ptr<T>     desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> shared_ptr<T>
+    {
+        auto old_packed =
+            m_packed.exchange(install(std::move(desired)), order);
+        // keep one of the unused counts for the returned shared_ptr
+        release_unused(old_packed, 1);
+        return make_shared_from_cb(get_cb(old_packed));
+    }
+
+    // never fails spuriously
+    [[nodiscard("might have ABA")]] auto
+    compare_exchange_weak(
+        shared_ptr<T>&    expected,
+        shared_ptr<T>&&   desired,
+        std::memory_order success,
+        std::memory_order failure
+    ) noexcept -> bool
+    {
+        return compare_exchange_strong(
+            expected, std::move(desired), success, failure
+        );
+    }
+
+    auto
+    compare_exchange_strong(
+        shared_ptr<T>&    expected,
+        shared_ptr<T>&&   desired,
+        std::memory_order success,
+        std::memory_order failure
+    ) noexcept -> bool
+    {
+        // Reserve the counts up-front, desired still owns its own count and
+        // keeps cb alive if the reservation is undone.
+        auto desired_cb = desired.m_cb;
+        if (desired_cb) desired_cb->increment_shared(reserved - 1);
+
+        auto packed = m_packed.load(std::memory_order_relaxed);
+        // a change of the local count alone is not a failure
+        while (get_cb(packed) == expected.m_cb)
+        {
+            if (m_packed.compare_exchange_weak(
+                    packed,
+                    reinterpret_cast<std::uintptr_t>(desired_cb),
+                    success,
+                    failure
+                ))
+            {
+                // desired's own count is the last reserved count
+                desired.m_ptr = nullptr;
+                desired.m_cb  = nullptr;
+                release_unused(packed);
+                return true;
+            }
+        }
+
+        // if failed, desired won't be moved from and will stay the same.
+        if (desired_cb) desired_cb->decrement_shared(reserved - 1);
+        expected = load();
+        return false;
+    }
+
+    [[nodiscard("might have spurious failure")]] auto
+    compare_exchange_weak(
+        shared_ptr<T>&    expected,
+        shared_ptr<T>&&   desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> bool
+    {
+        return compare_exchange_weak(
+            expected, std::move(desired), order, order
+        );
+    }
+
+    auto
+    compare_exchange_strong(
+        shared_ptr<T>&    expected,
+        shared_ptr<T>&&   desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> bool
+    {
+        return compare_exchange_strong(
+            expected, std::move(desired), order, order
+        );
+    }
+
+    // see atomic_shared_ptr<T, hazard_pointer_policy>::wait, a change of the
+    // local count alone wakes the waiter up but does not return
+    void
+    wait(
+        shared_ptr<T>     old,
+        std::memory_order order = std::memory_order_seq_cst
+    ) const noexcept
+    {
+        m_waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto packed = m_packed.load(order);
+        while (get_cb(packed) == old.m_cb)
+        {
+            m_packed.wait(packed, order);
+            packed = m_packed.load(order);
+        }
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void
+    notify_one() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0)
+        {
+            m_packed.notify_one();
+        }
+    }
+
+    void
+    notify_all() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0)
+        {
+            m_packed.notify_all();
+        }
+    }
+
+private:
+    mutable std::atomic<std::uint64_t> m_packed;
+
+    // number of threads blocked in wait()
+    mutable std::atomic<std::uint32_t> m_waiters{0};
+
+    [[nodiscard]] static auto
+    get_cb(std::uint64_t packed) noexcept -> control_block*
+    {
+        return reinterpret_cast<control_block*>(packed & ptr_mask);
+    }
+
+    [[nodiscard]] static auto
+    get_local(std::uint64_t packed) noexcept -> count_type
+    {
+        return static_cast<count_type>(packed >> 48);
+    }
+
+    // takes over the count of desired and reserves the rest
+    [[nodiscard]] static auto
+    install(shared_ptr<T>&& desired) noexcept -> std::uint64_t
+    {
+        desired.m_ptr = nullptr;
+        auto cb       = std::exchange(desired.m_cb, nullptr);
+        if (cb) cb->increment_shared(reserved - 1);
+        return reinterpret_cast<std::uintptr_t>(cb);
+    }
+
+    // gives back the counts of an uninstalled control block that are
+    // reserved but not handed out, except `keep` of them
+    static void
+    release_unused(std::uint64_t packed, count_type keep = 0) noexcept
+    {
+        auto const cb = get_cb(packed);
+        if (cb == nullptr) return;
+        auto const unused = reserved - get_local(packed) - keep;
+        if (unused != 0) cb->decrement_shared(unused);
+    }
+
+    // Local counts are fungible among installations of the same control
+    // block, so it does not matter if cb is uninstalled and installed again
+    // in the meantime. If cb is uninstalled, release_unused already accounts
+    // for the counts handed out, undo the refill.
+    void
+    refill(control_block* cb) const noexcept
+    {
+        cb->increment_shared(refill_threshold);
+        auto packed = m_packed.load(std::memory_order_relaxed);
+        while (get_cb(packed) == cb && get_local(packed) >= refill_threshold)
+        {
+            if (m_packed.compare_exchange_weak(
+                    packed,
+                    packed - refill_threshold * local_one,
+                    std::memory_order_relaxed
+                ))
+            {
+                return;
+            }
+        }
+        cb->decrement_shared(refill_threshold);
+    }
+
     static auto
     make_shared_from_cb(control_block* cb) noexcept -> shared_ptr<T>
     {
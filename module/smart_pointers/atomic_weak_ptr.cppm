@@ -0,0 +1,193 @@
+export module tinystd:atomic_weak_ptr;
+
+import std;
+import :unique_ptr;
+import :control_block;
+import :shared_ptr;
+import :weak_ptr;
+import :hazard_pointer;
+
+namespace tinystd
+{
+
+// Same design as atomic_shared_ptr<T, hazard_pointer_policy>, the control
+// block is protected by hazard pointer and the weak count is incremented
+// only if it is not zero.
+export template <non_array T>
+class atomic_weak_ptr
+{
+public:
+    constexpr static bool is_always_lock_free =
+        std::atomic<void*>::is_always_lock_free;
+
+    // Constructors
+    atomic_weak_ptr() noexcept : m_cb{nullptr} {}
+    atomic_weak_ptr(weak_ptr<T> desired) noexcept : m_cb{desired.m_cb}
+    {
+        desired.m_cb  = nullptr;
+        desired.m_ptr = nullptr;
+    }
+    atomic_weak_ptr(atomic_weak_ptr const &) = delete;
+
+    ~atomic_weak_ptr() noexcept { store(weak_ptr<T>()); }
+
+    // Assignments
+    void
+    operator=(weak_ptr<T> desired)
+    {
+        store(std::move(desired));
+    }
+    auto
+    operator=(atomic_weak_ptr const &) = delete;
+
+    [[nodiscard("no side effect")]] auto
+    is_lock_free() const noexcept -> bool
+    {
+        return m_cb.is_lock_free();
+    }
+
+    // memory_order does not matter for load operation
+    auto
+    load([[maybe_unused]] std::memory_order order = std::memory_order_seq_cst)
+        const noexcept -> weak_ptr<T>
+    {
+        auto hp = make_hazard_pointer<control_block>();
+        auto cb = hp.protect(m_cb);
+        while (cb && !cb->increment_weak_if_not_zero())
+        {
+            // a store happens after we load m_cb, need to reload
+            cb = hp.protect(m_cb);
+        }
+        return make_weak_from_cb(cb);
+    }
+
+    // Equivalent to load().lock(), but the control block is only protected
+    // once and the weak count is not touched.
+    auto
+    load_and_lock(
+        [[maybe_unused]] std::memory_order order = std::memory_order_seq_cst
+    ) const noexcept -> shared_ptr<T>
+    {
+        auto hp = make_hazard_pointer<control_block>();
+        auto cb = hp.protect(m_cb);
+        // The hazard pointer keeps the control block alive, the object is
+        // expired if the shared count is zero, no matter whether cb is still
+        // stored in *this.
+        if (cb && cb->increment_shared_if_not_zero())
+        {
+            return shared_ptr<T>(static_cast<T*>(cb->get_ptr()), cb);
+        }
+        return shared_ptr<T>();
+    }
+
+    void
+    store(
+        weak_ptr<T>       desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept
+    {
+        desired.m_ptr = nullptr;
+        auto new_cb   = std::exchange(desired.m_cb, nullptr);
+        auto old_cb   = m_cb.exchange(new_cb, order);
+        if (old_cb) old_cb->decrement_weak();
+    }
+
+    auto
+    exchange(
+        weak_ptr<T>       desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> weak_ptr<T>
+    {
+        desired.m_ptr = nullptr;
+        auto new_cb   = std::exchange(desired.m_cb, nullptr);
+        auto old_cb   = m_cb.exchange(new_cb, order);
+        return make_weak_from_cb(old_cb);
+    }
+
+    // weak_ptrs are compared by their control blocks (owner-based)
+    [[nodiscard("might have ABA")]] auto
+    compare_exchange_weak(
+        weak_ptr<T>&      expected,
+        weak_ptr<T>&&     desired,
+        std::memory_order success,
+        std::memory_order failure
+    ) noexcept -> bool
+    {
+        // see atomic_shared_ptr::compare_exchange_weak, m_cb cannot be
+        // dereferenced before it is protected
+        auto expected_cb = expected.m_cb;
+        if (m_cb.compare_exchange_strong(
+                expected_cb, desired.m_cb, success, failure
+            ))
+        {
+            desired.m_ptr = nullptr;
+            desired.m_cb  = nullptr;
+            if (expected_cb) expected_cb->decrement_weak();
+            return true;
+        }
+        else
+        {
+            // if failed, desired won't be moved from and will stay the same.
+            expected = load();
+            return false;
+        }
+    }
+
+    auto
+    compare_exchange_strong(
+        weak_ptr<T>&      expected,
+        weak_ptr<T>&&     desired,
+        std::memory_order success,
+        std::memory_order failure
+    ) noexcept -> bool
+    {
+        auto old_expected_cb = expected.m_cb;
+        do {
+            if (compare_exchange_weak(
+                    expected, std::move(desired), success, failure
+                ))
+            {
+                return true;
+            }
+        } while (old_expected_cb == expected.m_cb);
+        // Loops if expected stays the same instead of return false
+
+        return false;
+    }
+
+    [[nodiscard("might have spurious failure")]] auto
+    compare_exchange_weak(
+        weak_ptr<T>&      expected,
+        weak_ptr<T>&&     desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> bool
+    {
+        return compare_exchange_weak(
+            expected, std::move(desired), order, order
+        );
+    }
+
+    auto
+    compare_exchange_strong(
+        weak_ptr<T>&      expected,
+        weak_ptr<T>&&     desired,
+        std::memory_order order = std::memory_order_seq_cst
+    ) noexcept -> bool
+    {
+        return compare_exchange_strong(
+            expected, std::move(desired), order, order
+        );
+    }
+
+private:
+    std::atomic<control_block*> m_cb;
+
+    static auto
+    make_weak_from_cb(control_block* cb) noexcept -> weak_ptr<T>
+    {
+        if (cb == nullptr) return weak_ptr<T>();
+        return weak_ptr<T>(static_cast<T*>(cb->get_ptr()), cb);
+    }
+};
+
+} // namespace tinystd
@@ -7,133 +7,360 @@ export module tinystd:control_block;
 
 import std;
 import :manual_lifetime;
+import :size_class_cache;
 import :hazard_pointer;
 
 namespace tinystd
 {
 
+class control_block;
+
+// Per-type dispatch table shared by all control blocks of the same concrete
+// type, replaces the vtable so that a control block does not need a virtual
+// destructor.
+struct control_block_ops
+{
+    // destroy the managed object, called when shared count drops to 0
+    void (*delete_obj)(control_block*) noexcept;
+
+    // destroy the concrete control block and free its memory
+    void (*destroy)(control_block*) noexcept;
+
+    // Byte offset from the start of the control block to the managed object
+    // if obj_inline is true (make_shared), or to the stored pointer to the
+    // managed object otherwise.
+    std::ptrdiff_t obj_offset;
+    bool           obj_inline;
+};
+
 class control_block
 {
 public:
     using count_type = std::uint32_t;
 
-    control_block() noexcept : m_shared_count{1}, m_weak_count{1} {}
-    virtual ~control_block() noexcept = default;
+    explicit control_block(control_block_ops const * ops) noexcept
+        : m_ops{ops}
+        , m_counts{shared_one | weak_one}
+    {
+    }
+
+    // trivial and non-virtual, destruction of the concrete control block is
+    // done by control_block_ops::destroy
+    ~control_block() = default;
+
+    // Deleting a control_block (e.g. from the retired list of the hazard
+    // pointer) is dispatched to the concrete type without a vtable.
+    void
+    operator delete(control_block* cb, std::destroying_delete_t) noexcept
+    {
+        cb->m_ops->destroy(cb);
+    }
 
     void
-    increment_shared() noexcept
+    increment_shared(count_type n = 1) noexcept
     {
-        m_shared_count.fetch_add(1, std::memory_order_relaxed);
+        m_counts.fetch_add(n * shared_one, std::memory_order_relaxed);
     }
 
     void
     increment_weak() noexcept
     {
-        m_weak_count.fetch_add(1, std::memory_order_relaxed);
+        m_counts.fetch_add(weak_one, std::memory_order_relaxed);
     }
 
     // returns whether the increment succeeds
     bool
     increment_shared_if_not_zero() noexcept
     {
-        auto old_cnt = m_shared_count.load(std::memory_order_relaxed);
+        auto old_cnts = m_counts.load(std::memory_order_relaxed);
         do {
-            if (old_cnt == 0) return false;
-        } while (!m_shared_count.compare_exchange_weak(
-            old_cnt, old_cnt + 1, std::memory_order_relaxed
+            if ((old_cnts & shared_mask) == 0) return false;
+        } while (!m_counts.compare_exchange_weak(
+            old_cnts, old_cnts + shared_one, std::memory_order_relaxed
+        ));
+        return true;
+    }
+
+    // Returns whether the increment succeeds, used on a control block that
+    // is protected by a hazard pointer but might be released already.
+    bool
+    increment_weak_if_not_zero() noexcept
+    {
+        auto old_cnts = m_counts.load(std::memory_order_relaxed);
+        do {
+            if ((old_cnts & ~shared_mask) == 0) return false;
+        } while (!m_counts.compare_exchange_weak(
+            old_cnts, old_cnts + weak_one, std::memory_order_relaxed
         ));
         return true;
     }
 
     void
-    decrement_shared() noexcept
+    decrement_shared(count_type n = 1) noexcept
     {
-        if (m_shared_count.fetch_sub(1, std::memory_order_release) == 1)
+        // We are the last owner and there is no weak_ptr: both counts drop
+        // to 0 in a single RMW, after which no increment_*_if_not_zero on a
+        // protected control block can succeed anymore.
+        auto old_cnts = m_counts.load(std::memory_order_relaxed);
+        if (old_cnts == (n * shared_one | weak_one)
+            && m_counts.compare_exchange_strong(
+                old_cnts,
+                0,
+                std::memory_order_acquire,
+                std::memory_order_relaxed
+            ))
         {
-            std::atomic_thread_fence(std::memory_order_acquire);
             delete_obj();
-            decrement_weak();
+            retire();
+            return;
         }
+
+        old_cnts =
+            m_counts.fetch_sub(n * shared_one, std::memory_order_release);
+        if ((old_cnts & shared_mask) != n) return;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        delete_obj();
+        decrement_weak();
     }
 
     void
     decrement_weak() noexcept
     {
-        if (m_weak_count.fetch_sub(1, std::memory_order_relaxed) == 1)
+        if (m_counts.fetch_sub(weak_one, std::memory_order_release)
+            == weak_one)
         {
-            // We can make the hazard pointer non-intrusive here by increasing
-            // the weak_count when using hazard pointer and setting the custom
-            // deleter to decrement_weak(), but that involves additional
-            // atomic operations and might not worth the non-intrusive property.
-            hazard_pointer<control_block>::retire(this);
-            // ::delete this;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            retire();
         }
     }
 
     auto
     shared_count() const noexcept -> count_type
     {
-        return m_shared_count.load(std::memory_order_relaxed);
+        return static_cast<count_type>(
+            m_counts.load(std::memory_order_relaxed) & shared_mask
+        );
     }
 
-    virtual auto
-    get_ptr() noexcept -> void* = 0;
+    auto
+    get_ptr() noexcept -> void*
+    {
+        auto const addr =
+            reinterpret_cast<std::byte*>(this) + m_ops->obj_offset;
+        return m_ops->obj_inline ? addr : *reinterpret_cast<void**>(addr);
+    }
 
 protected:
-    virtual void
-    delete_obj() noexcept = 0;
+    void
+    delete_obj() noexcept
+    {
+        m_ops->delete_obj(this);
+    }
+
+    // default implementation of control_block_ops::destroy
+    template <typename Block>
+    static void
+    destroy_block(control_block* cb) noexcept
+    {
+        auto const block = static_cast<Block*>(cb);
+        std::destroy_at(block);
+        if constexpr (alignof(Block) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(
+                block, sizeof(Block), std::align_val_t{alignof(Block)}
+            );
+        }
+        else { ::operator delete(block, sizeof(Block)); }
+    }
+
+    // implementation of control_block_ops::destroy for blocks allocated from
+    // size_class_cache. It is only reached after the hazard pointer scan, so
+    // a block is never recycled while it is still protected.
+    template <typename Block>
+    static void
+    recycle_block(control_block* cb) noexcept
+    {
+        auto const block = static_cast<Block*>(cb);
+        std::destroy_at(block);
+        size_class_cache::deallocate(block, sizeof(Block));
+    }
 
 private:
-    std::atomic<count_type> m_shared_count; // #shared
-    std::atomic<count_type> m_weak_count;   // #weak + (#shared != 0)
+    constexpr static std::uint64_t shared_one  = 1;
+    constexpr static std::uint64_t weak_one    = std::uint64_t{1} << 32;
+    constexpr static std::uint64_t shared_mask = weak_one - 1;
+
+    control_block_ops const * m_ops;
+
+    // Both counts are packed into one word so that the common case of
+    // releasing the last shared_ptr without any weak_ptr is a single RMW.
+    // low 32 bits:  #shared
+    // high 32 bits: #weak + (#shared != 0)
+    std::atomic<std::uint64_t> m_counts;
+
+    void
+    retire() noexcept
+    {
+        // We can make the hazard pointer non-intrusive here by increasing
+        // the weak_count when using hazard pointer and setting the custom
+        // deleter to decrement_weak(), but that involves additional
+        // atomic operations and might not worth the non-intrusive property.
+        hazard_pointer<control_block>::retire(this);
+        // ::delete this;
+    }
 };
 
+// offsetof on types that are not standard-layout is conditionally-supported,
+// clang supports it for classes without virtual bases.
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Winvalid-offsetof"
+
 template <typename T>
 class control_block_with_ptr : public control_block
 {
 public:
-    control_block_with_ptr() noexcept : m_ptr{nullptr} {}
-    control_block_with_ptr(T* ptr) noexcept : m_ptr{ptr} {}
-    void
-    delete_obj() noexcept override
+    control_block_with_ptr() noexcept
+        : control_block{get_ops()}
+        , m_ptr{nullptr}
     {
-        ::delete m_ptr;
     }
-
-    auto
-    get_ptr() noexcept -> void* override
+    control_block_with_ptr(T* ptr) noexcept
+        : control_block{get_ops()}
+        , m_ptr{ptr}
     {
-        return m_ptr;
     }
 
 private:
     T* m_ptr;
+
+    static void
+    do_delete_obj(control_block* cb) noexcept
+    {
+        ::delete static_cast<control_block_with_ptr*>(cb)->m_ptr;
+    }
+
+    // the class is only complete inside member function bodies
+    static auto
+    get_ops() noexcept -> control_block_ops const *
+    {
+        constexpr static control_block_ops ops{
+            .delete_obj = &do_delete_obj,
+            .destroy    = &destroy_block<control_block_with_ptr>,
+            .obj_offset = __builtin_offsetof(control_block_with_ptr, m_ptr),
+            .obj_inline = false,
+        };
+        return &ops;
+    }
 };
 
-template <typename T>
+// shared_ptr(ptr, deleter): the managed object is released by the deleter
+template <typename T, typename D>
+class control_block_with_deleter : public control_block
+{
+public:
+    control_block_with_deleter(T* ptr, D const & deleter) noexcept(
+        std::is_nothrow_copy_constructible_v<D>
+    )
+        : control_block{get_ops()}
+        , m_ptr{ptr}
+        , m_deleter{deleter}
+    {
+    }
+
+private:
+    T*                      m_ptr;
+    [[no_unique_address]] D m_deleter;
+
+    static void
+    do_delete_obj(control_block* cb) noexcept
+    {
+        auto const block = static_cast<control_block_with_deleter*>(cb);
+        block->m_deleter(block->m_ptr);
+    }
+
+    static auto
+    get_ops() noexcept -> control_block_ops const *
+    {
+        constexpr static control_block_ops ops{
+            .delete_obj = &do_delete_obj,
+            .destroy    = &destroy_block<control_block_with_deleter>,
+            .obj_offset = __builtin_offsetof(control_block_with_deleter, m_ptr),
+            .obj_inline = false,
+        };
+        return &ops;
+    }
+};
+
+// If Recycle is true and the block fits in a size class of size_class_cache,
+// its memory is taken from and given back to the per-thread cache.
+template <typename T, bool Recycle = false>
 class control_block_with_obj : public control_block
 {
 public:
     template <typename... Args>
     control_block_with_obj(Args&&... args) noexcept
+        : control_block{get_ops()}
     {
         m_obj.emplace(std::forward<Args>(args)...);
     }
 
-    void
-    delete_obj() noexcept override
+    template <typename... Args>
+    [[nodiscard]] static auto
+    create(Args&&... args) -> control_block_with_obj*
     {
-        m_obj.destroy();
+        if constexpr (recycled())
+        {
+            return std::construct_at(
+                static_cast<control_block_with_obj*>(
+                    size_class_cache::allocate(sizeof(control_block_with_obj))
+                ),
+                std::forward<Args>(args)...
+            );
+        }
+        else
+        {
+            return ::new control_block_with_obj(std::forward<Args>(args)...);
+        }
     }
 
+    // the managed object lives at a fixed offset, no dispatch is needed when
+    // the concrete type is known
     auto
-    get_ptr() noexcept -> void* override
+    get_obj() noexcept -> T*
     {
         return std::addressof(m_obj.get());
     }
 
 private:
     [[no_unique_address]] manual_lifetime<T> m_obj;
+
+    static void
+    do_delete_obj(control_block* cb) noexcept
+    {
+        static_cast<control_block_with_obj*>(cb)->m_obj.destroy();
+    }
+
+    constexpr static auto
+    recycled() noexcept -> bool
+    {
+        return Recycle && size_class_cache::cacheable<control_block_with_obj>;
+    }
+
+    static auto
+    get_ops() noexcept -> control_block_ops const *
+    {
+        constexpr static control_block_ops ops{
+            .delete_obj = &do_delete_obj,
+            .destroy    = recycled() ? &recycle_block<control_block_with_obj>
+                                     : &destroy_block<control_block_with_obj>,
+            .obj_offset = __builtin_offsetof(control_block_with_obj, m_obj),
+            .obj_inline = true,
+        };
+        return &ops;
+    }
 };
 
-} // namespace tinystd
\ No newline at end of file
+#pragma clang diagnostic pop
+
+} // namespace tinystd
@@ -12,9 +12,15 @@ class weak_ptr;
 
 export class enable_shared_from_this;
 
-export template <non_array T>
+export template <non_array T, typename Policy>
 class atomic_shared_ptr;
 
+export template <non_array T>
+class atomic_weak_ptr;
+
+export template <non_array T>
+class snapshot_ptr;
+
 export template <non_array T>
 class [[clang::trivial_abi]] shared_ptr
 {
@@ -37,6 +43,29 @@ public:
         }
     }
 
+    // deleter(ptr) releases the object, it is also called if the control
+    // block cannot be allocated
+    template <pointer_convertible_to<T> U, std::copy_constructible D>
+        requires std::is_nothrow_invocable_v<D&, U*>
+    shared_ptr(U* ptr, D deleter)
+        : m_ptr{ptr}
+        , m_cb{nullptr}
+    {
+        try
+        {
+            m_cb = ::new control_block_with_deleter<U, D>(ptr, deleter);
+        }
+        catch (...)
+        {
+            deleter(ptr);
+            throw;
+        }
+        if constexpr (std::derived_from<U, enable_shared_from_this>)
+        {
+            if (ptr) ptr->m_cb = m_cb;
+        }
+    }
+
     // copy/move constructors
     shared_ptr(shared_ptr const & other) noexcept
         : m_ptr{other.m_ptr}
@@ -252,14 +281,28 @@ private:
 
     friend class enable_shared_from_this;
 
-    template <non_array U>
+    template <non_array U, typename Policy>
     friend class atomic_shared_ptr;
 
+    template <non_array U>
+    friend class atomic_weak_ptr;
+
+    template <non_array U>
+    friend class snapshot_ptr;
+
     template <typename U, typename... Args>
     friend auto
     make_shared(Args&&...) -> shared_ptr<U>;
 };
 
+// Opt-in: specialize to true to let make_shared<T> allocate its control block
+// from a per-thread size-class cache instead of the global allocator, e.g.
+//
+// template <>
+// inline constexpr bool tinystd::enable_control_block_recycling<msg> = true;
+export template <typename T>
+inline constexpr bool enable_control_block_recycling = false;
+
 export template <typename T>
 void
 swap(shared_ptr<T>& lhs, shared_ptr<T>& rhs) noexcept
@@ -271,12 +314,14 @@ export template <typename T, typename... Args>
 [[nodiscard]] auto
 make_shared(Args&&... args) -> shared_ptr<T>
 {
-    auto cb_ptr = ::new control_block_with_obj<T>(std::forward<Args>(args)...);
+    using block_t =
+        control_block_with_obj<T, enable_control_block_recycling<T>>;
+    auto cb_ptr = block_t::create(std::forward<Args>(args)...);
     if constexpr (std::derived_from<T, enable_shared_from_this>)
     {
-        static_cast<T*>(cb_ptr->get_ptr())->m_cb = cb_ptr;
+        cb_ptr->get_obj()->m_cb = cb_ptr;
     }
-    return shared_ptr<T>(static_cast<T*>(cb_ptr->get_ptr()), cb_ptr);
+    return shared_ptr<T>(cb_ptr->get_obj(), cb_ptr);
 }
 
 export template <typename T1, typename T2>
@@ -10,6 +10,9 @@ namespace tinystd
 
 export class enable_shared_from_this;
 
+export template <non_array T>
+class atomic_weak_ptr;
+
 export template <non_array T>
 class [[clang::trivial_abi]] weak_ptr
 {
@@ -137,6 +140,9 @@ private:
     template <non_array U>
     friend class weak_ptr;
 
+    template <non_array U>
+    friend class atomic_weak_ptr;
+
     friend class enable_shared_from_this;
 };
 
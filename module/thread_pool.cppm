@@ -0,0 +1,508 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:thread_pool;
+
+import std;
+import :span;
+import :function;
+import :object_pool;
+import :lockfree_queue;
+
+namespace tinystd
+{
+
+using task      = move_only_function<void()>;
+using task_pool = object_pool<task>;
+
+// Chase-Lev work-stealing deque of tasks, with the memory orders of Lê et
+// al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+// - The owner pushes and pops at the bottom (LIFO, the most recent task is
+//   still in cache), thieves steal at the top (FIFO, the oldest task is
+//   usually the largest part of a divide-and-conquer computation).
+// - Only the last element is contended: the owner and thieves race for it
+//   with a CAS on top.
+// - The ring grows when full. Old rings are kept until the deque is
+//   destroyed, a thief may still read a slot of an old ring.
+class work_stealing_deque
+{
+    struct ring
+    {
+        std::int64_t                          mask;
+        std::unique_ptr<std::atomic<task*>[]> slots;
+
+        explicit ring(std::int64_t size)
+            : mask{size - 1}
+            , slots{std::make_unique<std::atomic<task*>[]>(size)}
+        {
+        }
+
+        auto
+        get(std::int64_t i) const noexcept -> task*
+        {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void
+        put(std::int64_t i, task* t) noexcept
+        {
+            slots[i & mask].store(t, std::memory_order_relaxed);
+        }
+    };
+
+public:
+    work_stealing_deque()
+    {
+        m_rings.push_back(std::make_unique<ring>(initial_size));
+        m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    // owner only
+    void
+    push(task* t)
+    {
+        auto const b = m_bottom.load(std::memory_order_relaxed);
+        auto const f = m_top.load(std::memory_order_acquire);
+        auto       r = m_ring.load(std::memory_order_relaxed);
+        if (b - f > r->mask) r = grow(r, f, b);
+        r->put(b, t);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only, nullptr if empty
+    auto
+    pop() noexcept -> task*
+    {
+        auto const b = m_bottom.load(std::memory_order_relaxed) - 1;
+        auto const r = m_ring.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto f = m_top.load(std::memory_order_relaxed);
+        if (f > b)
+        {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        auto t = r->get(b);
+        if (f == b)
+        {
+            // the last task, race with thieves
+            if (!m_top.compare_exchange_strong(
+                    f,
+                    f + 1,
+                    std::memory_order_seq_cst,
+                    std::memory_order_relaxed
+                ))
+            {
+                t = nullptr;
+            }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    // any thread, nullptr if empty or if another thread won the race
+    auto
+    steal() noexcept -> task*
+    {
+        auto f = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto const b = m_bottom.load(std::memory_order_acquire);
+        if (f >= b) return nullptr;
+        auto const t = m_ring.load(std::memory_order_acquire)->get(f);
+        if (!m_top.compare_exchange_strong(
+                f, f + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+            ))
+        {
+            return nullptr;
+        }
+        return t;
+    }
+
+private:
+    constexpr static std::int64_t initial_size = 256;
+
+    alignas(std::hardware_destructive_interference_size
+    ) std::atomic<std::int64_t> m_top{0};
+    alignas(std::hardware_destructive_interference_size
+    ) std::atomic<std::int64_t> m_bottom{0};
+    std::atomic<ring*>                 m_ring;
+    std::vector<std::unique_ptr<ring>> m_rings; // owner only
+
+    auto
+    grow(ring* r, std::int64_t f, std::int64_t b) -> ring*
+    {
+        auto bigger = std::make_unique<ring>(2 * (r->mask + 1));
+        for (auto i = f; i < b; ++i) bigger->put(i, r->get(i));
+        m_rings.push_back(std::move(bigger));
+        auto const result = m_rings.back().get();
+        m_ring.store(result, std::memory_order_release);
+        return result;
+    }
+};
+
+// Fixed pool of worker threads executing tasks, with work stealing.
+// - Every worker owns a work_stealing_deque. A task submitted by a worker
+//   goes to its own deque, a task submitted by another thread goes to a
+//   shared lockfree_queue (the injection queue).
+// - A worker looks for a task in its deque, then in the injection queue,
+//   then steals from the other workers starting at a random one.
+// - Tasks are move_only_function<void()>, allocated from an object_pool:
+//   small lambdas (up to three pointers) need no heap allocation.
+// - Idle workers spin for a while, then sleep on an atomic epoch. A submit
+//   only touches the epoch when a worker sleeps.
+// - parallel_for/parallel_reduce split a span into chunks by recursive
+//   halving, the calling thread runs tasks until every chunk is done.
+// - The destructor runs every submitted task, then joins the workers.
+export class thread_pool
+{
+    struct alignas(std::hardware_destructive_interference_size) worker
+    {
+        work_stealing_deque deque;
+        std::uint64_t       rng_state;
+    };
+
+public:
+    explicit thread_pool(
+        std::size_t num_threads =
+            std::max(1u, std::thread::hardware_concurrency())
+    )
+        : m_num_workers{std::max<std::size_t>(num_threads, 1)}
+        , m_workers{std::make_unique<worker[]>(m_num_workers)}
+    {
+        m_threads.reserve(m_num_workers);
+        for (std::size_t i = 0; i < m_num_workers; ++i)
+        {
+            m_workers[i].rng_state = i + 1;
+            m_threads.emplace_back([this, i] { run(m_workers[i]); });
+        }
+    }
+
+    // no copy/move semantics
+    thread_pool(thread_pool const &) = delete;
+    auto
+    operator=(thread_pool const &) = delete;
+
+    // No other thread may submit while the pool is destroyed.
+    ~thread_pool() noexcept
+    {
+        m_stopping.store(true, std::memory_order_seq_cst);
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_epoch.notify_all();
+        m_threads.clear();
+    }
+
+    [[nodiscard]] auto
+    size() const noexcept -> std::size_t
+    {
+        return m_num_workers;
+    }
+
+    // Runs f() on a worker. An exception escaping f calls std::terminate.
+    template <typename F>
+        requires std::invocable<std::decay_t<F>&>
+    void
+    submit(F&& f)
+    {
+        auto const t = task_pool::create(std::forward<F>(f));
+        try
+        {
+            if (auto const self = local_worker()) { self->deque.push(t); }
+            else { m_injection.push(t); }
+        }
+        catch (...)
+        {
+            task_pool::destroy(t);
+            throw;
+        }
+        wake_one();
+    }
+
+    // Calls fn(element) for every element of data, chunks of grain elements
+    // run in parallel (grain 0: about 8 chunks per worker). The first
+    // exception thrown by fn is rethrown once every chunk is done or
+    // skipped.
+    template <typename T, std::size_t Extent, typename F>
+        requires std::invocable<F&, T&>
+    void
+    parallel_for(span<T, Extent> data, F&& fn, std::size_t grain = 0)
+    {
+        auto const size       = data.size();
+        auto const chunk_size = chunk_size_for(size, grain);
+        auto const num_chunks = (size + chunk_size - 1) / chunk_size;
+        auto       run_chunk  = [&](std::size_t chunk)
+        {
+            auto const first = chunk * chunk_size;
+            auto const last  = std::min(first + chunk_size, size);
+            for (auto i = first; i < last; ++i) fn(data[i]);
+        };
+        fork_join(num_chunks, run_chunk);
+    }
+
+    // Reduces every chunk of data with reduce(R, T&), starting from
+    // identity, then combines the chunk results in order with
+    // combine(R, R). identity must be an identity of combine.
+    template <
+        typename T,
+        std::size_t Extent,
+        std::copy_constructible R,
+        typename Reduce,
+        typename Combine>
+        requires std::is_invocable_r_v<R, Reduce&, R, T&>
+              && std::is_invocable_r_v<R, Combine&, R, R>
+    auto
+    parallel_reduce(
+        span<T, Extent> data,
+        R               identity,
+        Reduce&&        reduce,
+        Combine&&       combine,
+        std::size_t     grain = 0
+    ) -> R
+    {
+        auto const size       = data.size();
+        auto const chunk_size = chunk_size_for(size, grain);
+        auto const num_chunks = (size + chunk_size - 1) / chunk_size;
+
+        std::vector<std::optional<R>> partials(num_chunks);
+        auto                          run_chunk = [&](std::size_t chunk)
+        {
+            auto const first = chunk * chunk_size;
+            auto const last  = std::min(first + chunk_size, size);
+            R          acc   = identity;
+            for (auto i = first; i < last; ++i)
+            {
+                acc = std::invoke(reduce, std::move(acc), data[i]);
+            }
+            partials[chunk].emplace(std::move(acc));
+        };
+        fork_join(num_chunks, run_chunk);
+
+        for (auto& partial : partials)
+        {
+            identity = std::invoke(combine, std::move(identity), *partial);
+        }
+        return identity;
+    }
+
+    // parallel_reduce with reduce also used to combine the chunk results
+    template <
+        typename T,
+        std::size_t Extent,
+        std::copy_constructible R,
+        typename Reduce>
+        requires std::is_invocable_r_v<R, Reduce&, R, T&>
+              && std::is_invocable_r_v<R, Reduce&, R, R>
+    auto
+    parallel_reduce(
+        span<T, Extent> data,
+        R               identity,
+        Reduce&&        reduce,
+        std::size_t     grain = 0
+    ) -> R
+    {
+        return parallel_reduce(
+            data, std::move(identity), reduce, reduce, grain
+        );
+    }
+
+private:
+    // chunks [first, last) of a fork_join, shared by its tasks
+    template <typename RunChunk>
+    struct fork_join_state
+    {
+        thread_pool&             pool;
+        RunChunk&                run_chunk;
+        std::atomic<std::size_t> pending;
+        std::atomic<bool>        failed{false};
+        std::exception_ptr       error;
+
+        // Submits the upper halves of [first, last) and runs the first
+        // chunk. The task captures 3 words, it is stored inline. An upper
+        // half that cannot be submitted runs on the calling thread.
+        void
+        split(std::size_t first, std::size_t last) noexcept
+        {
+            while (last - first > 1)
+            {
+                auto const mid = first + (last - first) / 2;
+                try
+                {
+                    pool.submit([this, mid, last] { split(mid, last); });
+                }
+                catch (...)
+                {
+                    split(mid, last);
+                }
+                last = mid;
+            }
+            if (!failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    run_chunk(first);
+                }
+                catch (...)
+                {
+                    if (!failed.exchange(true, std::memory_order_relaxed))
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    struct local_state
+    {
+        thread_pool const * pool = nullptr;
+        worker*             self = nullptr;
+    };
+
+    constexpr static int spins_before_sleep = 64;
+
+    inline static thread_local local_state local{};
+
+    std::size_t               m_num_workers;
+    std::unique_ptr<worker[]> m_workers;
+    lockfree_queue<task*>     m_injection;
+
+    alignas(std::hardware_destructive_interference_size
+    ) std::atomic<std::uint32_t> m_epoch{0};
+    std::atomic<std::size_t> m_sleepers{0};
+    std::atomic<bool>        m_stopping{false};
+
+    // last member, joined before the others are destroyed
+    std::vector<std::jthread> m_threads;
+
+    auto
+    chunk_size_for(std::size_t size, std::size_t grain) const noexcept
+        -> std::size_t
+    {
+        if (grain != 0) return grain;
+        return std::max<std::size_t>(1, size / (8 * m_num_workers));
+    }
+
+    auto
+    local_worker() const noexcept -> worker*
+    {
+        return local.pool == this ? local.self : nullptr;
+    }
+
+    // runs the chunks 0..num_chunks in parallel and waits for them
+    template <typename RunChunk>
+    void
+    fork_join(std::size_t num_chunks, RunChunk& run_chunk)
+    {
+        if (num_chunks == 0) return;
+        fork_join_state<RunChunk> state{*this, run_chunk, num_chunks};
+        state.split(0, num_chunks);
+        help_until(
+            [&] { return state.pending.load(std::memory_order_acquire) == 0; }
+        );
+        if (state.error) std::rethrow_exception(state.error);
+    }
+
+    // runs tasks on the calling thread until done() holds
+    template <typename Done>
+    void
+    help_until(Done&& done) noexcept
+    {
+        auto const self = local_worker();
+        while (!done())
+        {
+            if (auto const t = find_task(self)) { run_task(t); }
+            else { std::this_thread::yield(); }
+        }
+    }
+
+    static void
+    run_task(task* t) noexcept
+    {
+        (*t)();
+        task_pool::destroy(t);
+    }
+
+    // self is nullptr on a thread that is not a worker of this pool
+    auto
+    find_task(worker* self) noexcept -> task*
+    {
+        if (self)
+        {
+            if (auto const t = self->deque.pop()) return t;
+        }
+        if (auto const t = m_injection.pop()) return *t;
+
+        // xorshift, only picks the first victim
+        std::uint64_t start = 0;
+        if (self)
+        {
+            auto& x  = self->rng_state;
+            x       ^= x << 13;
+            x       ^= x >> 7;
+            x       ^= x << 17;
+            start    = x;
+        }
+        for (std::size_t i = 0; i < m_num_workers; ++i)
+        {
+            auto& victim = m_workers[(start + i) % m_num_workers];
+            if (&victim == self) continue;
+            if (auto const t = victim.deque.steal()) return t;
+        }
+        return nullptr;
+    }
+
+    void
+    wake_one() noexcept
+    {
+        // pairs with the fence in run: either the sleeping worker finds the
+        // task, or this thread sees it going to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_relaxed) == 0) return;
+        // release: the woken worker sees the task pushed before
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_one();
+    }
+
+    void
+    run(worker& self) noexcept
+    {
+        local = {this, &self};
+        while (true)
+        {
+            task* t = nullptr;
+            for (int i = 0; t == nullptr && i < spins_before_sleep; ++i)
+            {
+                t = find_task(&self);
+                if (t == nullptr) std::this_thread::yield();
+            }
+            if (t)
+            {
+                run_task(t);
+                continue;
+            }
+
+            m_sleepers.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // acquire: a stopping destructor bumps the epoch after setting
+            // m_stopping
+            auto const epoch = m_epoch.load(std::memory_order_acquire);
+            t                = find_task(&self);
+            if (t == nullptr)
+            {
+                if (m_stopping.load(std::memory_order_acquire))
+                {
+                    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+                m_epoch.wait(epoch, std::memory_order_acquire);
+            }
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (t) run_task(t);
+        }
+        local = {};
+    }
+};
+
+} // namespace tinystd
@@ -5,6 +5,13 @@ export import :vector_mixin;
 export import :small_vector;
 export import :vector;
 export import :inplace_vector;
+export import :soa_vector;
+export import :segmented_vector;
+export import :huge_buffer_allocator;
+export import :dynamic_bitset;
+export import :flat_map;
+export import :flat_set;
+export import :simd_algorithms;
 export import :unique_ptr;
 export import :shared_ptr;
 export import :weak_ptr;
@@ -13,5 +20,16 @@ export import :span;
 export import :waitfree_spsc_queue;
 export import :hazard_pointer;
 export import :atomic_shared_ptr;
+export import :atomic_weak_ptr;
+export import :rcu_cell;
+export import :seqlock_cell;
+export import :lockfree_stack;
+export import :lockfree_queue;
+export import :concurrent_hash_map;
+export import :concurrent_skip_list;
+export import :object_pool;
+export import :concurrent_lru_cache;
+export import :async_logger;
+export import :thread_pool;
 export import :any;
 export import :function;
\ No newline at end of file
@@ -1,6 +1,7 @@
 export module tinystd:inplace_vector;
 
 import std;
+import :span;
 import :vector_mixin;
 
 namespace tinystd
@@ -23,6 +24,13 @@ public:
     // constructors
     constexpr inplace_vector() noexcept : m_sz{0} {}
 
+    // the elements are default-initialized, i.e. left uninitialized if `T`
+    // is trivially default constructible
+    constexpr inplace_vector(default_init_t, size_type count) : m_sz{0}
+    {
+        append_for_overwrite(count);
+    }
+
     constexpr inplace_vector(inplace_vector const & other) : m_sz{other.m_sz}
     {
         uninitialized_copy(other.begin(), other.end(), begin());
@@ -93,11 +101,24 @@ public:
     constexpr auto
     emplace_back(Args&&... args) -> T&
     {
+        if (m_sz == N) throw std::bad_alloc();
         T& ret = *std::construct_at(end(), std::forward<Args>(args)...);
         ++m_sz;
         return ret;
     }
 
+    constexpr void
+    push_back(T const & value)
+    {
+        emplace_back(value);
+    }
+
+    constexpr void
+    push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
     constexpr void
     pop_back() noexcept
     {
@@ -108,12 +129,264 @@ public:
         }
     }
 
+    template <typename... Args>
+    constexpr auto
+    emplace(const_iterator pos, Args&&... args) -> iterator
+    {
+        // args may refer to an element that is about to be shifted
+        T temp(std::forward<Args>(args)...);
+        return insert_with(
+            pos, 1, [&](T* p) { std::construct_at(p, std::move(temp)); }
+        );
+    }
+
+    constexpr auto
+    insert(const_iterator pos, T const & value) -> iterator
+    {
+        return emplace(pos, value);
+    }
+
+    constexpr auto
+    insert(const_iterator pos, T&& value) -> iterator
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    constexpr auto
+    insert(const_iterator pos, size_type count, T const & value) -> iterator
+    {
+        T const temp(value);
+        return insert_with(pos, count, copies_of(count, temp));
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    constexpr auto
+    insert(const_iterator pos, It first, Sentinel last) -> iterator
+    {
+        return insert_range(pos, std::ranges::subrange(first, last));
+    }
+
+    constexpr auto
+    insert(const_iterator pos, std::initializer_list<T> list) -> iterator
+    {
+        return insert_range(pos, list);
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr auto
+    insert_range(const_iterator pos, R&& range) -> iterator
+    {
+        if constexpr (
+            std::ranges::forward_range<R> || std::ranges::sized_range<R>
+        )
+        {
+            auto const count =
+                static_cast<size_type>(std::ranges::distance(range));
+            return insert_with(
+                pos,
+                count,
+                [&](T* out)
+                {
+                    auto it = std::ranges::begin(range);
+                    construct_n(
+                        out,
+                        count,
+                        [&](T* p)
+                        {
+                            std::construct_at(p, *it);
+                            ++it;
+                        }
+                    );
+                }
+            );
+        }
+        else
+        {
+            size_type const offset   = pos - data();
+            size_type const old_size = m_sz;
+            try
+            {
+                for (auto&& x : range)
+                {
+                    emplace_back(std::forward<decltype(x)>(x));
+                }
+            }
+            catch (...)
+            {
+                truncate(begin() + old_size);
+                throw;
+            }
+            std::rotate(begin() + offset, begin() + old_size, end());
+            return begin() + offset;
+        }
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr void
+    append_range(R&& range)
+    {
+        insert_range(end(), std::forward<R>(range));
+    }
+
+    constexpr auto
+    erase(const_iterator pos) -> iterator
+    {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr auto
+    erase(const_iterator first, const_iterator last) -> iterator
+    {
+        T* const efirst = begin() + (first - data());
+        if (first != last)
+        {
+            T* const elast = begin() + (last - data());
+            m_sz           = erase_in_place(efirst, elast, end()) - begin();
+        }
+        return efirst;
+    }
+
+    constexpr void
+    assign(size_type count, T const & value)
+    {
+        if (count > N) throw std::bad_alloc();
+        T const temp(value);
+        clear();
+        insert_with(end(), count, copies_of(count, temp));
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    constexpr void
+    assign(It first, Sentinel last)
+    {
+        assign_range(std::ranges::subrange(first, last));
+    }
+
+    constexpr void
+    assign(std::initializer_list<T> list)
+    {
+        assign_range(list);
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr void
+    assign_range(R&& range)
+    {
+        clear();
+        append_range(std::forward<R>(range));
+    }
+
+    constexpr void
+    resize(size_type count)
+    {
+        if (count <= m_sz) { truncate(begin() + count); }
+        else
+        {
+            size_type const n = count - m_sz;
+            insert_with(
+                end(),
+                n,
+                [&](T* out)
+                { construct_n(out, n, [](T* p) { std::construct_at(p); }); }
+            );
+        }
+    }
+
+    constexpr void
+    resize(size_type count, T const & value)
+    {
+        if (count <= m_sz) { truncate(begin() + count); }
+        else
+        {
+            size_type const n = count - m_sz;
+            insert_with(end(), n, copies_of(n, value));
+        }
+    }
+
+    // like resize, but new elements are default-initialized, which leaves
+    // them uninitialized if `T` is trivially default constructible
+    constexpr void
+    resize_for_overwrite(size_type count)
+    {
+        if (count <= m_sz) { truncate(begin() + count); }
+        else { append_for_overwrite(count - m_sz); }
+    }
+
+    // appends `count` default-initialized elements, to be written through
+    // the returned span
+    constexpr auto
+    append_for_overwrite(size_type count) -> span<T>
+    {
+        T* const first = insert_with(
+            end(),
+            count,
+            [&](T* out) { uninitialized_default_construct(out, count); }
+        );
+        return {first, count};
+    }
+
+    // the capacity is fixed, these only check it
+    static constexpr void
+    reserve(size_type new_cap)
+    {
+        if (new_cap > N) throw std::bad_alloc();
+    }
+
+    static constexpr void
+    shrink_to_fit() noexcept
+    {
+    }
+
+    constexpr void
+    clear() noexcept
+    {
+        truncate(begin());
+    }
+
 private:
     using storage_t =
         std::conditional_t<sbo_can_be_constexpr<T>, T[N], char[N * sizeof(T)]>;
 
     size_type m_sz;
     [[no_unique_address]] alignas(T) storage_t m_data;
+
+    // a fill for insert_with that constructs `count` copies of `value`
+    static constexpr auto
+    copies_of(size_type count, T const & value)
+    {
+        return [count, &value](T* out)
+        {
+            construct_n(
+                out, count, [&](T* p) { std::construct_at(p, value); }
+            );
+        };
+    }
+
+    // inserts `count` elements at `pos`, `fill(p)` constructs all of them at
+    // p or none, throws `std::bad_alloc` if they do not fit
+    template <typename Fill>
+    constexpr auto
+    insert_with(const_iterator pos, size_type count, Fill&& fill) -> iterator
+    {
+        if (count > N - m_sz) throw std::bad_alloc();
+        T* const p = begin() + (pos - data());
+        insert_in_place(p, end(), count, fill);
+        m_sz += count;
+        return p;
+    }
+
+    constexpr void
+    truncate(T* new_end) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::destroy(new_end, end());
+        }
+        m_sz = new_end - begin();
+    }
 };
 
 export template <typename T, std::size_t N>
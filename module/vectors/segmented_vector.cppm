@@ -0,0 +1,439 @@
+export module tinystd:segmented_vector;
+
+import std;
+import :span;
+import :vector;
+
+namespace tinystd
+{
+
+// default chunk: as many elements as fit in 4 KiB, rounded down to a power
+// of two
+template <typename T>
+inline constexpr std::size_t default_chunk_size =
+    std::bit_floor(std::max(std::size_t{4096} / sizeof(T), std::size_t{1}));
+
+// Vector of fixed size chunks, as `std::deque` growing only at the back.
+// - Element i lives at `chunks[i / ChunkSize][i % ChunkSize]`, ChunkSize is a
+//   power of two, so that is a shift and a mask.
+// - Growth allocates one more chunk and appends its pointer to the chunk
+//   table, elements are never relocated: their addresses stay valid until
+//   they are erased, and growing costs the same at any size.
+export template <typename T, std::size_t ChunkSize = default_chunk_size<T>>
+    requires(std::has_single_bit(ChunkSize))
+class segmented_vector
+{
+    static constexpr std::size_t shift = std::countr_zero(ChunkSize);
+    static constexpr std::size_t mask  = ChunkSize - 1;
+
+    // random access iterator that walks a chunk before it moves to the next
+    template <bool Const>
+    class chunk_iterator
+    {
+        using element_t = std::conditional_t<Const, T const, T>;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = element_t*;
+        using reference         = element_t&;
+
+        chunk_iterator() noexcept = default;
+
+        chunk_iterator(T* const * chunk, std::size_t offset) noexcept
+            : m_chunk{chunk}
+            , m_offset{static_cast<difference_type>(offset)}
+        {
+        }
+
+        // iterator to const_iterator
+        chunk_iterator(chunk_iterator<!Const> const & other) noexcept
+            requires Const
+            : m_chunk{other.m_chunk}
+            , m_offset{other.m_offset}
+        {
+        }
+
+        [[nodiscard]] auto
+        operator*() const noexcept -> reference
+        {
+            return (*m_chunk)[m_offset];
+        }
+
+        [[nodiscard]] auto
+        operator->() const noexcept -> pointer
+        {
+            return *m_chunk + m_offset;
+        }
+
+        [[nodiscard]] auto
+        operator[](difference_type n) const noexcept -> reference
+        {
+            return *(*this + n);
+        }
+
+        auto
+        operator++() noexcept -> chunk_iterator&
+        {
+            if (++m_offset == chunk_length) [[unlikely]]
+            {
+                ++m_chunk;
+                m_offset = 0;
+            }
+            return *this;
+        }
+
+        auto
+        operator++(int) noexcept -> chunk_iterator
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto
+        operator--() noexcept -> chunk_iterator&
+        {
+            if (m_offset-- == 0) [[unlikely]]
+            {
+                --m_chunk;
+                m_offset = chunk_length - 1;
+            }
+            return *this;
+        }
+
+        auto
+        operator--(int) noexcept -> chunk_iterator
+        {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        auto
+        operator+=(difference_type n) noexcept -> chunk_iterator&
+        {
+            // arithmetic shift, rounds towards minus infinity for n < 0
+            difference_type const position = m_offset + n;
+            m_chunk  += position >> shift;
+            m_offset  = position & (chunk_length - 1);
+            return *this;
+        }
+
+        auto
+        operator-=(difference_type n) noexcept -> chunk_iterator&
+        {
+            return *this += -n;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(chunk_iterator it, difference_type n) noexcept
+            -> chunk_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(difference_type n, chunk_iterator it) noexcept
+            -> chunk_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(chunk_iterator it, difference_type n) noexcept
+            -> chunk_iterator
+        {
+            return it -= n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(
+            chunk_iterator const & lhs, chunk_iterator const & rhs
+        ) noexcept -> difference_type
+        {
+            return (lhs.m_chunk - rhs.m_chunk) * chunk_length
+                 + (lhs.m_offset - rhs.m_offset);
+        }
+
+        [[nodiscard]] friend auto
+        operator==(
+            chunk_iterator const & lhs, chunk_iterator const & rhs
+        ) noexcept -> bool
+        {
+            return lhs.m_chunk == rhs.m_chunk && lhs.m_offset == rhs.m_offset;
+        }
+
+        [[nodiscard]] friend auto
+        operator<=>(
+            chunk_iterator const & lhs, chunk_iterator const & rhs
+        ) noexcept
+        {
+            if (auto const order = lhs.m_chunk <=> rhs.m_chunk; order != 0)
+            {
+                return order;
+            }
+            return lhs.m_offset <=> rhs.m_offset;
+        }
+
+    private:
+        friend class chunk_iterator<!Const>;
+
+        static constexpr difference_type chunk_length = ChunkSize;
+
+        T* const *      m_chunk  = nullptr;
+        difference_type m_offset = 0;
+    };
+
+public:
+    using size_type       = std::size_t;
+    using value_type      = T;
+    using iterator        = chunk_iterator<false>;
+    using const_iterator  = chunk_iterator<true>;
+    using reference       = T&;
+    using const_reference = T const &;
+
+    static constexpr size_type chunk_size = ChunkSize;
+
+    // constructors
+    segmented_vector() noexcept = default;
+
+    segmented_vector(segmented_vector const & other)
+    {
+        try
+        {
+            reserve(other.m_sz);
+            for (T const & value : other) emplace_back(value);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    segmented_vector(segmented_vector&& other) noexcept
+        : m_chunks{std::move(other.m_chunks)}
+        , m_sz{std::exchange(other.m_sz, 0)}
+    {
+    }
+
+    // assignment, copy-swap as for the other vectors
+    auto
+    operator=(segmented_vector rhs) noexcept -> segmented_vector&
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    // destructor
+    ~segmented_vector() noexcept { release(); }
+
+    // access and observers
+    [[nodiscard]] auto
+    size() const noexcept -> size_type
+    {
+        return m_sz;
+    }
+
+    [[nodiscard]] auto
+    capacity() const noexcept -> size_type
+    {
+        return m_chunks.size() * ChunkSize;
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return m_sz == 0;
+    }
+
+    [[nodiscard]] auto
+    operator[](size_type i) noexcept -> T&
+    {
+        return m_chunks[i >> shift][i & mask];
+    }
+
+    [[nodiscard]] auto
+    operator[](size_type i) const noexcept -> T const &
+    {
+        return m_chunks[i >> shift][i & mask];
+    }
+
+    [[nodiscard]] auto
+    back() noexcept -> T&
+    {
+        return (*this)[m_sz - 1];
+    }
+
+    [[nodiscard]] auto
+    back() const noexcept -> T const &
+    {
+        return (*this)[m_sz - 1];
+    }
+
+    // number of chunks holding elements, and the elements of chunk i, for
+    // loops that want a contiguous inner loop
+    [[nodiscard]] auto
+    chunk_count() const noexcept -> size_type
+    {
+        return (m_sz + mask) >> shift;
+    }
+
+    [[nodiscard]] auto
+    chunk(size_type i) noexcept -> span<T>
+    {
+        return {m_chunks[i], chunk_length(i)};
+    }
+
+    [[nodiscard]] auto
+    chunk(size_type i) const noexcept -> span<T const>
+    {
+        return {m_chunks[i], chunk_length(i)};
+    }
+
+    [[nodiscard]] auto
+    begin() noexcept -> iterator
+    {
+        return {m_chunks.data(), 0};
+    }
+
+    [[nodiscard]] auto
+    end() noexcept -> iterator
+    {
+        return {m_chunks.data() + (m_sz >> shift), m_sz & mask};
+    }
+
+    [[nodiscard]] auto
+    begin() const noexcept -> const_iterator
+    {
+        return {m_chunks.data(), 0};
+    }
+
+    [[nodiscard]] auto
+    end() const noexcept -> const_iterator
+    {
+        return {m_chunks.data() + (m_sz >> shift), m_sz & mask};
+    }
+
+    // modifiers
+    void
+    swap(segmented_vector& other) noexcept
+    {
+        m_chunks.swap(other.m_chunks);
+        std::swap(m_sz, other.m_sz);
+    }
+
+    // no element moves, so the arguments may refer to an element
+    template <typename... Args>
+    auto
+    emplace_back(Args&&... args) -> T&
+    {
+        if (m_sz == capacity()) [[unlikely]] { add_chunk(); }
+        T* const p = std::construct_at(
+            m_chunks[m_sz >> shift] + (m_sz & mask), std::forward<Args>(args)...
+        );
+        ++m_sz;
+        return *p;
+    }
+
+    void
+    push_back(T const & value)
+    {
+        emplace_back(value);
+    }
+
+    void
+    push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void
+    pop_back() noexcept
+    {
+        --m_sz;
+        std::destroy_at(&(*this)[m_sz]);
+    }
+
+    void
+    clear() noexcept
+    {
+        for (size_type i = 0; i < chunk_count(); ++i)
+        {
+            std::destroy_n(m_chunks[i], chunk_length(i));
+        }
+        m_sz = 0;
+    }
+
+    // allocates chunks up front, nothing is relocated
+    void
+    reserve(size_type new_cap)
+    {
+        m_chunks.reserve((new_cap + mask) >> shift);
+        while (capacity() < new_cap) add_chunk();
+    }
+
+    // frees the chunks that hold no element
+    void
+    shrink_to_fit() noexcept
+    {
+        while (m_chunks.size() > chunk_count())
+        {
+            deallocate_chunk(m_chunks[m_chunks.size() - 1]);
+            m_chunks.pop_back();
+        }
+    }
+
+private:
+    vector<T*> m_chunks;
+    size_type  m_sz = 0;
+
+    [[nodiscard]] auto
+    chunk_length(size_type i) const noexcept -> size_type
+    {
+        return std::min(ChunkSize, m_sz - (i << shift));
+    }
+
+    void
+    add_chunk()
+    {
+        T* const chunk = std::allocator<T>{}.allocate(ChunkSize);
+        try
+        {
+            m_chunks.push_back(chunk);
+        }
+        catch (...)
+        {
+            deallocate_chunk(chunk);
+            throw;
+        }
+    }
+
+    static void
+    deallocate_chunk(T* chunk) noexcept
+    {
+        std::allocator<T>{}.deallocate(chunk, ChunkSize);
+    }
+
+    void
+    release() noexcept
+    {
+        clear();
+        for (T* const chunk : m_chunks) deallocate_chunk(chunk);
+        m_chunks.clear();
+    }
+};
+
+export template <typename T, std::size_t ChunkSize>
+void
+swap(
+    segmented_vector<T, ChunkSize>& v1, segmented_vector<T, ChunkSize>& v2
+) noexcept
+{
+    v1.swap(v2);
+}
+
+} // namespace tinystd
@@ -1,51 +1,111 @@
 export module tinystd:small_vector;
 
 import std;
+import :span;
 import :vector_mixin;
 
 namespace tinystd
 {
 
-export template <typename T, std::size_t N>
+// Layout and growth knobs of small_vector, as Boost's small_vector_options.
+// - `StoredSize`: type of the stored size and capacity, e.g. `std::uint32_t`
+//   saves 8 bytes per vector, `max_size()` shrinks to its maximum.
+// - capacity grows by `GrowthNumerator / GrowthDenominator`, at least by
+//   what an insert needs.
+export template <
+    std::unsigned_integral StoredSize        = std::size_t,
+    std::size_t            GrowthNumerator   = 2,
+    std::size_t            GrowthDenominator = 1>
+    requires(GrowthDenominator > 0 && GrowthNumerator > GrowthDenominator)
+struct small_vector_options
+{
+    using stored_size_type = StoredSize;
+
+    static constexpr std::size_t growth_numerator   = GrowthNumerator;
+    static constexpr std::size_t growth_denominator = GrowthDenominator;
+};
+
+export template <
+    typename T,
+    std::size_t N,
+    typename Allocator = std::allocator<T>,
+    typename Options   = small_vector_options<>>
 class small_vector : private vector_mixin<T>
 {
-    using base = vector_mixin<T>;
+    using base             = vector_mixin<T>;
+    using alloc_traits     = std::allocator_traits<Allocator>;
+    using stored_size_type = typename Options::stored_size_type;
+
+    static_assert(
+        N <= std::numeric_limits<stored_size_type>::max(),
+        "the inline capacity must fit in the stored size type"
+    );
 
 public:
     using typename base::const_iterator;
     using typename base::iterator;
     using typename base::size_type;
+    using allocator_type = Allocator;
     using base::operator[];
     using base::begin;
     using base::empty;
     using base::end;
 
     // constructors
-    constexpr small_vector() noexcept
+    constexpr small_vector() noexcept(noexcept(Allocator()))
+        : small_vector(Allocator())
+    {
+    }
+
+    constexpr explicit small_vector(Allocator const & alloc) noexcept
         : m_data{get_buffer()}
         , m_sz{0}
         , m_capacity{N}
+        , m_alloc{alloc}
     {
     }
 
-    constexpr small_vector(small_vector const & other) : m_sz(other.m_sz)
+    // the elements are default-initialized, i.e. left uninitialized if `T`
+    // is trivially default constructible
+    constexpr small_vector(
+        default_init_t,
+        size_type         count,
+        Allocator const & alloc = Allocator()
+    )
+        : small_vector(alloc)
     {
-        if (m_sz > N)
+        reserve(count);
+        append_for_overwrite(count);
+    }
+
+    constexpr small_vector(small_vector const & other)
+        : small_vector(
+              other,
+              alloc_traits::select_on_container_copy_construction(other.m_alloc)
+          )
+    {
+    }
+
+    constexpr small_vector(small_vector const & other, Allocator const & alloc)
+        : m_sz{other.m_sz}
+        , m_alloc{alloc}
+    {
+        allocate_for_size();
+        try
         {
-            m_capacity = m_sz;
-            m_data     = m_alloc.allocate(m_capacity);
+            copy_construct(other.begin(), m_sz, m_data);
         }
-        else
+        catch (...)
         {
-            m_capacity = N;
-            m_data     = get_buffer();
+            deallocate();
+            throw;
         }
-        uninitialized_copy(other.begin(), other.end(), m_data);
     }
 
     constexpr small_vector(small_vector&& other)
         noexcept(N == 0 || nothrow_relocatable<T>)
-        : m_sz(other.m_sz)
+        : m_sz{other.m_sz}
+        , m_alloc{std::move(other.m_alloc)}
     {
         if (other.objects_on_heap())
         {
@@ -61,12 +121,61 @@ public:
         other.m_sz = 0;
     }
 
+    // heap storage is only stolen if `alloc` can deallocate it, otherwise
+    // the elements are moved one by one into storage from `alloc`
+    constexpr small_vector(small_vector&& other, Allocator const & alloc)
+        : m_sz{other.m_sz}
+        , m_alloc{alloc}
+    {
+        if (other.objects_on_heap() && same_storage(other))
+        {
+            m_capacity = std::exchange(other.m_capacity, N);
+            m_data     = std::exchange(other.m_data, other.get_buffer());
+        }
+        else
+        {
+            allocate_for_size();
+            try
+            {
+                relocate_construct(other.begin(), other.end(), m_data);
+            }
+            catch (...)
+            {
+                deallocate();
+                throw;
+            }
+        }
+        other.m_sz = 0;
+    }
+
     // assignments
+    // the new contents are built in a temporary, then swapped in, this
+    // handles assigning from an element of *this
+    constexpr auto
+    operator=(small_vector const & rhs) -> small_vector&
+    {
+        if (this != &rhs)
+        {
+            constexpr bool propagate =
+                alloc_traits::propagate_on_container_copy_assignment::value;
+            assign_from<propagate>(rhs);
+        }
+        return *this;
+    }
+
     constexpr auto
-    operator=(small_vector rhs)
-        noexcept(noexcept(rhs.swap(*this))) -> small_vector&
+    operator=(small_vector&& rhs) noexcept(
+        (alloc_traits::propagate_on_container_move_assignment::value
+         || alloc_traits::is_always_equal::value)
+        && (N == 0 || nothrow_relocatable<T>)
+    ) -> small_vector&
     {
-        swap(rhs);
+        if (this != &rhs)
+        {
+            constexpr bool propagate =
+                alloc_traits::propagate_on_container_move_assignment::value;
+            assign_from<propagate>(std::move(rhs));
+        }
         return *this;
     }
 
@@ -98,9 +207,334 @@ public:
         return m_capacity;
     }
 
+    [[nodiscard]] static constexpr auto
+    max_size() noexcept -> size_type
+    {
+        return std::min<size_type>(
+            std::numeric_limits<stored_size_type>::max(),
+            std::numeric_limits<size_type>::max() / sizeof(T)
+        );
+    }
+
+    [[nodiscard]] constexpr auto
+    get_allocator() const noexcept -> allocator_type
+    {
+        return m_alloc;
+    }
+
     // modifiers
+    // allocators that do not propagate on swap must compare equal
     constexpr void
     swap(small_vector& other) noexcept(N == 0 || nothrow_relocatable<T>)
+    {
+        swap_contents(other);
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(m_alloc, other.m_alloc);
+        }
+    }
+
+    template <typename... Args>
+    constexpr auto
+    emplace_back(Args&&... args) -> T&
+    {
+        if (m_sz == m_capacity) [[unlikely]]
+        {
+            if constexpr (reallocating_allocator<Allocator, T>)
+            {
+                // args may refer to an element, which a reallocation in
+                // place moves, so construct a temporary first
+                auto temp = std::make_obj_using_allocator<T>(
+                    m_alloc, std::forward<Args>(args)...
+                );
+                return *insert_with<false>(
+                    end(), 1, [&](T* p) { construct(p, std::move(temp)); }
+                );
+            }
+            else
+            {
+                // args may refer to an element, so construct before
+                // relocating
+                return *insert_with(
+                    end(),
+                    1,
+                    [&](T* p) { construct(p, std::forward<Args>(args)...); }
+                );
+            }
+        }
+        construct(end(), std::forward<Args>(args)...);
+        ++m_sz;
+        return *(end() - 1);
+    }
+
+    constexpr void
+    push_back(T const & value)
+    {
+        emplace_back(value);
+    }
+
+    constexpr void
+    push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    constexpr void
+    pop_back() noexcept
+    {
+        --m_sz;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::destroy_at(end());
+        }
+    }
+
+    template <typename... Args>
+    constexpr auto
+    emplace(const_iterator pos, Args&&... args) -> iterator
+    {
+        if (pos == end()) return &emplace_back(std::forward<Args>(args)...);
+
+        // args may refer to an element that is about to be shifted
+        auto temp = std::make_obj_using_allocator<T>(
+            m_alloc, std::forward<Args>(args)...
+        );
+        return insert_with(
+            pos, 1, [&](T* p) { construct(p, std::move(temp)); }
+        );
+    }
+
+    constexpr auto
+    insert(const_iterator pos, T const & value) -> iterator
+    {
+        return emplace(pos, value);
+    }
+
+    constexpr auto
+    insert(const_iterator pos, T&& value) -> iterator
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    constexpr auto
+    insert(const_iterator pos, size_type count, T const & value) -> iterator
+    {
+        if (pos == end())
+        {
+            return insert_with(pos, count, copies_of(count, value));
+        }
+
+        auto const temp = std::make_obj_using_allocator<T>(m_alloc, value);
+        return insert_with(pos, count, copies_of(count, temp));
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    constexpr auto
+    insert(const_iterator pos, It first, Sentinel last) -> iterator
+    {
+        return insert_range(pos, std::ranges::subrange(first, last));
+    }
+
+    constexpr auto
+    insert(const_iterator pos, std::initializer_list<T> list) -> iterator
+    {
+        return insert_range(pos, list);
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr auto
+    insert_range(const_iterator pos, R&& range) -> iterator
+    {
+        if constexpr (
+            std::ranges::forward_range<R> || std::ranges::sized_range<R>
+        )
+        {
+            // the size is known up front, so we allocate at most once
+            auto const count =
+                static_cast<size_type>(std::ranges::distance(range));
+            return insert_with<false>(
+                pos,
+                count,
+                [&](T* p)
+                { copy_construct(std::ranges::begin(range), count, p); }
+            );
+        }
+        else
+        {
+            size_type const offset   = pos - m_data;
+            size_type const old_size = m_sz;
+            try
+            {
+                for (auto&& x : range)
+                {
+                    emplace_back(std::forward<decltype(x)>(x));
+                }
+            }
+            catch (...)
+            {
+                truncate(m_data + old_size);
+                throw;
+            }
+            std::rotate(m_data + offset, m_data + old_size, end());
+            return m_data + offset;
+        }
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr void
+    append_range(R&& range)
+    {
+        insert_range(end(), std::forward<R>(range));
+    }
+
+    constexpr auto
+    erase(const_iterator pos) -> iterator
+    {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr auto
+    erase(const_iterator first, const_iterator last) -> iterator
+    {
+        T* const efirst = m_data + (first - m_data);
+        if (first != last)
+        {
+            T* const elast = m_data + (last - m_data);
+            m_sz           = erase_in_place(efirst, elast, end()) - m_data;
+        }
+        return efirst;
+    }
+
+    constexpr void
+    assign(size_type count, T const & value)
+    {
+        // value may be an element
+        auto const temp = std::make_obj_using_allocator<T>(m_alloc, value);
+        clear();
+        insert_with(end(), count, copies_of(count, temp));
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+    constexpr void
+    assign(It first, Sentinel last)
+    {
+        assign_range(std::ranges::subrange(first, last));
+    }
+
+    constexpr void
+    assign(std::initializer_list<T> list)
+    {
+        assign_range(list);
+    }
+
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    constexpr void
+    assign_range(R&& range)
+    {
+        clear();
+        append_range(std::forward<R>(range));
+    }
+
+    constexpr void
+    resize(size_type count)
+    {
+        if (count <= m_sz) { truncate(m_data + count); }
+        else
+        {
+            size_type const n = count - m_sz;
+            insert_with<false>(
+                end(),
+                n,
+                [&](T* out)
+                { construct_n(out, n, [&](T* p) { construct(p); }); }
+            );
+        }
+    }
+
+    constexpr void
+    resize(size_type count, T const & value)
+    {
+        if (count <= m_sz) { truncate(m_data + count); }
+        else
+        {
+            size_type const n = count - m_sz;
+            insert_with(end(), n, copies_of(n, value));
+        }
+    }
+
+    // like resize, but new elements are default-initialized, which leaves
+    // them uninitialized if `T` is trivially default constructible
+    constexpr void
+    resize_for_overwrite(size_type count)
+    {
+        if (count <= m_sz) { truncate(m_data + count); }
+        else { append_for_overwrite(count - m_sz); }
+    }
+
+    // appends `count` default-initialized elements, to be written through
+    // the returned span
+    constexpr auto
+    append_for_overwrite(size_type count) -> span<T>
+    {
+        T* const first = insert_with<false>(
+            end(), count, [&](T* out) { default_construct(out, count); }
+        );
+        return {first, count};
+    }
+
+    constexpr void
+    reserve(size_type new_cap)
+    {
+        if (new_cap > max_size()) throw std::length_error("small_vector");
+        if (new_cap > m_capacity) reallocate(new_cap);
+    }
+
+    constexpr void
+    shrink_to_fit()
+    {
+        if (!objects_on_heap() || m_sz == m_capacity) return;
+
+        if (m_sz <= N)
+        {
+            // back into the inline buffer
+            T* const buffer = get_buffer();
+            if constexpr (N > 0) relocate(begin(), end(), buffer);
+            deallocate();
+            m_data     = buffer;
+            m_capacity = N;
+        }
+        else { reallocate(m_sz); }
+    }
+
+    constexpr void
+    clear() noexcept
+    {
+        truncate(m_data);
+    }
+
+private:
+    T*               m_data;
+    stored_size_type m_sz;
+    stored_size_type m_capacity;
+
+    struct emptyS
+    {
+    };
+    using storage_t = std::conditional_t<
+        N == 0,
+        emptyS,
+        std::conditional_t<sbo_can_be_constexpr<T>, T[N], char[N * sizeof(T)]>>;
+    [[no_unique_address]] alignas(T) storage_t m_buffer;
+    [[no_unique_address]] Allocator m_alloc;
+
+    // swaps elements and storage, but not the allocators
+    constexpr void
+    swap_contents(small_vector& other)
+        noexcept(N == 0 || nothrow_relocatable<T>)
     {
         if constexpr (N == 0)
         {
@@ -158,14 +592,17 @@ public:
                         }
                         else
                         {
-                            new_data = v.m_alloc.allocate(v.m_sz);
+                            new_data =
+                                alloc_traits::allocate(v.m_alloc, v.m_sz);
                             try
                             {
                                 relocate(v.begin(), v.end(), new_data);
                             }
                             catch (...)
                             {
-                                v.m_alloc.deallocate(new_data, v.m_sz);
+                                alloc_traits::deallocate(
+                                    v.m_alloc, new_data, v.m_sz
+                                );
                                 throw;
                             }
                             cap = v.m_sz;
@@ -194,41 +631,218 @@ public:
         }
     }
 
+    template <bool propagate, typename Other>
+    constexpr void
+    assign_from(Other&& rhs)
+    {
+        small_vector temp(
+            std::forward<Other>(rhs), propagate ? rhs.m_alloc : m_alloc
+        );
+        swap_contents(temp);
+        if constexpr (propagate)
+        {
+            // temp now owns our old storage, it must free it with our old
+            // allocator
+            using std::swap;
+            swap(m_alloc, temp.m_alloc);
+        }
+    }
+
+    [[nodiscard]] constexpr auto
+    same_storage(small_vector const & other) const noexcept -> bool
+    {
+        return alloc_traits::is_always_equal::value || m_alloc == other.m_alloc;
+    }
+
+    // sets m_data and m_capacity for m_sz elements
+    constexpr void
+    allocate_for_size()
+    {
+        if (m_sz > N)
+        {
+            m_capacity = m_sz;
+            m_data     = alloc_traits::allocate(m_alloc, m_capacity);
+        }
+        else
+        {
+            m_capacity = N;
+            m_data     = get_buffer();
+        }
+    }
+
     template <typename... Args>
-    constexpr auto
-    emplace_back(Args&&... args) -> T&
+    constexpr void
+    construct(T* p, Args&&... args)
     {
-        if (m_sz == m_capacity) grow();
-        T& ret = *std::construct_at(end(), std::forward<Args>(args)...);
-        ++m_sz;
-        return ret;
+        alloc_traits::construct(m_alloc, p, std::forward<Args>(args)...);
     }
 
+    // elements that use the allocator are constructed through it (for
+    // `polymorphic_allocator` this passes the memory resource down to them),
+    // everything else is copied in bulk
+    template <std::input_iterator It>
     constexpr void
-    pop_back() noexcept
+    copy_construct(It first, size_type count, T* out)
     {
-        --m_sz;
-        if constexpr (!std::is_trivially_destructible_v<T>)
+        if constexpr (!std::uses_allocator_v<T, Allocator>)
         {
-            std::destroy_at(end());
+            if !consteval
+            {
+                std::uninitialized_copy_n(first, count, out);
+                return;
+            }
         }
+        construct_n(
+            out,
+            count,
+            [&](T* p)
+            {
+                construct(p, *first);
+                ++first;
+            }
+        );
     }
 
-private:
-    T*        m_data;
-    size_type m_sz;
-    size_type m_capacity;
+    // elements that use the allocator are value-initialized through it,
+    // there is no allocator-aware default-initialization
+    constexpr void
+    default_construct(T* out, size_type count)
+    {
+        if constexpr (std::uses_allocator_v<T, Allocator>)
+        {
+            construct_n(out, count, [&](T* p) { construct(p); });
+        }
+        else { uninitialized_default_construct(out, count); }
+    }
 
-    struct emptyS
+    // a fill for insert_with that constructs `count` copies of `value`
+    constexpr auto
+    copies_of(size_type count, T const & value)
     {
-    };
-    using storage_t = std::conditional_t<
-        N == 0,
-        emptyS,
-        std::conditional_t<sbo_can_be_constexpr<T>, T[N], char[N * sizeof(T)]>>;
-    [[no_unique_address]] alignas(T) storage_t m_buffer;
-    [[no_unique_address]] std::allocator<T> m_alloc;
+        return [this, count, &value](T* out)
+        { construct_n(out, count, [&](T* p) { construct(p, value); }); };
+    }
 
+    // inserts `count` elements at `pos`, `fill(p)` constructs all of them at
+    // p or none; a reallocation constructs them before the old elements are
+    // relocated, an in-place insert after the tail has been shifted.
+    // Without `fill_may_alias` (fill does not read elements of *this), an
+    // append may grow the block in place through the allocator.
+    template <bool fill_may_alias = true, typename Fill>
+    constexpr auto
+    insert_with(const_iterator pos, size_type count, Fill&& fill) -> iterator
+    {
+        size_type const offset = pos - m_data;
+        // m_capacity - m_sz would be an int for a narrow stored size
+        if (count > size_type{m_capacity} - m_sz)
+        {
+            size_type const new_cap = grown_capacity(m_sz + count);
+            if (!fill_may_alias && offset == m_sz && can_reallocate())
+            {
+                reallocate(new_cap);
+                fill(end());
+                m_sz = static_cast<stored_size_type>(m_sz + count);
+                return m_data + offset;
+            }
+
+            T* const new_data = alloc_traits::allocate(m_alloc, new_cap);
+            try
+            {
+                fill(new_data + offset);
+                try
+                {
+                    relocate_around(new_data, offset, count);
+                }
+                catch (...)
+                {
+                    std::destroy(new_data + offset, new_data + offset + count);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                alloc_traits::deallocate(m_alloc, new_data, new_cap);
+                throw;
+            }
+            deallocate();
+            m_data     = new_data;
+            m_capacity = new_cap;
+        }
+        else { insert_in_place(m_data + offset, end(), count, fill); }
+        m_sz = static_cast<stored_size_type>(m_sz + count);
+        return m_data + offset;
+    }
+
+    // capacity for at least `min_cap` elements, `m_capacity` times the
+    // growth factor if that is more, capped at `max_size()`
+    [[nodiscard]] constexpr auto
+    grown_capacity(size_type min_cap) const -> size_type
+    {
+        if (min_cap > max_size() || min_cap < m_sz)
+        {
+            throw std::length_error("small_vector");
+        }
+        size_type const grown = size_type{m_capacity}
+                              * Options::growth_numerator
+                              / Options::growth_denominator;
+        return std::clamp(grown, min_cap, max_size());
+    }
+
+    // relocates the elements to new_data, leaving a gap of `count` elements
+    // at `offset`
+    constexpr void
+    relocate_around(T* new_data, size_type offset, size_type count)
+    {
+        T* const mid = m_data + offset;
+        if constexpr (nothrow_relocatable<T>)
+        {
+            relocate(m_data, mid, new_data);
+            relocate(mid, end(), new_data + offset + count);
+        }
+        else
+        {
+            // move or copy both halves before destroying anything, so that
+            // *this is untouched if one throws
+            uninitialized_move_if_noexcept(m_data, mid, new_data);
+            try
+            {
+                uninitialized_move_if_noexcept(
+                    mid, end(), new_data + offset + count
+                );
+            }
+            catch (...)
+            {
+                std::destroy(new_data, new_data + offset);
+                throw;
+            }
+            std::destroy(m_data, end());
+        }
+    }
+
+    constexpr void
+    relocate_construct(T* first, T* last, T* out)
+    {
+        if constexpr (std::uses_allocator_v<T, Allocator>)
+        {
+            T* curr = out;
+            try
+            {
+                for (T* it = first; it != last; ++it, ++curr)
+                {
+                    alloc_traits::construct(
+                        m_alloc, curr, std::move_if_noexcept(*it)
+                    );
+                }
+            }
+            catch (...)
+            {
+                std::destroy(out, curr);
+                throw;
+            }
+            std::destroy(first, last);
+        }
+        else { relocate(first, last, out); }
+    }
 
     [[nodiscard]] constexpr auto
     get_buffer() noexcept -> T*
@@ -245,18 +859,40 @@ private:
         else { return m_data != get_buffer(); }
     }
 
+    // whether the allocator can resize our heap block itself (e.g. with
+    // mremap), moving the elements as raw bytes
+    [[nodiscard]] constexpr auto
+    can_reallocate() noexcept -> bool
+    {
+        if constexpr (
+            reallocating_allocator<Allocator, T>
+            && __is_trivially_relocatable(T)
+        )
+        {
+            if consteval { return false; }
+            else { return objects_on_heap() && m_data != nullptr; }
+        }
+        else { return false; }
+    }
+
     constexpr void
-    grow()
+    reallocate(size_type new_cap)
     {
-        size_type new_cap  = std::max(1ul, m_capacity * 2);
-        T*        new_data = m_alloc.allocate(new_cap);
+        if (can_reallocate())
+        {
+            m_data     = m_alloc.reallocate(m_data, m_capacity, new_cap);
+            m_capacity = new_cap;
+            return;
+        }
+
+        T* new_data = alloc_traits::allocate(m_alloc, new_cap);
         try
         {
             relocate(begin(), end(), new_data);
         }
         catch (...)
         {
-            m_alloc.deallocate(new_data, new_cap);
+            alloc_traits::deallocate(m_alloc, new_data, new_cap);
             throw;
         }
         deallocate();
@@ -269,10 +905,20 @@ private:
     {
         if (objects_on_heap() && m_data != nullptr)
         {
-            m_alloc.deallocate(m_data, m_capacity);
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
         }
     }
 
+    constexpr void
+    truncate(T* new_end) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::destroy(new_end, end());
+        }
+        m_sz = new_end - m_data;
+    }
+
     constexpr void
     destroy_all() noexcept
     {
@@ -286,13 +932,69 @@ private:
     }
 };
 
-export template <typename T, std::size_t N>
+export template <
+    typename T,
+    std::size_t N,
+    typename Allocator,
+    typename Options>
 constexpr void
-swap(small_vector<T, N>& v1, small_vector<T, N>& v2)
-    noexcept(noexcept(v1.swap(v2)))
+swap(
+    small_vector<T, N, Allocator, Options>& v1,
+    small_vector<T, N, Allocator, Options>& v2
+) noexcept(noexcept(v1.swap(v2)))
 {
     v1.swap(v2);
 }
 
+// bytes in front of the inline buffer: data pointer, size and capacity
+template <typename T, typename Options>
+inline constexpr std::size_t small_vector_header =
+    sizeof(T*) + 2 * sizeof(typename Options::stored_size_type);
+
+// largest inline capacity for which the whole small_vector fits in `Bytes`,
+// counting down from an upper bound, the compiler knows the padding
+template <
+    typename T,
+    std::size_t Bytes,
+    typename Allocator,
+    typename Options,
+    std::size_t N>
+consteval auto
+fit_inline_capacity() -> std::size_t
+{
+    if constexpr (
+        N == 0 || sizeof(small_vector<T, N, Allocator, Options>) <= Bytes
+    )
+    {
+        return N;
+    }
+    else { return fit_inline_capacity<T, Bytes, Allocator, Options, N - 1>(); }
+}
+
+// inline capacity that fills a small_vector up to `Bytes`, e.g. one cache
+// line: `small_vector<int, inline_capacity_for<int, 64>>` holds 10 ints, 12
+// with `small_vector_options<std::uint32_t>`
+export template <
+    typename T,
+    std::size_t Bytes,
+    typename Allocator = std::allocator<T>,
+    typename Options   = small_vector_options<>>
+inline constexpr std::size_t inline_capacity_for = fit_inline_capacity<
+    T,
+    Bytes,
+    Allocator,
+    Options,
+    Bytes <= small_vector_header<T, Options>
+        ? 0
+        : (Bytes - small_vector_header<T, Options>) / sizeof(T)>();
+
+namespace pmr
+{
+
+export template <typename T, std::size_t N>
+using small_vector =
+    tinystd::small_vector<T, N, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
 
 } // namespace tinystd
\ No newline at end of file
@@ -0,0 +1,517 @@
+module;
+#include <new> // `std::hardware_destructive_interference_size` not available in std module
+
+export module tinystd:soa_vector;
+
+import std;
+import :span;
+import :vector_mixin;
+
+namespace tinystd
+{
+
+// Structure-of-arrays vector: row i is the tuple of the i-th elements of one
+// column per type in Ts.
+// - All columns live in one allocation, every column starts on its own cache
+//   line, so a loop over a few columns only pulls those through the cache.
+// - Rows are accessed through proxy references, `std::tuple<Ts&...>`.
+// - Growth relocates every column with `relocate` (a memcpy for trivially
+//   relocatable types), so all Ts must be nothrow relocatable.
+export template <typename... Ts>
+    requires(sizeof...(Ts) > 0 && (nothrow_relocatable<Ts> && ...))
+class soa_vector
+{
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    using columns_t = std::tuple<Ts*...>;
+
+    static constexpr std::size_t column_align =
+        std::max({std::hardware_destructive_interference_size, alignof(Ts)...});
+
+public:
+    using size_type       = std::size_t;
+    using value_type      = std::tuple<Ts...>;
+    using reference       = std::tuple<Ts&...>;
+    using const_reference = std::tuple<Ts const &...>;
+
+private:
+    // random access iterator over rows, dereferences to a proxy reference
+    template <bool Const>
+    class row_iterator
+    {
+        using vector_t =
+            std::conditional_t<Const, soa_vector const, soa_vector>;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::tuple<Ts...>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<
+            Const,
+            soa_vector::const_reference,
+            soa_vector::reference>;
+
+        row_iterator() noexcept = default;
+
+        row_iterator(vector_t* vector, size_type i) noexcept
+            : m_vector{vector}
+            , m_i{static_cast<difference_type>(i)}
+        {
+        }
+
+        // iterator to const_iterator
+        row_iterator(row_iterator<!Const> const & other) noexcept
+            requires Const
+            : m_vector{other.m_vector}
+            , m_i{other.m_i}
+        {
+        }
+
+        [[nodiscard]] auto
+        operator*() const noexcept -> reference
+        {
+            return (*m_vector)[m_i];
+        }
+
+        [[nodiscard]] auto
+        operator[](difference_type n) const noexcept -> reference
+        {
+            return (*m_vector)[m_i + n];
+        }
+
+        auto
+        operator++() noexcept -> row_iterator&
+        {
+            ++m_i;
+            return *this;
+        }
+
+        auto
+        operator++(int) noexcept -> row_iterator
+        {
+            auto copy = *this;
+            ++m_i;
+            return copy;
+        }
+
+        auto
+        operator--() noexcept -> row_iterator&
+        {
+            --m_i;
+            return *this;
+        }
+
+        auto
+        operator--(int) noexcept -> row_iterator
+        {
+            auto copy = *this;
+            --m_i;
+            return copy;
+        }
+
+        auto
+        operator+=(difference_type n) noexcept -> row_iterator&
+        {
+            m_i += n;
+            return *this;
+        }
+
+        auto
+        operator-=(difference_type n) noexcept -> row_iterator&
+        {
+            m_i -= n;
+            return *this;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(row_iterator it, difference_type n) noexcept -> row_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator+(difference_type n, row_iterator it) noexcept -> row_iterator
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(row_iterator it, difference_type n) noexcept -> row_iterator
+        {
+            return it -= n;
+        }
+
+        [[nodiscard]] friend auto
+        operator-(row_iterator const & lhs, row_iterator const & rhs) noexcept
+            -> difference_type
+        {
+            return lhs.m_i - rhs.m_i;
+        }
+
+        [[nodiscard]] friend auto
+        operator==(row_iterator const & lhs, row_iterator const & rhs) noexcept
+            -> bool
+        {
+            return lhs.m_i == rhs.m_i;
+        }
+
+        [[nodiscard]] friend auto
+        operator<=>(row_iterator const & lhs, row_iterator const & rhs) noexcept
+        {
+            return lhs.m_i <=> rhs.m_i;
+        }
+
+    private:
+        friend class row_iterator<!Const>;
+
+        vector_t*       m_vector = nullptr;
+        difference_type m_i      = 0;
+    };
+
+public:
+    using iterator       = row_iterator<false>;
+    using const_iterator = row_iterator<true>;
+
+    // constructors
+    soa_vector() noexcept = default;
+
+    soa_vector(soa_vector const & other)
+    {
+        if (other.m_sz == 0) return;
+        m_block    = allocate_block(other.m_sz);
+        m_columns  = columns_of(m_block, other.m_sz);
+        m_capacity = other.m_sz;
+        try
+        {
+            copy_columns(other);
+        }
+        catch (...)
+        {
+            deallocate_block(m_block, m_capacity);
+            throw;
+        }
+        m_sz = other.m_sz;
+    }
+
+    soa_vector(soa_vector&& other) noexcept
+        : m_block{std::exchange(other.m_block, nullptr)}
+        , m_columns{std::exchange(other.m_columns, columns_t{})}
+        , m_sz{std::exchange(other.m_sz, 0)}
+        , m_capacity{std::exchange(other.m_capacity, 0)}
+    {
+    }
+
+    // assignment, copy-swap as for the other vectors
+    auto
+    operator=(soa_vector rhs) noexcept -> soa_vector&
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    // destructor
+    ~soa_vector() noexcept
+    {
+        clear();
+        deallocate_block(m_block, m_capacity);
+    }
+
+    // access and observers
+    [[nodiscard]] auto
+    size() const noexcept -> size_type
+    {
+        return m_sz;
+    }
+
+    [[nodiscard]] auto
+    capacity() const noexcept -> size_type
+    {
+        return m_capacity;
+    }
+
+    [[nodiscard]] auto
+    empty() const noexcept -> bool
+    {
+        return m_sz == 0;
+    }
+
+    template <std::size_t I>
+    [[nodiscard]] auto
+    column() noexcept -> span<column_type<I>>
+    {
+        return {std::get<I>(m_columns), m_sz};
+    }
+
+    template <std::size_t I>
+    [[nodiscard]] auto
+    column() const noexcept -> span<column_type<I> const>
+    {
+        return {std::get<I>(m_columns), m_sz};
+    }
+
+    [[nodiscard]] auto
+    operator[](size_type i) noexcept -> reference
+    {
+        return std::apply(
+            [i](Ts*... columns) { return reference{columns[i]...}; }, m_columns
+        );
+    }
+
+    [[nodiscard]] auto
+    operator[](size_type i) const noexcept -> const_reference
+    {
+        return std::apply(
+            [i](Ts*... columns) { return const_reference{columns[i]...}; },
+            m_columns
+        );
+    }
+
+    [[nodiscard]] auto
+    begin() noexcept -> iterator
+    {
+        return {this, 0};
+    }
+
+    [[nodiscard]] auto
+    end() noexcept -> iterator
+    {
+        return {this, m_sz};
+    }
+
+    [[nodiscard]] auto
+    begin() const noexcept -> const_iterator
+    {
+        return {this, 0};
+    }
+
+    [[nodiscard]] auto
+    end() const noexcept -> const_iterator
+    {
+        return {this, m_sz};
+    }
+
+    // modifiers
+    void
+    swap(soa_vector& other) noexcept
+    {
+        std::swap(m_block, other.m_block);
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_sz, other.m_sz);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    // constructs the fields of a new row, one argument per column
+    template <typename... Args>
+        requires(
+            sizeof...(Args) == sizeof...(Ts)
+            && (std::constructible_from<Ts, Args> && ...)
+        )
+    auto
+    emplace_back(Args&&... fields) -> reference
+    {
+        if (m_sz == m_capacity) [[unlikely]]
+        {
+            // the fields may refer to a row, so construct the new row before
+            // the old ones are relocated
+            size_type const  new_cap = std::max(size_type{1}, m_capacity * 2);
+            std::byte* const block   = allocate_block(new_cap);
+            columns_t const  columns = columns_of(block, new_cap);
+            try
+            {
+                construct_row(columns, m_sz, std::forward<Args>(fields)...);
+            }
+            catch (...)
+            {
+                deallocate_block(block, new_cap);
+                throw;
+            }
+            relocate_columns(columns);
+            deallocate_block(m_block, m_capacity);
+            m_block    = block;
+            m_columns  = columns;
+            m_capacity = new_cap;
+        }
+        else { construct_row(m_columns, m_sz, std::forward<Args>(fields)...); }
+        ++m_sz;
+        return (*this)[m_sz - 1];
+    }
+
+    void
+    pop_back() noexcept
+    {
+        destroy_rows(m_sz - 1);
+        --m_sz;
+    }
+
+    void
+    clear() noexcept
+    {
+        destroy_rows(0);
+        m_sz = 0;
+    }
+
+    void
+    reserve(size_type new_cap)
+    {
+        if (new_cap <= m_capacity) return;
+        std::byte* const block   = allocate_block(new_cap);
+        columns_t const  columns = columns_of(block, new_cap);
+        relocate_columns(columns);
+        deallocate_block(m_block, m_capacity);
+        m_block    = block;
+        m_columns  = columns;
+        m_capacity = new_cap;
+    }
+
+private:
+    std::byte* m_block = nullptr;
+    columns_t  m_columns{};
+    size_type  m_sz       = 0;
+    size_type  m_capacity = 0;
+
+    // byte offset of every column in a block for `capacity` rows, the last
+    // entry is the size of the block
+    [[nodiscard]] static auto
+    layout(size_type capacity) noexcept
+        -> std::array<std::size_t, sizeof...(Ts) + 1>
+    {
+        std::array<std::size_t, sizeof...(Ts) + 1> offsets{};
+        std::size_t                                 column = 0;
+        std::size_t                                 offset = 0;
+
+        auto const add_column = [&](std::size_t bytes)
+        {
+            offsets[column++] = offset;
+            offset = (offset + bytes + column_align - 1) & ~(column_align - 1);
+        };
+        (add_column(capacity * sizeof(Ts)), ...);
+        offsets[column] = offset;
+        return offsets;
+    }
+
+    [[nodiscard]] static auto
+    columns_of(std::byte* block, size_type capacity) noexcept -> columns_t
+    {
+        auto const offsets = layout(capacity);
+        return [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            return columns_t{
+                reinterpret_cast<column_type<I>*>(block + offsets[I])...
+            };
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    [[nodiscard]] static auto
+    allocate_block(size_type capacity) -> std::byte*
+    {
+        return static_cast<std::byte*>(::operator new(
+            layout(capacity).back(), std::align_val_t{column_align}
+        ));
+    }
+
+    static void
+    deallocate_block(std::byte* block, size_type capacity) noexcept
+    {
+        if (block == nullptr) return;
+        ::operator delete(
+            block, layout(capacity).back(), std::align_val_t{column_align}
+        );
+    }
+
+    // constructs row i in `columns`, either all fields or, if one throws,
+    // none
+    template <typename... Args>
+    static void
+    construct_row(columns_t const & columns, size_type i, Args&&... fields)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            std::size_t constructed = 0;
+            try
+            {
+                (
+                    (std::construct_at(
+                         std::get<I>(columns) + i, std::forward<Args>(fields)
+                     ),
+                     ++constructed),
+                    ...
+                );
+            }
+            catch (...)
+            {
+                ((I < constructed ? std::destroy_at(std::get<I>(columns) + i)
+                                  : void()),
+                 ...);
+                throw;
+            }
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    void
+    relocate_columns(columns_t const & columns) noexcept
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (relocate(
+                 std::get<I>(m_columns),
+                 std::get<I>(m_columns) + m_sz,
+                 std::get<I>(columns)
+             ),
+             ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    // copies every column of `other` into our block, which has room for
+    // them; if one throws, the columns copied so far are destroyed
+    void
+    copy_columns(soa_vector const & other)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            std::size_t copied = 0;
+            try
+            {
+                ((uninitialized_copy(
+                      std::get<I>(other.m_columns),
+                      std::get<I>(other.m_columns) + other.m_sz,
+                      std::get<I>(m_columns)
+                  ),
+                  ++copied),
+                 ...);
+            }
+            catch (...)
+            {
+                auto const destroy = [&](auto* column, std::size_t index)
+                {
+                    if (index < copied) std::destroy_n(column, other.m_sz);
+                };
+                (destroy(std::get<I>(m_columns), I), ...);
+                throw;
+            }
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    // destroys the rows from `first` on
+    void
+    destroy_rows(size_type first) noexcept
+    {
+        std::apply(
+            [&](Ts*... columns)
+            {
+                (std::destroy(columns + first, columns + m_sz), ...);
+            },
+            m_columns
+        );
+    }
+};
+
+export template <typename... Ts>
+void
+swap(soa_vector<Ts...>& v1, soa_vector<Ts...>& v2) noexcept
+{
+    v1.swap(v2);
+}
+
+} // namespace tinystd
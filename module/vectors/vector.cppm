@@ -6,7 +6,18 @@ import :small_vector;
 namespace tinystd
 {
 
+export template <
+    typename T,
+    typename Allocator = std::allocator<T>,
+    typename Options   = small_vector_options<>>
+using vector = small_vector<T, 0, Allocator, Options>;
+
+namespace pmr
+{
+
 export template <typename T>
-using vector = small_vector<T, 0>;
+using vector = tinystd::vector<T, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
 
-} // namespace tinystd
\ No newline at end of file
+} // namespace tinystd
@@ -14,6 +14,26 @@ template <typename T>
 concept sbo_can_be_constexpr =
     std::is_trivially_constructible_v<T> && std::is_trivially_destructible_v<T>;
 
+// default-initialization leaves these objects uninitialized
+template <typename T>
+concept default_init_is_noop = std::is_trivially_default_constructible_v<T>;
+
+// allocators that can resize a block themselves, like
+// huge_buffer_allocator; the old block is invalid afterwards
+template <typename Allocator, typename T>
+concept reallocating_allocator =
+    requires(Allocator& alloc, T* p, std::size_t n) {
+        { alloc.reallocate(p, n, n) } -> std::same_as<T*>;
+    };
+
+export struct default_init_t
+{
+    explicit default_init_t() = default;
+};
+
+// tag for constructors that default-initialize their elements
+export inline constexpr default_init_t default_init{};
+
 template <typename T>
 constexpr void
 uninitialized_copy(T* ifirst, T* ilast, T* ofirst)
@@ -28,6 +48,49 @@ uninitialized_copy(T* ifirst, T* ilast, T* ofirst)
     else { std::uninitialized_copy(ifirst, ilast, ofirst); }
 }
 
+template <typename T>
+constexpr void
+uninitialized_move_if_noexcept(T* ifirst, T* ilast, T* ofirst)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+{
+    T* oCurr = ofirst;
+    try
+    {
+        for (; ifirst != ilast; ++ifirst, ++oCurr)
+        {
+            // might throw here
+            std::construct_at(oCurr, std::move_if_noexcept(*ifirst));
+        }
+    }
+    catch (...)
+    {
+        std::destroy(ofirst, oCurr);
+        throw;
+    }
+}
+
+template <typename T>
+constexpr void
+uninitialized_default_construct(T* ofirst, std::size_t count)
+{
+    if consteval
+    {
+        // objects have to be alive before they are written in constant
+        // evaluation, so they are value-initialized instead
+        for (T* oLast = ofirst + count; ofirst != oLast; ++ofirst)
+        {
+            std::construct_at(ofirst);
+        }
+    }
+    else
+    {
+        if constexpr (!default_init_is_noop<T>)
+        {
+            std::uninitialized_default_construct_n(ofirst, count);
+        }
+    }
+}
+
 template <typename T>
 constexpr void
 relocate(T* ifirst, T* ilast, T* ofirst) noexcept(nothrow_relocatable<T>)
@@ -51,29 +114,134 @@ relocate(T* ifirst, T* ilast, T* ofirst) noexcept(nothrow_relocatable<T>)
         }
         else
         {
-            T* oCurr = ofirst;
-            T* iCurr = ifirst;
-            try
-            {
-                // unitialized_move_if_noexcept
-                for (; iCurr != ilast; ++iCurr, ++oCurr)
-                {
-                    // might throw here
-                    std::construct_at(oCurr, std::move_if_noexcept(*iCurr));
-                }
-
-                // destroy all objects in input range
-                std::destroy(ifirst, ilast);
-            }
-            catch (...)
-            {
-                std::destroy(ofirst, oCurr);
-                throw;
-            }
+            uninitialized_move_if_noexcept(ifirst, ilast, ofirst);
+
+            // destroy all objects in input range
+            std::destroy(ifirst, ilast);
+        }
+    }
+}
+
+// relocate into a range that may overlap the input range, used to shift the
+// tail of a vector for insert and erase
+template <typename T>
+constexpr void
+relocate_overlapping(T* ifirst, T* ilast, T* ofirst) noexcept
+    requires nothrow_relocatable<T>
+{
+    if (ifirst == ofirst) return;
+    if !consteval
+    {
+        if constexpr (__is_trivially_relocatable(T))
+        {
+            std::memmove(ofirst, ifirst, sizeof(T) * (ilast - ifirst));
+            return;
+        }
+    }
+
+    auto relocate_one = [](T* from, T* to)
+    {
+        std::construct_at(to, std::move(*from));
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::destroy_at(from);
+        }
+    };
+    if (ofirst < ifirst)
+    {
+        for (; ifirst != ilast; ++ifirst, ++ofirst)
+        {
+            relocate_one(ifirst, ofirst);
+        }
+    }
+    else
+    {
+        // backwards, so that no element is overwritten before it is moved
+        for (T* oLast = ofirst + (ilast - ifirst); ilast != ifirst;)
+        {
+            relocate_one(--ilast, --oLast);
         }
     }
 }
 
+// constructs `count` objects at `out` with `make(p)`, either all of them or,
+// if one throws, none
+template <typename T, typename Make>
+constexpr void
+construct_n(T* out, std::size_t count, Make&& make)
+{
+    T* curr = out;
+    try
+    {
+        for (; curr != out + count; ++curr) make(curr);
+    }
+    catch (...)
+    {
+        std::destroy(out, curr);
+        throw;
+    }
+}
+
+// inserts `count` objects at `pos` into [.., last), which must have room for
+// them past `last`; `fill(p)` constructs all of them at p or none
+template <typename T, typename Fill>
+constexpr void
+insert_in_place(T* pos, T* last, std::size_t count, Fill&& fill)
+{
+    if constexpr (nothrow_relocatable<T>)
+    {
+        // open a gap by shifting the tail, then construct into it, shifting
+        // back if that throws
+        relocate_overlapping(pos, last, pos + count);
+        try
+        {
+            fill(pos);
+        }
+        catch (...)
+        {
+            relocate_overlapping(pos + count, last + count, pos);
+            throw;
+        }
+    }
+    else
+    {
+        // a shift could not be undone, construct at the end and rotate into
+        // place instead (basic exception guarantee)
+        fill(last);
+        try
+        {
+            std::rotate(pos, last, last + count);
+        }
+        catch (...)
+        {
+            std::destroy(last, last + count);
+            throw;
+        }
+    }
+}
+
+// erases [efirst, elast) from [.., last), returns the new end
+template <typename T>
+constexpr auto
+erase_in_place(T* efirst, T* elast, T* last) -> T*
+{
+    if constexpr (nothrow_relocatable<T>)
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::destroy(efirst, elast);
+        }
+        relocate_overlapping(elast, last, efirst);
+        return last - (elast - efirst);
+    }
+    else
+    {
+        T* new_last = std::move(elast, last, efirst);
+        std::destroy(new_last, last);
+        return new_last;
+    }
+}
+
 export template <class T>
 struct vector_mixin
 {
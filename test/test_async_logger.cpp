@@ -0,0 +1,199 @@
+#include <boost/ut.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// a temporary file the logger writes to
+class log_file
+{
+public:
+    log_file()
+        : m_path{
+              std::filesystem::temp_directory_path()
+              / ("tinystd_async_logger_" + std::to_string(::getpid()))
+          }
+        , m_fd{::open(m_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600)}
+    {
+    }
+
+    ~log_file()
+    {
+        ::close(m_fd);
+        std::filesystem::remove(m_path);
+    }
+
+    auto
+    fd() const noexcept -> int
+    {
+        return m_fd;
+    }
+
+    auto
+    lines() const -> std::vector<std::string>
+    {
+        std::ifstream            in{m_path};
+        std::vector<std::string> result;
+        for (std::string line; std::getline(in, line);) result.push_back(line);
+        return result;
+    }
+
+private:
+    std::filesystem::path m_path;
+    int                   m_fd;
+};
+
+// trivially copyable, but not default constructible
+struct point
+{
+    constexpr point(int px, int py) noexcept : x{px}, y{py} {}
+
+    int x;
+    int y;
+};
+
+template <>
+struct std::formatter<point> : std::formatter<int>
+{
+    auto
+    format(point const & p, std::format_context& ctx) const
+    {
+        return std::format_to(ctx.out(), "({}, {})", p.x, p.y);
+    }
+};
+
+suite<"async_logger"> test_async_logger = []
+{
+    "formatting"_test = []
+    {
+        log_file file;
+        {
+            async_logger     logger(file.fd());
+            std::string      str  = "string";
+            std::string_view view = "view";
+            logger.log("no arguments");
+            logger.log(
+                "{} {:.2f} {} {} {} {}", 42, 3.14159, str, view, "literal", true
+            );
+            logger.log("{:>5}|{:x}", 'c', 255u);
+            logger.log("{}", point{1, 2});
+        }
+        auto const lines = file.lines();
+        expect(lines.size() == 4_u);
+        expect(lines[0] == "no arguments");
+        expect(lines[1] == "42 3.14 string view literal true");
+        expect(lines[2] == "    c|ff");
+        expect(lines[3] == "(1, 2)");
+    };
+
+    "long strings are truncated"_test = []
+    {
+        log_file file;
+        {
+            async_logger logger(file.fd());
+            logger.log("{}|{}", std::string(1000, 'x'), 7);
+        }
+        auto const lines = file.lines();
+        expect(fatal(lines.size() == 1_u));
+        expect(lines[0].ends_with("|7"));
+        expect(lines[0].size() < log_record_size);
+    };
+
+    "flush"_test = []
+    {
+        log_file     file;
+        async_logger logger(file.fd());
+        for (int i = 0; i < 100; ++i) logger.log("line {}", i);
+        logger.flush();
+        expect(file.lines().size() == 100_u);
+    };
+
+    "concurrent producers"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 20000;
+
+        log_file file;
+        {
+            async_logger logger(file.fd(), log_overflow::block, 64);
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back(
+                    [&, t]
+                    {
+                        for (int i = 0; i < ITERATIONS; ++i)
+                        {
+                            logger.log("{} {}", t, i);
+                        }
+                    }
+                );
+            }
+        }
+
+        // every line is written once, in order per thread
+        std::array<int, NUM_THREADS> next{};
+        for (auto const & line : file.lines())
+        {
+            int t = -1;
+            int i = -1;
+            std::istringstream{line} >> t >> i;
+            expect(fatal(t >= 0 && t < NUM_THREADS));
+            expect(fatal(i == next[t]));
+            ++next[t];
+        }
+        for (int t = 0; t < NUM_THREADS; ++t)
+        {
+            expect(next[t] == ITERATIONS);
+        }
+    };
+
+    "queue of an exited thread is drained"_test = []
+    {
+        constexpr int ITERATIONS = 1000;
+
+        log_file    file;
+        std::size_t dropped = 0;
+        {
+            // the queue holds 8 records, more than the capacity passed, and
+            // is full when the thread exits while the drain thread sleeps
+            async_logger logger(
+                file.fd(), log_overflow::drop, 5, std::chrono::milliseconds{50}
+            );
+            std::jthread(
+                [&]
+                {
+                    for (int i = 0; i < ITERATIONS; ++i) logger.log("{}", i);
+                }
+            ).join();
+            logger.flush();
+            dropped = logger.dropped();
+        }
+        expect(file.lines().size() + dropped == std::size_t{ITERATIONS});
+        expect(file.lines().size() >= 8_u);
+    };
+
+    "dropped records are counted"_test = []
+    {
+        constexpr int ITERATIONS = 100000;
+
+        log_file    file;
+        std::size_t dropped = 0;
+        {
+            async_logger logger(file.fd(), log_overflow::drop, 16);
+            for (int i = 0; i < ITERATIONS; ++i) logger.log("{}", i);
+            logger.flush();
+            dropped = logger.dropped();
+        }
+        expect(file.lines().size() + dropped == std::size_t{ITERATIONS});
+    };
+};
+
+int
+main()
+{
+}
@@ -16,6 +16,19 @@ struct TestObject
 };
 std::atomic<int> TestObject::instance_count(0);
 
+// records whether the object with the value `watched` was destroyed
+struct WatchedObject
+{
+    int                             value;
+    static inline int               watched = -1;
+    static inline std::atomic<bool> destroyed{false};
+    WatchedObject(int v) : value(v) {}
+    ~WatchedObject()
+    {
+        if (value == watched) destroyed = true;
+    }
+};
+
 suite<"atomic_shared_ptr"> atomic_shared_ptr_test = []
 {
     "default constructor"_test = []
@@ -100,6 +113,32 @@ suite<"atomic_shared_ptr"> atomic_shared_ptr_test = []
         expect(expected->value == 10_i);
     };
 
+    "wait and notify"_test = []
+    {
+        atomic_shared_ptr<TestObject> asp(make_shared<TestObject>(10));
+        // returns immediately if the value has changed
+        asp.wait(make_shared<TestObject>(5));
+
+        std::atomic<bool> woken{false};
+        std::jthread      waiter(
+            [&, old = asp.load()]
+            {
+                asp.wait(old);
+                woken = true;
+                expect(asp.load()->value == 20_i);
+            }
+        );
+        std::this_thread::sleep_for(10ms);
+        asp.notify_all(); // value unchanged, the waiter keeps waiting
+        std::this_thread::sleep_for(10ms);
+        expect(!woken);
+
+        asp.store(make_shared<TestObject>(20));
+        asp.notify_one();
+        waiter.join();
+        expect(woken);
+    };
+
     "concurrent operations"_test = []
     {
         atomic_shared_ptr<TestObject> asp(make_shared<TestObject>(0));
@@ -141,7 +180,251 @@ suite<"atomic_shared_ptr"> atomic_shared_ptr_test = []
     };
 };
 
-template <typename T>
+suite<"atomic_shared_ptr with split_count_policy"> split_count_test = []
+{
+    using split_atomic_shared_ptr =
+        atomic_shared_ptr<TestObject, split_count_policy>;
+
+    "load and store"_test = []
+    {
+        {
+            split_atomic_shared_ptr asp;
+            expect(!asp.load());
+            shared_ptr<TestObject> sp1 = make_shared<TestObject>(10);
+            asp.store(sp1);
+            shared_ptr<TestObject> sp2 = asp.load();
+            expect(sp2->value == 10_i);
+            expect(eq(sp1, sp2));
+            asp.store(make_shared<TestObject>(20));
+            expect(asp.load()->value == 20_i);
+            expect(TestObject::instance_count.load() == 2_i);
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+
+    "exchange"_test = []
+    {
+        {
+            split_atomic_shared_ptr asp(make_shared<TestObject>(10));
+            auto                    loaded = asp.load();
+            auto old = asp.exchange(make_shared<TestObject>(20));
+            expect(old->value == 10_i);
+            expect(eq(old, loaded));
+            expect(asp.load()->value == 20_i);
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+
+    "compare_exchange"_test = []
+    {
+        {
+            split_atomic_shared_ptr asp(make_shared<TestObject>(10));
+            shared_ptr<TestObject>  expected = make_shared<TestObject>(5);
+            shared_ptr<TestObject>  desired  = make_shared<TestObject>(20);
+            expect(!asp.compare_exchange_strong(expected, std::move(desired)));
+            expect(expected->value == 10_i);
+            expect(desired->value == 20_i);
+            expect(asp.compare_exchange_strong(expected, std::move(desired)));
+            expect(asp.load()->value == 20_i);
+            expect(!desired);
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+
+    "wait and notify"_test = []
+    {
+        split_atomic_shared_ptr asp(make_shared<TestObject>(10));
+        std::jthread            waiter(
+            [&, old = asp.load()]
+            {
+                asp.wait(old);
+                expect(asp.load()->value == 20_i);
+            }
+        );
+        // loads change the local count only, the waiter keeps waiting
+        for (int i = 0; i < 100; ++i) expect(asp.load()->value == 10_i);
+        asp.notify_all();
+        std::this_thread::sleep_for(10ms);
+
+        asp.store(make_shared<TestObject>(20));
+        asp.notify_all();
+    };
+
+    "refill reserved counts"_test = []
+    {
+        {
+            // hold enough loaded shared_ptrs to exhaust the counts reserved
+            // by a single installation several times
+            split_atomic_shared_ptr             asp(make_shared<TestObject>(1));
+            std::vector<shared_ptr<TestObject>> loaded(300000);
+            for (auto& sp : loaded) sp = asp.load();
+            asp.store(nullptr);
+            expect(loaded.back().use_count() == 300000_l);
+            loaded.clear();
+            expect(TestObject::instance_count.load() == 0_i);
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+
+    "concurrent operations"_test = []
+    {
+        split_atomic_shared_ptr asp(make_shared<TestObject>(0));
+        std::atomic<int>        success_count(0);
+
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 10000;
+
+        std::vector<std::jthread> threads;
+
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        shared_ptr<TestObject> expected = asp.load();
+                        shared_ptr<TestObject> desired =
+                            make_shared<TestObject>(expected->value + 1);
+                        if (asp.compare_exchange_weak(
+                                expected, std::move(desired)
+                            ))
+                        {
+                            success_count.fetch_add(
+                                1, std::memory_order_relaxed
+                            );
+                        }
+                    }
+                }
+            );
+        }
+
+        threads.clear(); // Join all threads
+
+        expect(asp.load()->value == success_count.load());
+        expect(TestObject::instance_count.load() == 1_i);
+    };
+};
+
+// Objects released by a snapshot_policy atomic_shared_ptr are destroyed at a
+// later hazard pointer scan, so instance counts are compared with the count
+// at the start of each test instead of 0.
+suite<"atomic_shared_ptr with snapshot_policy"> snapshot_test = []
+{
+    using snapshot_atomic_shared_ptr =
+        atomic_shared_ptr<TestObject, snapshot_policy>;
+
+    "empty snapshot"_test = []
+    {
+        snapshot_atomic_shared_ptr asp;
+        auto                       snap = asp.load_snapshot();
+        expect(!snap);
+        expect(!snap.to_shared());
+    };
+
+    "load_snapshot"_test = []
+    {
+        shared_ptr<TestObject>     sp = make_shared<TestObject>(10);
+        snapshot_atomic_shared_ptr asp(sp);
+        {
+            auto snap = asp.load_snapshot();
+            expect(snap->value == 10_i);
+            expect(snap.get() == sp.get());
+            // no count is taken by the snapshot
+            expect(sp.use_count() == 2_l);
+
+            auto moved = std::move(snap);
+            expect(!snap);
+            expect(moved->value == 10_i);
+        }
+        expect(asp.load()->value == 10_i);
+    };
+
+    "snapshot keeps the object alive"_test = []
+    {
+        auto const                 base = TestObject::instance_count.load();
+        snapshot_atomic_shared_ptr asp(make_shared<TestObject>(10));
+        auto                       snap = asp.load_snapshot();
+        asp.store(make_shared<TestObject>(20));
+        expect(TestObject::instance_count.load() >= base + 2);
+        expect(snap->value == 10_i);
+    };
+
+    "to_shared"_test = []
+    {
+        snapshot_atomic_shared_ptr asp(make_shared<TestObject>(10));
+        shared_ptr<TestObject>     sp;
+        {
+            auto snap = asp.load_snapshot();
+            sp        = snap.to_shared();
+            expect(sp.get() == snap.get());
+        }
+        asp.store(make_shared<TestObject>(20));
+        expect(sp->value == 10_i);
+
+        auto exchanged = asp.exchange(nullptr);
+        expect(exchanged->value == 20_i);
+    };
+
+    "reassigned snapshot keeps the object alive"_test = []
+    {
+        atomic_shared_ptr<WatchedObject, snapshot_policy> asp(
+            make_shared<WatchedObject>(1)
+        );
+        auto snap = asp.load_snapshot();
+        asp.store(make_shared<WatchedObject>(2));
+        WatchedObject::watched = 2;
+        snap                   = asp.load_snapshot();
+
+        // loads of other atomic pointers do not touch the snapshot's
+        // protection
+        atomic_shared_ptr<WatchedObject> other(make_shared<WatchedObject>(0));
+        expect(other.load()->value == 0_i);
+
+        // retire enough replaced objects for several scans of the retired list
+        int const stores = 16 * int(std::thread::hardware_concurrency()) + 64;
+        for (int i = 0; i < stores; ++i)
+        {
+            asp.store(make_shared<WatchedObject>(3 + i));
+        }
+        expect(!WatchedObject::destroyed.load());
+        expect(snap->value == 2_i);
+    };
+
+    "concurrent snapshots"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 10000;
+
+        snapshot_atomic_shared_ptr asp(make_shared<TestObject>(0));
+        std::vector<std::jthread>  threads;
+
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back(
+                [&asp]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        asp.store(make_shared<TestObject>(j));
+                    }
+                }
+            );
+            threads.emplace_back(
+                [&asp]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        auto snap = asp.load_snapshot();
+                        expect(snap->value >= 0_i && snap->value < ITERATIONS);
+                    }
+                }
+            );
+        }
+    };
+};
+
+template <typename T, typename Policy = hazard_pointer_policy>
     requires std::is_nothrow_move_constructible_v<T>
 class lockfree_stack
 {
@@ -151,7 +434,7 @@ private:
         T                         data;
         tinystd::shared_ptr<node> next; // every node is managed by shared_ptr
     };
-    tinystd::atomic_shared_ptr<node> head;
+    tinystd::atomic_shared_ptr<node, Policy> head;
 
 public:
     void
@@ -219,9 +502,9 @@ suite<"lockfree_stack"> lockfree_stack_test = []
         expect(eq(stack.pop().value(), "hello"s));
     };
 
-    "concurrent push and pop"_test = []
+    "concurrent push and pop"_test = []<class Policy>
     {
-        lockfree_stack<int> stack;
+        lockfree_stack<int, Policy> stack;
         std::atomic<int>    sum{0};
         std::atomic<int>    push_count{0};
         std::atomic<int>    pop_count{0};
@@ -267,7 +550,7 @@ suite<"lockfree_stack"> lockfree_stack_test = []
             << "Push and pop counts should be equal";
         expect(sum.load() < (ITERATIONS * NUM_THREADS / 2 * (ITERATIONS - 1)))
             << "Sum should be less than the maximum possible sum";
-    };
+    } | std::tuple<hazard_pointer_policy, split_count_policy>{};
 };
 
 int
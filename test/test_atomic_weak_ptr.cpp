@@ -0,0 +1,138 @@
+#include <boost/ut.hpp>
+
+import tinystd;
+import std;
+
+using namespace boost::ut;
+using namespace tinystd;
+
+struct TestObject
+{
+    int                     value;
+    static std::atomic<int> instance_count;
+    TestObject(int v) : value(v) { instance_count++; }
+    ~TestObject() { instance_count--; }
+};
+std::atomic<int> TestObject::instance_count(0);
+
+suite<"atomic_weak_ptr"> atomic_weak_ptr_test = []
+{
+    "default constructor"_test = []
+    {
+        atomic_weak_ptr<TestObject> awp;
+        expect(awp.load().expired());
+        expect(!awp.load_and_lock());
+    };
+
+    "load and store"_test = []
+    {
+        {
+            auto                        sp = make_shared<TestObject>(10);
+            atomic_weak_ptr<TestObject> awp;
+            awp.store(sp);
+            weak_ptr<TestObject> wp = awp.load();
+            expect(wp.lock()->value == 10_i);
+            expect(sp.use_count() == 1_l);
+
+            sp.reset();
+            expect(TestObject::instance_count.load() == 0_i);
+            expect(awp.load().expired());
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+
+    "load_and_lock"_test = []
+    {
+        auto                        sp = make_shared<TestObject>(10);
+        atomic_weak_ptr<TestObject> awp(sp);
+
+        auto locked = awp.load_and_lock();
+        expect(locked->value == 10_i);
+        expect(eq(locked, sp));
+        expect(sp.use_count() == 2_l);
+
+        locked.reset();
+        sp.reset();
+        expect(!awp.load_and_lock());
+    };
+
+    "exchange"_test = []
+    {
+        auto                        sp1 = make_shared<TestObject>(10);
+        auto                        sp2 = make_shared<TestObject>(20);
+        atomic_weak_ptr<TestObject> awp(sp1);
+
+        weak_ptr<TestObject> old = awp.exchange(sp2);
+        expect(old.lock()->value == 10_i);
+        expect(awp.load_and_lock()->value == 20_i);
+    };
+
+    "compare_exchange_strong"_test = []
+    {
+        auto                        sp1 = make_shared<TestObject>(10);
+        auto                        sp2 = make_shared<TestObject>(20);
+        atomic_weak_ptr<TestObject> awp(sp1);
+
+        weak_ptr<TestObject> expected(sp2);
+        weak_ptr<TestObject> desired(sp2);
+        expect(!awp.compare_exchange_strong(expected, std::move(desired)));
+        expect(expected.lock()->value == 10_i);
+        expect(!desired.expired());
+
+        expect(awp.compare_exchange_strong(expected, std::move(desired)));
+        expect(awp.load_and_lock()->value == 20_i);
+        expect(desired.expired());
+    };
+
+    "concurrent operations"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 10000;
+
+        {
+            atomic_weak_ptr<TestObject> awp;
+            std::atomic<int>            lock_count{0};
+            std::vector<std::jthread>   threads;
+
+            for (int i = 0; i < NUM_THREADS; ++i)
+            {
+                // writers publish short-lived objects, readers lock them
+                threads.emplace_back(
+                    [&awp]
+                    {
+                        for (int j = 0; j < ITERATIONS; ++j)
+                        {
+                            auto sp = make_shared<TestObject>(j);
+                            awp.store(sp);
+                            weak_ptr<TestObject> wp = awp.load();
+                            expect(wp.use_count() <= NUM_THREADS + 1);
+                        }
+                    }
+                );
+                threads.emplace_back(
+                    [&]
+                    {
+                        for (int j = 0; j < ITERATIONS; ++j)
+                        {
+                            if (auto sp = awp.load_and_lock())
+                            {
+                                lock_count.fetch_add(
+                                    1, std::memory_order_relaxed
+                                );
+                            }
+                        }
+                    }
+                );
+            }
+            threads.clear();
+            boost::ut::log << "Total successful locks: " << lock_count.load()
+                           << '\n';
+        }
+        expect(TestObject::instance_count.load() == 0_i);
+    };
+};
+
+int
+main()
+{
+}
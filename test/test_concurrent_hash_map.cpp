@@ -0,0 +1,167 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"concurrent_hash_map"> test_concurrent_hash_map = []
+{
+    "insert, find and erase"_test = []
+    {
+        concurrent_hash_map<int, std::string> map;
+        expect(map.empty());
+        expect(!map.find(1).has_value());
+
+        expect(map.insert(1, "one"));
+        expect(map.emplace(2, 3, 'x'));
+        expect(!map.insert(1, "uno"));
+        expect(map.size() == 2_u);
+        expect(map.find(1) == "one");
+        expect(map.find(2) == "xxx");
+        expect(map.contains(2));
+        expect(!map.contains(3));
+
+        expect(!map.insert_or_assign(1, "uno"));
+        expect(map.find(1) == "uno");
+        expect(map.insert_or_assign(3, "three"));
+        expect(map.size() == 3_u);
+
+        expect(map.erase(1));
+        expect(!map.erase(1));
+        expect(!map.contains(1));
+        expect(map.size() == 2_u);
+
+        std::size_t length = 0;
+        expect(map.visit(3, [&](std::string const & s) { length = s.size(); }));
+        expect(length == 5_u);
+    };
+
+    "growth"_test = []
+    {
+        constexpr int ITERATIONS = 100000;
+
+        // starts with 2 buckets, grows many times
+        concurrent_hash_map<int, int> map(2);
+        for (int i = 0; i < ITERATIONS; ++i) expect(fatal(map.insert(i, -i)));
+        expect(map.size() == std::size_t{ITERATIONS});
+        for (int i = 0; i < ITERATIONS; ++i)
+        {
+            expect(fatal(map.find(i) == -i));
+        }
+        for (int i = 0; i < ITERATIONS; i += 2) expect(fatal(map.erase(i)));
+        for (int i = 0; i < ITERATIONS; ++i)
+        {
+            expect(fatal(map.contains(i) == (i % 2 == 1)));
+        }
+    };
+
+    "values are destroyed"_test = []
+    {
+        constexpr int ITERATIONS = 1000;
+
+        auto value = std::make_shared<int>(0);
+        {
+            concurrent_hash_map<int, std::shared_ptr<int>> map;
+            for (int i = 0; i < ITERATIONS; ++i) map.insert(i, value);
+            for (int i = 0; i < ITERATIONS; i += 2) map.erase(i);
+            for (int i = 1; i < ITERATIONS; i += 4)
+            {
+                map.insert_or_assign(i, nullptr);
+            }
+        }
+        // Nodes of chains that are retired but not yet reclaimed are still
+        // alive, their number is bounded by the hazard pointer threshold.
+        expect(value.use_count() < 100_l);
+    };
+
+    "concurrent insert and erase"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 50000;
+
+        // every thread owns a range of keys, so the outcome is deterministic
+        concurrent_hash_map<int, int> map;
+        std::vector<std::jthread>     threads;
+        for (int t = 0; t < NUM_THREADS; ++t)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    auto const base = t * ITERATIONS;
+                    for (int i = 0; i < ITERATIONS; ++i)
+                    {
+                        map.insert(base + i, i);
+                    }
+                    for (int i = 0; i < ITERATIONS; i += 2)
+                    {
+                        map.erase(base + i);
+                    }
+                    for (int i = 1; i < ITERATIONS; i += 2)
+                    {
+                        map.insert_or_assign(base + i, -i);
+                    }
+                }
+            );
+        }
+        threads.clear();
+
+        expect(map.size() == std::size_t{NUM_THREADS * ITERATIONS / 2});
+        for (int t = 0; t < NUM_THREADS; ++t)
+        {
+            for (int i = 0; i < ITERATIONS; ++i)
+            {
+                auto const value = map.find(t * ITERATIONS + i);
+                if (i % 2 == 0) { expect(fatal(!value.has_value())); }
+                else { expect(fatal(value == -i)); }
+            }
+        }
+    };
+
+    "readers during writes and resizing"_test = []
+    {
+        constexpr int NUM_READERS = 4;
+        constexpr int ITERATIONS  = 100000;
+
+        // the writer only inserts, so a key found once is never lost
+        concurrent_hash_map<int, int> map(2);
+        std::atomic<int>              inserted{0};
+        std::vector<std::jthread>     threads;
+        threads.emplace_back(
+            [&]
+            {
+                for (int i = 0; i < ITERATIONS; ++i)
+                {
+                    map.insert(i, i * 2);
+                    inserted.store(i + 1, std::memory_order_release);
+                }
+            }
+        );
+        for (int r = 0; r < NUM_READERS; ++r)
+        {
+            threads.emplace_back(
+                [&, r]
+                {
+                    std::minstd_rand rng(r);
+                    while (inserted.load(std::memory_order_acquire)
+                           < ITERATIONS)
+                    {
+                        auto const n =
+                            inserted.load(std::memory_order_acquire);
+                        if (n == 0) continue;
+                        auto const key = static_cast<int>(rng() % n);
+                        expect(fatal(map.find(key) == key * 2));
+                    }
+                }
+            );
+        }
+        threads.clear();
+        expect(map.size() == std::size_t{ITERATIONS});
+    };
+};
+
+int
+main()
+{
+}
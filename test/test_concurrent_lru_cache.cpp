@@ -0,0 +1,149 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// every entry weighs 1
+struct unit_weigher
+{
+    auto
+    operator()(int, auto const &) const noexcept -> std::size_t
+    {
+        return 1;
+    }
+};
+
+template <typename V>
+using unit_cache = concurrent_lru_cache<
+    int,
+    V,
+    std::hash<int>,
+    std::equal_to<int>,
+    unit_weigher>;
+
+suite<"concurrent_lru_cache"> test_concurrent_lru_cache = []
+{
+    "insert, find and erase"_test = []
+    {
+        concurrent_lru_cache<int, std::string> cache(1 << 20);
+        expect(cache.empty());
+        expect(!cache.find(1));
+
+        expect(*cache.insert(1, "one") == "one");
+        expect(*cache.insert(1, "uno") == "one");
+        expect(*cache.find(1) == "one");
+        expect(*cache.insert_or_assign(1, "uno") == "uno");
+        expect(*cache.find(1) == "uno");
+        expect(cache.contains(1));
+        expect(cache.size() == 1_u);
+        expect(cache.weight() == sizeof(int) + sizeof(std::string));
+
+        // the value outlives its entry
+        auto const value = cache.find(1);
+        expect(cache.erase(1));
+        expect(!cache.erase(1));
+        expect(!cache.contains(1));
+        expect(*value == "uno");
+        expect(cache.weight() == 0_u);
+    };
+
+    "get_or_insert"_test = []
+    {
+        concurrent_lru_cache<int, int> cache(1 << 20);
+        int        calls = 0;
+        auto const make = [&]
+        {
+            ++calls;
+            return 42;
+        };
+        expect(*cache.get_or_insert(1, make) == 42_i);
+        expect(*cache.get_or_insert(1, make) == 42_i);
+        expect(calls == 1_i);
+    };
+
+    "capacity"_test = []
+    {
+        // one shard of 100 entries
+        unit_cache<int> cache(100, 1);
+        for (int i = 0; i < 1000; ++i)
+        {
+            cache.insert(i, i);
+            expect(fatal(cache.weight() <= 100_u));
+        }
+        expect(cache.size() == 100_u);
+        expect(cache.contains(999));
+
+        // an entry heavier than a shard is returned but not cached
+        concurrent_lru_cache<int, std::array<char, 64>> small(32, 1);
+        expect(static_cast<bool>(small.insert(1, {})));
+        expect(!small.contains(1));
+    };
+
+    "referenced entries get a second chance"_test = []
+    {
+        unit_cache<int> cache(100, 1);
+        for (int i = 0; i < 100; ++i) cache.insert(i, i);
+
+        // the hot keys are hit before every insert, cold keys are evicted
+        for (int i = 100; i < 1000; ++i)
+        {
+            for (int hot = 0; hot < 10; ++hot)
+            {
+                expect(fatal(static_cast<bool>(cache.find(hot))));
+            }
+            cache.insert(i, i);
+        }
+        for (int hot = 0; hot < 10; ++hot) expect(cache.contains(hot));
+    };
+
+    "values are destroyed"_test = []
+    {
+        auto value = std::make_shared<int>(0);
+        {
+            unit_cache<std::shared_ptr<int>> cache(10, 1);
+            for (int i = 0; i < 1000; ++i) cache.insert(i, value);
+        }
+        // Entries that are evicted but not yet reclaimed are still alive,
+        // their number is bounded by the hazard pointer threshold.
+        expect(value.use_count() < 200_l);
+    };
+
+    "concurrent hits and inserts"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 50000;
+        constexpr int NUM_KEYS    = 2000;
+
+        unit_cache<int>           cache(1000, 4);
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    std::minstd_rand rng(t + 1);
+                    for (int i = 0; i < ITERATIONS; ++i)
+                    {
+                        auto const key   = static_cast<int>(rng() % NUM_KEYS);
+                        auto const value = cache.get_or_insert(
+                            key, [&] { return key * 2; }
+                        );
+                        expect(fatal(*value == key * 2));
+                        if (i % 16 == 0) cache.erase(key);
+                    }
+                }
+            );
+        }
+        threads.clear();
+        expect(cache.weight() <= 1000_u);
+        expect(cache.size() == cache.weight());
+    };
+};
+
+int
+main()
+{
+}
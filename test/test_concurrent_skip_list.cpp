@@ -0,0 +1,169 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"concurrent_skip_list"> test_concurrent_skip_list = []
+{
+    "insert, find and erase"_test = []
+    {
+        concurrent_skip_list<int, std::string> list;
+        expect(list.empty());
+        expect(!list.find(1).has_value());
+
+        expect(list.insert(2, "two"));
+        expect(list.emplace(1, 3, 'x'));
+        expect(!list.insert(2, "deux"));
+        expect(list.size() == 2_u);
+        expect(list.find(1) == "xxx");
+        expect(list.find(2) == "two");
+        expect(list.contains(2));
+        expect(!list.contains(3));
+
+        expect(list.erase(1));
+        expect(!list.erase(1));
+        expect(!list.contains(1));
+        expect(list.size() == 1_u);
+        expect(list.insert(1, "one"));
+        expect(list.find(1) == "one");
+    };
+
+    "ordered access"_test = []
+    {
+        concurrent_skip_list<int, int> list;
+        for (int i = 0; i < 1000; ++i) list.insert((i * 7919) % 1000 * 2, i);
+
+        expect(list.lower_bound(-1)->first == 0_i);
+        expect(list.lower_bound(501)->first == 502_i);
+        expect(list.lower_bound(502)->first == 502_i);
+        expect(!list.lower_bound(1999).has_value());
+
+        std::vector<int> keys;
+        list.for_each([&](int key, int) { keys.push_back(key); });
+        expect(keys.size() == 1000_u);
+        expect(std::ranges::is_sorted(keys));
+
+        keys.clear();
+        list.for_each(100, 120, [&](int key, int) { keys.push_back(key); });
+        expect(
+            keys
+            == std::vector{100, 102, 104, 106, 108, 110, 112, 114, 116, 118}
+        );
+    };
+
+    "values are destroyed"_test = []
+    {
+        constexpr int ITERATIONS = 1000;
+
+        auto value = std::make_shared<int>(0);
+        {
+            concurrent_skip_list<int, std::shared_ptr<int>> list;
+            for (int i = 0; i < ITERATIONS; ++i) list.insert(i, value);
+            for (int i = 0; i < ITERATIONS; i += 2) list.erase(i);
+        }
+        // Nodes that are retired but not yet reclaimed are still alive, their
+        // number is bounded by the hazard pointer threshold.
+        expect(value.use_count() < 100_l);
+    };
+
+    "concurrent insert and erase"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 20000;
+
+        // all threads insert and erase the same keys, the thread of a key's
+        // last successful insert is unknown but every key ends up erased or
+        // inserted by the final pass
+        concurrent_skip_list<int, int> list;
+        std::vector<std::jthread>      threads;
+        std::atomic<int>               inserted{0};
+        std::atomic<int>               erased{0};
+        for (int t = 0; t < NUM_THREADS; ++t)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    for (int i = 0; i < ITERATIONS; ++i)
+                    {
+                        inserted += list.insert(i, t);
+                        if (i % 3 == t % 3) erased += list.erase(i);
+                    }
+                }
+            );
+        }
+        threads.clear();
+
+        expect(list.size() == std::size_t(inserted - erased));
+        int count = 0;
+        int prev  = -1;
+        list.for_each(
+            [&](int key, int)
+            {
+                expect(fatal(key > prev));
+                prev = key;
+                ++count;
+            }
+        );
+        expect(count == inserted - erased);
+    };
+
+    "scans during updates"_test = []
+    {
+        constexpr int NUM_KEYS   = 10000;
+        constexpr int ITERATIONS = 20000;
+
+        // even keys stay, odd keys come and go
+        concurrent_skip_list<int, int> list;
+        for (int i = 0; i < NUM_KEYS; i += 2) list.insert(i, i);
+
+        std::atomic<bool>         done{false};
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 2; ++t)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    std::minstd_rand rng(t + 1);
+                    for (int i = 0; i < ITERATIONS; ++i)
+                    {
+                        auto const key =
+                            static_cast<int>(rng() % (NUM_KEYS / 2)) * 2 + 1;
+                        if (rng() % 2) { list.insert(key, key); }
+                        else { list.erase(key); }
+                    }
+                }
+            );
+        }
+        threads.emplace_back(
+            [&]
+            {
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    int num_even = 0;
+                    int prev     = -1;
+                    list.for_each(
+                        [&](int key, int value)
+                        {
+                            expect(fatal(key > prev));
+                            expect(fatal(value == key));
+                            prev      = key;
+                            num_even += key % 2 == 0;
+                        }
+                    );
+                    expect(fatal(num_even == NUM_KEYS / 2));
+                }
+            }
+        );
+        threads[0].join();
+        threads[1].join();
+        done = true;
+    };
+};
+
+int
+main()
+{
+}
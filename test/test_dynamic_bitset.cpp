@@ -0,0 +1,111 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// bits i with i % step == 0
+template <typename Bitset>
+auto
+every(std::size_t step, std::size_t size) -> Bitset
+{
+    Bitset bits(size);
+    for (std::size_t i = 0; i < size; i += step) bits.set(i);
+    return bits;
+}
+
+suite<"dynamic_bitset"> test_dynamic_bitset = []
+{
+    "set, reset and test"_test = []<class Bitset>
+    {
+        Bitset bits(130);
+        expect(bits.size() == 130_ul);
+        expect(bits.none());
+        bits.set(0).set(64).set(129);
+        expect(bits[0] && bits[64] && bits[129]);
+        expect(!bits[1] && !bits[128]);
+        bits.reset(64).flip(1);
+        expect(!bits[64] && bits[1]);
+        expect(bits.count() == 3_ul);
+
+        bits.set();
+        expect(bits.all() && bits.count() == 130_ul);
+        bits.flip();
+        expect(bits.none());
+    } | std::tuple<dynamic_bitset, inplace_dynamic_bitset<256>>{};
+
+    "resize and push_back"_test = []<class Bitset>
+    {
+        Bitset bits(3, true);
+        expect(bits.count() == 3_ul);
+        bits.resize(100, true);
+        expect(bits.count() == 100_ul);
+        bits.resize(70);
+        expect(bits.count() == 70_ul);
+        bits.resize(200);
+        expect(bits.count() == 70_ul && !bits[150]);
+        expect(bits.words()[1] == (std::uint64_t{1} << 6) - 1);
+
+        for (int i = 0; i < 10; ++i) bits.push_back(i % 2 == 0);
+        expect(bits.size() == 210_ul && bits.count() == 75_ul);
+        expect(bits[200] && !bits[201]);
+    } | std::tuple<dynamic_bitset, inplace_dynamic_bitset<256>>{};
+
+    "inplace capacity"_test = []
+    {
+        inplace_dynamic_bitset<128> bits(128);
+        expect(throws<std::bad_alloc>([&] { bits.push_back(true); }));
+        expect(throws<std::bad_alloc>([&] { bits.resize(129, true); }));
+        expect(bits.size() == 128_ul && bits.count() == 0_ul);
+    };
+
+    "bitwise operations"_test = []
+    {
+        // long enough for the vector loops and a scalar tail
+        constexpr std::size_t size   = 1000;
+        auto const            twos   = every<dynamic_bitset>(2, size);
+        auto const            threes = every<dynamic_bitset>(3, size);
+
+        expect((twos & threes) == every<dynamic_bitset>(6, size));
+        expect((twos | threes).count() == 667_ul);
+        expect((twos ^ threes).count() == 500_ul);
+
+        auto only_twos = twos;
+        only_twos.and_not(threes);
+        expect(only_twos.count() == 333_ul);
+        expect(only_twos[2] && !only_twos[6]);
+    };
+
+    "find and set bit iteration"_test = []
+    {
+        dynamic_bitset bits(1000);
+        expect(bits.find_first() == dynamic_bitset::npos);
+        expect(std::ranges::empty(bits.set_bits()));
+
+        std::vector<std::size_t> const positions{3, 63, 64, 500, 998, 999};
+        for (std::size_t const i : positions) bits.set(i);
+
+        expect(bits.find_first() == 3_ul);
+        expect(bits.find_next(3) == 63_ul);
+        expect(bits.find_next(64) == 500_ul);
+        expect(bits.find_next(998) == 999_ul);
+        expect(bits.find_next(999) == dynamic_bitset::npos);
+
+        std::vector<std::size_t> found;
+        std::size_t              i = bits.find_first();
+        while (i != dynamic_bitset::npos)
+        {
+            found.push_back(i);
+            i = bits.find_next(i);
+        }
+        expect(found == positions);
+        expect(std::ranges::equal(bits.set_bits(), positions));
+    };
+};
+
+int
+main()
+{
+}
@@ -0,0 +1,137 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+using small_flat_map = flat_map<
+    int,
+    std::string,
+    std::less<int>,
+    small_vector<int, 4>,
+    small_vector<std::string, 4>>;
+
+suite<"flat_map"> test_flat_map = []
+{
+    "insert and lookup"_test = []<class Map>
+    {
+        Map map;
+        expect(map.empty());
+        expect(map.try_emplace(3, "three").second);
+        expect(map.try_emplace(1, "one").second);
+        expect(!map.try_emplace(3, "drei").second);
+        map[2] = "two";
+        expect(map.size() == 3_ul);
+
+        expect(map.at(3) == "three");
+        expect(map[2] == "two");
+        expect(map.contains(1) && !map.contains(4));
+        expect(map.count(1) == 1_ul && map.count(0) == 0_ul);
+        expect(map.find(4) == map.end());
+        expect(throws<std::out_of_range>([&] { (void)map.at(4); }));
+
+        expect(!map.insert_or_assign(3, "drei").second);
+        expect(map.at(3) == "drei");
+
+        expect(std::ranges::equal(map.keys(), std::vector{1, 2, 3}));
+        expect(map.erase(2) == 1_ul && map.erase(2) == 0_ul);
+        expect(map.find(3)->second == "drei");
+        map.erase(map.begin());
+        expect(map.size() == 1_ul && map.begin()->first == 3);
+    } | std::tuple<flat_map<int, std::string>, small_flat_map>{};
+
+    "sorting constructor"_test = []
+    {
+        flat_map<int, char> const map(
+            vector<int>{5, 1, 3, 1, 5}, vector<char>{'a', 'b', 'c', 'd', 'e'}
+        );
+        expect(map.size() == 3_ul);
+        expect(std::ranges::equal(map.keys(), std::vector{1, 3, 5}));
+        expect(map.at(3) == 'c');
+
+        flat_map<int, char> const sorted(
+            sorted_unique, vector<int>{1, 2}, vector<char>{'x', 'y'}
+        );
+        expect(sorted.at(2) == 'y');
+    };
+
+    "bulk insert"_test = []
+    {
+        flat_map<int, int> map{{10, 0}, {20, 0}, {30, 0}};
+        std::vector<std::pair<int, int>> const unsorted{
+            {25, 1}, {5, 1}, {20, 1}, {25, 2}
+        };
+        map.insert_range(unsorted);
+        expect(std::ranges::equal(map.keys(), std::vector{5, 10, 20, 25, 30}));
+        // keys that were already present keep their value
+        expect(map.at(20) == 0_i);
+
+        std::vector<std::pair<int, int>> const sorted{{1, 1}, {30, 1}, {40, 1}};
+        map.insert(sorted_unique, sorted.begin(), sorted.end());
+        expect(map.size() == 7_ul);
+        expect(map.at(30) == 0_i && map.at(40) == 1_i);
+        expect(std::ranges::is_sorted(map.keys()));
+    };
+
+    "bulk insert copies from lvalues"_test = []
+    {
+        std::vector<std::pair<std::string, int>> source{{"b", 2}, {"a", 1}};
+        flat_map<std::string, int> map;
+        map.insert(source.begin(), source.end());
+        map.insert_range(std::views::all(source));
+        expect(map.size() == 2_ul && map.at("a") == 1_i);
+        expect(source[0].first == "b" && source[1].first == "a");
+
+        // the proxy references of another map are copied from
+        flat_map<std::string, std::string> other{{"x", "value"}};
+        flat_map<std::string, std::string> copy;
+        copy.insert_range(other);
+        expect(copy.at("x") == "value" && other.at("x") == "value");
+    };
+
+    "iterators"_test = []
+    {
+        flat_map<int, int> map{{3, 30}, {1, 10}, {2, 20}};
+        for (auto [key, value] : map) value += key;
+        expect(std::ranges::equal(map.values(), std::vector{11, 22, 33}));
+
+        static_assert(std::random_access_iterator<decltype(map.begin())>);
+        auto const & const_map = map;
+        flat_map<int, int>::const_iterator const it = map.begin() + 1;
+        expect(it == const_map.begin() + 1);
+        expect(it->first == 2 && (*it).second == 22);
+        expect(map.end() - map.begin() == 3_l);
+        expect(map.lower_bound(2) == map.find(2));
+    };
+
+    "transparent lookup"_test = []
+    {
+        flat_map<std::string, int, std::less<>> map{{"one", 1}, {"two", 2}};
+        expect(map.contains(std::string_view{"two"}));
+        expect(map.find(std::string_view{"three"}) == map.end());
+        expect(map.find("one")->second == 1);
+    };
+
+    "extract, replace and swap"_test = []
+    {
+        flat_map<int, int> map{{1, 1}, {2, 4}};
+        auto containers = std::move(map).extract();
+        expect(map.empty());
+        expect(containers.keys.size() == 2_ul);
+
+        containers.values[1] = 8;
+        map.replace(std::move(containers.keys), std::move(containers.values));
+        expect(map.at(2) == 8_i);
+
+        flat_map<int, int> other{{7, 7}};
+        swap(map, other);
+        expect(map.size() == 1_ul && other.at(1) == 1_i);
+    };
+};
+
+int
+main()
+{
+}
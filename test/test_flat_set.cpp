@@ -0,0 +1,77 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"flat_set"> test_flat_set = []
+{
+    "insert and lookup"_test = []<class Set>
+    {
+        Set set;
+        expect(set.empty());
+        expect(set.insert(3).second);
+        expect(set.insert(1).second);
+        expect(!set.insert(3).second);
+        expect(set.emplace(2).second);
+        expect(set.size() == 3_ul);
+
+        expect(std::ranges::equal(set, std::vector{1, 2, 3}));
+        expect(set.contains(2) && !set.contains(4));
+        expect(set.count(1) == 1_ul && set.count(0) == 0_ul);
+        expect(set.find(4) == set.end());
+        expect(*set.lower_bound(2) == 2_i);
+
+        expect(set.erase(2) == 1_ul && set.erase(2) == 0_ul);
+        set.erase(set.begin());
+        expect(std::ranges::equal(set, std::vector{3}));
+    } | std::tuple<
+            flat_set<int>,
+            flat_set<int, std::less<int>, small_vector<int, 4>>>{};
+
+    "constructors and bulk insert"_test = []
+    {
+        flat_set<int> set(vector<int>{5, 1, 3, 1, 5});
+        expect(std::ranges::equal(set, std::vector{1, 3, 5}));
+
+        set.insert_range(std::vector{4, 0, 3, 4});
+        expect(std::ranges::equal(set, std::vector{0, 1, 3, 4, 5}));
+
+        std::vector const sorted{-1, 2, 5, 6};
+        set.insert(sorted_unique, sorted.begin(), sorted.end());
+        expect(std::ranges::equal(set, std::vector{-1, 0, 1, 2, 3, 4, 5, 6}));
+
+        flat_set<int> const list{2, 1, 2};
+        flat_set<int> const tagged(sorted_unique, vector<int>{1, 2});
+        expect(list == tagged);
+    };
+
+    "transparent lookup"_test = []
+    {
+        flat_set<std::string, std::less<>> const set{"one", "two"};
+        expect(set.contains(std::string_view{"two"}));
+        expect(set.find(std::string_view{"three"}) == set.end());
+    };
+
+    "extract, replace and swap"_test = []
+    {
+        flat_set<int> set{1, 2, 3};
+        auto keys = std::move(set).extract();
+        expect(set.empty() && keys.size() == 3_ul);
+
+        keys.push_back(4);
+        set.replace(std::move(keys));
+        expect(set.contains(4));
+
+        flat_set<int> other{7};
+        swap(set, other);
+        expect(set.size() == 1_ul && other.size() == 4_ul);
+    };
+};
+
+int
+main()
+{
+}
@@ -207,6 +207,61 @@ suite<"function"> function_test = []
     };
 };
 
+suite<"move_only_function"> move_only_function_test = []
+{
+    "move-only target"_test = []
+    {
+        move_only_function<int()> f(
+            [p = std::make_unique<int>(42)] { return *p; }
+        );
+        expect(static_cast<bool>(f));
+        expect(f() == 42_i);
+
+        auto f2 = std::move(f);
+        expect(f == nullptr);
+        expect(f2() == 42_i);
+
+        f = std::move(f2);
+        expect(f2 == nullptr);
+        expect(f() == 42_i);
+    };
+
+    "small and large targets"_test = []
+    {
+        int  a = 1;
+        int  b = 2;
+        int  c = 3;
+        auto small = [&] { return a + b + c; };
+        static_assert(sizeof(small) <= 3 * sizeof(void*));
+        move_only_function<int()> f(small);
+        expect(f() == 6_i);
+
+        std::array<int, 100> data{};
+        data[0] = 7;
+        move_only_function<int()> g([data] { return data[0]; });
+        expect(g() == 7_i);
+
+        swap(f, g);
+        expect(f() == 7_i);
+        expect(g() == 6_i);
+    };
+
+    "resource management"_test = []
+    {
+        int resource_count = 0;
+        {
+            move_only_function<void(int)> f{ResourceManager{&resource_count}};
+            expect(resource_count == 1_i);
+            f(42);
+            auto f2 = std::move(f);
+            expect(resource_count == 1_i);
+            f2.reset();
+            expect(resource_count == 0_i);
+        }
+        expect(resource_count == 0_i);
+    };
+};
+
 int
 main()
 {
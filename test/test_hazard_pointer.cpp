@@ -95,6 +95,63 @@ test_lock_free_stack()
     std::cout << "Lock-free stack test passed successfully!" << std::endl;
 }
 
+struct Tracked
+{
+    bool* reclaimed;
+};
+
+void
+reclaim_tracked(Tracked* ptr) noexcept
+{
+    *ptr->reclaimed = true;
+    delete ptr;
+}
+
+// Two hazard pointers of the same type protect two objects at once
+void
+test_two_hazard_pointers()
+{
+    bool                  first_reclaimed  = false;
+    bool                  second_reclaimed = false;
+    bool                  other_reclaimed  = false;
+    std::atomic<Tracked*> first{new Tracked{&first_reclaimed}};
+    std::atomic<Tracked*> second{new Tracked{&second_reclaimed}};
+
+    auto retire_others = [&]
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            tinystd::hazard_pointer<Tracked>::retire(
+                new Tracked{&other_reclaimed}, &reclaim_tracked
+            );
+        }
+    };
+
+    {
+        auto hp0 = tinystd::make_hazard_pointer<Tracked>();
+        auto hp1 = tinystd::make_hazard_pointer<Tracked>(1);
+        tinystd::hazard_pointer<Tracked>::retire(
+            hp0.protect(first), &reclaim_tracked
+        );
+        tinystd::hazard_pointer<Tracked>::retire(
+            hp1.protect(second), &reclaim_tracked
+        );
+        retire_others();
+        if (first_reclaimed || second_reclaimed)
+        {
+            throw std::runtime_error("Protected object reclaimed!");
+        }
+    }
+
+    retire_others();
+    if (!first_reclaimed || !second_reclaimed)
+    {
+        throw std::runtime_error("Unprotected object not reclaimed!");
+    }
+
+    std::cout << "Two hazard pointers test passed successfully!" << std::endl;
+}
+
 void
 push_task(
     LockFreeStack<int>& stack, int start, int end, std::atomic<int>& push_count
@@ -184,6 +241,7 @@ int
 main()
 {
     test_lock_free_stack();
+    test_two_hazard_pointers();
     run_concurrent_test(
         8, 100000
     ); // 8 threads, 100,000 operations per push thread
@@ -0,0 +1,81 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// a small threshold, so that the tests cross it cheaply
+constexpr std::size_t threshold = 1 << 16;
+
+template <typename T, bool TransparentHugePages = false>
+using test_allocator =
+    huge_buffer_allocator<T, threshold, TransparentHugePages>;
+
+suite<"huge_buffer_allocator"> test_huge_buffer_allocator = []
+{
+    "reallocate keeps the contents"_test = []<class Allocator>
+    {
+        Allocator   alloc;
+        std::size_t size = 16;
+        int*        p    = alloc.allocate(size);
+        std::iota(p, p + size, 0);
+
+        // malloc -> malloc -> mapping -> mapping -> malloc
+        for (std::size_t const new_size : {1000, 100000, 1000000, 64})
+        {
+            p = alloc.reallocate(p, size, new_size);
+            auto const kept = std::min(size, new_size);
+            expect(std::ranges::equal(
+                std::span(p, kept), std::views::iota(0, static_cast<int>(kept))
+            ));
+            std::iota(p, p + new_size, 0);
+            size = new_size;
+        }
+        alloc.deallocate(p, size);
+    } | std::tuple<test_allocator<int>, test_allocator<int, true>>{};
+
+    "vector grows in place"_test = []
+    {
+        vector<int, test_allocator<int>> v;
+        for (int i = 0; i < 1000000; ++i) v.push_back(i);
+        expect(v.size() == 1000000_ul);
+        expect(v[0] == 0 && v[999999] == 999999);
+
+        // the argument refers to an element that the growth moves
+        v.resize(v.capacity());
+        v.push_back(v[123]);
+        expect(v[v.size() - 1] == 123_i);
+    };
+
+    "reserve and shrink_to_fit"_test = []
+    {
+        small_vector<double, 4, test_allocator<double>> v;
+        v.reserve(100000);
+        expect(v.capacity() == 100000_ul);
+        auto const filled = v.append_for_overwrite(50000);
+        std::ranges::fill(filled, 1.5);
+        v.shrink_to_fit();
+        expect(v.capacity() == 50000_ul);
+        expect(v[49999] == 1.5_d);
+        v.resize(3);
+        v.shrink_to_fit();
+        expect(v.capacity() == 4_ul);
+        expect(v[2] == 1.5_d);
+    };
+
+    "types that are not trivially relocatable"_test = []
+    {
+        vector<std::string, test_allocator<std::string>> v;
+        for (int i = 0; i < 10000; ++i) v.push_back(std::to_string(i));
+        expect(v[9999] == "9999");
+        v.insert(v.begin(), "first");
+        expect(v[0] == "first" && v[10000] == "9999");
+    };
+};
+
+int
+main()
+{
+}
@@ -0,0 +1,114 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"lockfree_queue"> test_lockfree_queue = []
+{
+    "push and pop"_test = []
+    {
+        lockfree_queue<int> queue;
+        expect(queue.empty());
+        expect(!queue.pop().has_value());
+
+        queue.push(1);
+        queue.push(2);
+        queue.emplace(3);
+        expect(!queue.empty());
+        expect(queue.pop() == 1);
+        expect(queue.pop() == 2);
+        expect(queue.pop() == 3);
+        expect(!queue.pop().has_value());
+        expect(queue.empty());
+    };
+
+    "non-trivial elements"_test = []
+    {
+        lockfree_queue<std::unique_ptr<std::string>> queue;
+        queue.push(std::make_unique<std::string>("hello"));
+        queue.emplace(std::make_unique<std::string>("world"));
+        expect(**queue.pop() == "hello");
+
+        // the destructor releases the remaining elements
+        queue.push(std::make_unique<std::string>("leak"));
+    };
+
+    "FIFO per producer"_test = []
+    {
+        constexpr int NUM_PRODUCERS = 4;
+        constexpr int ITERATIONS    = 100000;
+
+        // elements are (producer, sequence number)
+        lockfree_queue<std::pair<int, int>> queue;
+        std::vector<std::jthread>           producers;
+        for (int i = 0; i < NUM_PRODUCERS; ++i)
+        {
+            producers.emplace_back(
+                [&, i]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j) queue.push({i, j});
+                }
+            );
+        }
+
+        std::vector<int> next(NUM_PRODUCERS, 0);
+        for (int popped = 0; popped < NUM_PRODUCERS * ITERATIONS;)
+        {
+            if (auto item = queue.pop())
+            {
+                auto [producer, seq] = *item;
+                expect(fatal(eq(seq, next[producer])));
+                ++next[producer];
+                ++popped;
+            }
+        }
+        expect(queue.empty());
+    };
+
+    "concurrent push and pop"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 100000;
+
+        lockfree_queue<int>       queue;
+        std::atomic<long long>    popped_sum{0};
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j) queue.push(j);
+                }
+            );
+            threads.emplace_back(
+                [&]
+                {
+                    long long sum = 0;
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        std::optional<int> item;
+                        while (!(item = queue.pop()));
+                        sum += *item;
+                    }
+                    popped_sum += sum;
+                }
+            );
+        }
+        threads.clear();
+
+        expect(queue.empty());
+        expect(
+            popped_sum.load()
+            == NUM_THREADS * (ITERATIONS - 1LL) * ITERATIONS / 2
+        );
+    };
+};
+
+int
+main()
+{
+}
@@ -0,0 +1,83 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"lockfree_stack"> test_lockfree_stack = []
+{
+    "push and pop"_test = []
+    {
+        lockfree_stack<int> stack;
+        expect(stack.empty());
+        expect(!stack.pop().has_value());
+
+        stack.push(1);
+        stack.push(2);
+        stack.emplace(3);
+        expect(!stack.empty());
+        expect(stack.pop() == 3);
+        expect(stack.pop() == 2);
+        expect(stack.pop() == 1);
+        expect(!stack.pop().has_value());
+    };
+
+    "non-trivial elements"_test = []
+    {
+        lockfree_stack<std::unique_ptr<std::string>> stack;
+        stack.push(std::make_unique<std::string>("hello"));
+        stack.emplace(std::make_unique<std::string>("world"));
+        expect(**stack.pop() == "world");
+
+        // the destructor releases the remaining elements
+        stack.push(std::make_unique<std::string>("leak"));
+    };
+
+    "concurrent push and pop"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 100000;
+
+        lockfree_stack<int>       stack;
+        std::atomic<long long>    popped_sum{0};
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j) stack.push(j);
+                }
+            );
+            threads.emplace_back(
+                [&]
+                {
+                    long long sum = 0;
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        std::optional<int> item;
+                        while (!(item = stack.pop()));
+                        sum += *item;
+                    }
+                    popped_sum += sum;
+                }
+            );
+        }
+        threads.clear();
+
+        // every pushed element is popped exactly once, also when a push is
+        // eliminated against a pop
+        expect(stack.empty());
+        expect(
+            popped_sum.load()
+            == NUM_THREADS * (ITERATIONS - 1LL) * ITERATIONS / 2
+        );
+    };
+};
+
+int
+main()
+{
+}
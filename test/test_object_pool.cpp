@@ -0,0 +1,196 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+struct counted
+{
+    inline static std::atomic<int> alive = 0;
+
+    int                  value;
+    std::array<char, 40> padding{};
+
+    explicit counted(int v) noexcept : value{v} { ++alive; }
+    ~counted() { --alive; }
+};
+
+struct throwing
+{
+    throwing() { throw std::runtime_error{"ctor"}; }
+};
+
+// only used by one test, so that its pool starts empty
+struct slab_rest
+{
+    std::array<char, 48> bytes;
+};
+
+// Allocates from the pool when its thread exits. Constructed before the
+// first block is freed on the thread, it is destroyed after the magazine and
+// the slab of the thread are handed over.
+struct pool_on_exit
+{
+    inline static std::atomic<int> made = 0;
+
+    ~pool_on_exit()
+    {
+        std::vector<counted*> kept;
+        for (int i = 0; i < 100; ++i)
+        {
+            kept.push_back(object_pool<counted>::create(i));
+        }
+        made.fetch_add(int(kept.size()), std::memory_order_relaxed);
+        for (auto p : kept) object_pool<counted>::destroy(p);
+    }
+};
+
+suite<"object_pool"> test_object_pool = []
+{
+    using pool = object_pool<counted>;
+
+    "create and destroy"_test = []
+    {
+        auto const p = pool::create(42);
+        expect(p->value == 42_i);
+        expect(reinterpret_cast<std::uintptr_t>(p) % alignof(counted) == 0_u);
+        pool::destroy(p);
+        expect(counted::alive == 0_i);
+
+        // the most recently freed block is reused first
+        auto const q = pool::create(1);
+        expect(q == p);
+        pool::destroy(q);
+        pool::destroy(nullptr);
+    };
+
+    "exception in constructor"_test = []
+    {
+        expect(throws([] { (void)object_pool<throwing>::create(); }));
+    };
+
+    "distinct blocks across slabs"_test = []
+    {
+        constexpr std::size_t COUNT = 3 * pool::slab_size / pool::block_size;
+
+        std::vector<counted*> objects;
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            objects.push_back(pool::create(static_cast<int>(i)));
+        }
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            expect(fatal(objects[i]->value == static_cast<int>(i)));
+        }
+        std::ranges::sort(objects);
+        expect(std::ranges::adjacent_find(objects) == objects.end());
+        for (auto p : objects) pool::destroy(p);
+        expect(counted::alive == 0_i);
+    };
+
+    "smart pointers and hazard pointers"_test = []
+    {
+        {
+            auto up = pool::make_unique(1);
+            auto sp = pool::make_shared(2);
+            auto sp2(sp);
+            expect(up->value == 1_i);
+            expect(sp2->value == 2_i);
+            expect(sp.use_count() == 2_l);
+            expect(counted::alive == 2_i);
+        }
+        expect(counted::alive == 0_i);
+
+        // reclaimed by the pool once it is not protected anymore
+        hazard_pointer<counted>::retire(pool::create(3), &pool::destroy);
+        for (int i = 0; i < 1000; ++i)
+        {
+            hazard_pointer<counted>::retire(pool::create(i), &pool::destroy);
+        }
+        expect(counted::alive < 100_i);
+    };
+
+    "huge page slabs"_test = []
+    {
+        using huge_pool = object_pool<int, hugepage_slab_policy>;
+        std::vector<int*> objects;
+        for (int i = 0; i < 100000; ++i)
+        {
+            objects.push_back(huge_pool::create(i));
+        }
+        for (int i = 0; i < 100000; ++i) expect(fatal(*objects[i] == i));
+        for (auto p : objects) huge_pool::destroy(p);
+    };
+
+    "rest of the slab of an exited thread"_test = []
+    {
+        using rest_pool = object_pool<slab_rest>;
+
+        void* first = nullptr;
+        std::jthread([&] { first = rest_pool::allocate(); }).join();
+
+        // carved from the range handed over by the exited thread
+        auto const next = rest_pool::allocate();
+        expect(
+            next == static_cast<std::byte*>(first) + rest_pool::block_size
+        );
+
+        rest_pool::deallocate(next);
+        rest_pool::deallocate(first);
+    };
+
+    "allocation in a thread_local destructor"_test = []
+    {
+        std::jthread(
+            []
+            {
+                thread_local pool_on_exit user;
+                // freeing a block registers the drainer of the thread's
+                // magazine, after user
+                pool::destroy(pool::create(0));
+            }
+        ).join();
+        expect(pool_on_exit::made.load() == 100_i);
+        expect(counted::alive == 0_i);
+    };
+
+    "cross-thread reuse"_test = []
+    {
+        constexpr int ITERATIONS = 200000;
+
+        // allocated by the producer, freed by the consumer
+        waitfree_spsc_queue<counted*> queue(1024);
+        std::jthread producer(
+            [&]
+            {
+                for (int i = 0; i < ITERATIONS; ++i)
+                {
+                    auto const p = pool::create(i);
+                    while (!queue.emplace(p));
+                }
+            }
+        );
+        std::jthread consumer(
+            [&]
+            {
+                for (int i = 0; i < ITERATIONS; ++i)
+                {
+                    std::optional<counted*> p;
+                    while (!(p = queue.pop()));
+                    expect(fatal((*p)->value == i));
+                    pool::destroy(*p);
+                }
+            }
+        );
+        producer.join();
+        consumer.join();
+        expect(counted::alive == 0_i);
+    };
+};
+
+int
+main()
+{
+}
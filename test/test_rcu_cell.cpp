@@ -0,0 +1,153 @@
+#include <boost/ut.hpp>
+
+import tinystd;
+import std;
+
+using namespace boost::ut;
+using namespace tinystd;
+
+struct TestObject
+{
+    int                     value;
+    static std::atomic<int> instance_count;
+    TestObject(int v) : value(v) { instance_count++; }
+    TestObject(TestObject const & other) : value(other.value)
+    {
+        instance_count++;
+    }
+    ~TestObject() { instance_count--; }
+};
+std::atomic<int> TestObject::instance_count(0);
+
+suite<"rcu_cell"> rcu_cell_test = []
+{
+    "constructors"_test = []
+    {
+        rcu_cell<int> cell;
+        expect(*cell.read() == 0_i);
+
+        rcu_cell<std::string> str(std::in_place, 3, 'a');
+        expect(str.read()->size() == 3_ul);
+        expect(str.load() == "aaa");
+    };
+
+    "update"_test = []
+    {
+        rcu_cell<TestObject> cell(TestObject(10));
+        expect(cell.read()->value == 10_i);
+        cell.update(TestObject(20));
+        expect(cell.read()->value == 20_i);
+        expect(cell.load().value == 20_i);
+    };
+
+    "modify"_test = []
+    {
+        rcu_cell<std::vector<int>> cell(std::vector<int>{1, 2});
+        cell.modify([](std::vector<int>& v) { v.push_back(3); });
+        expect(cell.read()->size() == 3_ul);
+        expect(cell.read()->back() == 3_i);
+
+        // nothing is published if fn throws
+        expect(throws(
+            [&]
+            {
+                cell.modify(
+                    [](std::vector<int>& v)
+                    {
+                        v.clear();
+                        throw std::runtime_error("abort");
+                    }
+                );
+            }
+        ));
+        expect(cell.read()->size() == 3_ul);
+    };
+
+    "read guard keeps the version alive"_test = []
+    {
+        rcu_cell<TestObject> cell(TestObject(10));
+        auto                 guard = cell.read();
+        cell.update(TestObject(20));
+        expect(guard->value == 10_i);
+        expect(TestObject::instance_count.load() >= 2_i);
+
+        auto moved = std::move(guard);
+        expect(moved->value == 10_i);
+    };
+
+    "reassigned read guard keeps the version alive"_test = []
+    {
+        rcu_cell<TestObject> cell(TestObject(1));
+        auto                 guard = cell.read();
+        cell.update(TestObject(2));
+        guard = cell.read();
+
+        for (int i = 3; i < 100; ++i) cell.update(TestObject(i));
+        expect(guard->value == 2_i);
+        // every update reclaims the old versions that are not protected
+        expect(TestObject::instance_count.load() == 2_i);
+    };
+
+    "update reclaims old versions"_test = []
+    {
+        rcu_cell<TestObject> cell(TestObject(0));
+        for (int i = 1; i < 10; ++i) cell.update(TestObject(i));
+        expect(TestObject::instance_count.load() == 1_i);
+    };
+
+    "concurrent reads and updates"_test = []
+    {
+        constexpr int NUM_THREADS = 4;
+        constexpr int ITERATIONS  = 10000;
+
+        // every published vector holds copies of a single value
+        rcu_cell<std::vector<int>> cell(std::vector<int>(16, 0));
+        std::vector<std::jthread>  threads;
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back(
+                [&cell]
+                {
+                    for (int j = 0; j < ITERATIONS; ++j)
+                    {
+                        auto guard = cell.read();
+                        expect(std::ranges::all_of(
+                            *guard, [&](int x) { return x == guard->front(); }
+                        ));
+                    }
+                }
+            );
+        }
+        threads.emplace_back(
+            [&cell]
+            {
+                for (int j = 0; j < ITERATIONS; ++j)
+                {
+                    cell.modify(
+                        [](std::vector<int>& v)
+                        {
+                            for (auto& x : v) ++x;
+                        }
+                    );
+                }
+            }
+        );
+        threads.emplace_back(
+            [&cell]
+            {
+                for (int j = 0; j < ITERATIONS; ++j)
+                {
+                    cell.update(std::vector<int>(16, -j));
+                }
+            }
+        );
+        threads.clear();
+        auto const guard = cell.read();
+        expect(guard->size() == 16_ul);
+    };
+};
+
+int
+main()
+{
+}
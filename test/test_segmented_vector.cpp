@@ -0,0 +1,131 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// counts live objects
+struct counted
+{
+    inline static int count = 0;
+
+    int value;
+
+    counted(int v) noexcept : value(v) { ++count; }
+
+    counted(counted const & other) noexcept : value(other.value) { ++count; }
+
+    ~counted() noexcept { --count; }
+};
+
+suite<"segmented_vector"> test_segmented_vector = []
+{
+    "default chunk size"_test = []
+    {
+        static_assert(segmented_vector<int>::chunk_size == 1024);
+        using big   = std::array<char, 3000>;
+        using small = std::array<char, 100>;
+        static_assert(segmented_vector<big>::chunk_size == 1);
+        static_assert(segmented_vector<small>::chunk_size == 32);
+    };
+
+    "growth keeps addresses"_test = []
+    {
+        segmented_vector<int, 16> v;
+        v.push_back(0);
+        int const * const first = &v[0];
+        for (int i = 1; i < 1000; ++i) v.push_back(i);
+        expect(first == &v[0]);
+        expect(*first == 0_i);
+        expect(v.size() == 1000_ul);
+        expect(v.capacity() == 1008_ul);
+        expect(v.chunk_count() == 63_ul);
+        expect(v.chunk(62).size() == 8_ul);
+        expect(std::ranges::equal(v, std::views::iota(0, 1000)));
+    };
+
+    "iterators"_test = []
+    {
+        segmented_vector<int, 4> v;
+        for (int i = 0; i < 10; ++i) v.push_back(i);
+
+        static_assert(
+            std::random_access_iterator<segmented_vector<int>::iterator>
+        );
+        static_assert(
+            std::ranges::random_access_range<segmented_vector<int> const>
+        );
+
+        expect(std::ranges::equal(v, std::views::iota(0, 10)));
+        expect(std::ranges::equal(
+            v | std::views::reverse,
+            std::views::iota(0, 10) | std::views::reverse
+        ));
+        expect(v.end() - v.begin() == 10_l);
+        expect(*(v.begin() + 9) == 9_i);
+        expect(*(v.end() - 5) == 5_i);
+        expect(v.begin()[6] == 6_i);
+        expect(v.begin() + 4 < v.end() - 5);
+
+        auto const it = std::ranges::lower_bound(v, 7);
+        expect(it - v.begin() == 7_l);
+
+        std::ranges::sort(v, std::greater{});
+        expect(v[0] == 9_i && v[9] == 0_i);
+
+        // a size that is a multiple of the chunk size
+        v.pop_back();
+        v.pop_back();
+        expect(std::ranges::distance(std::as_const(v)) == 8_l);
+    };
+
+    "copy, move and swap"_test = []
+    {
+        segmented_vector<std::string, 2> v;
+        for (int i = 0; i < 5; ++i) v.push_back(std::to_string(i));
+
+        auto copy = v;
+        expect(std::ranges::equal(copy, v));
+
+        auto moved = std::move(copy);
+        expect(copy.empty() && moved.size() == 5_ul);
+
+        segmented_vector<std::string, 2> other;
+        other.push_back("other");
+        swap(moved, other);
+        expect(moved.size() == 1_ul && other.size() == 5_ul);
+        expect(moved.back() == "other");
+
+        moved = other;
+        expect(moved.size() == 5_ul && moved.back() == "4");
+    };
+
+    "no leaks"_test = []
+    {
+        {
+            segmented_vector<counted, 8> v;
+            v.reserve(20);
+            expect(v.capacity() == 24_ul && counted::count == 0_i);
+            for (int i = 0; i < 20; ++i) v.emplace_back(i);
+            v.emplace_back(v[3]);
+            expect(v.back().value == 3_i);
+            expect(counted::count == 21_i);
+            v.pop_back();
+            expect(counted::count == 20_i);
+
+            v.clear();
+            expect(counted::count == 0_i && v.capacity() == 24_ul);
+            v.emplace_back(1);
+            v.shrink_to_fit();
+            expect(v.capacity() == 8_ul && counted::count == 1_i);
+        }
+        expect(counted::count == 0_i);
+    };
+};
+
+int
+main()
+{
+}
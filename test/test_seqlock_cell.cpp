@@ -0,0 +1,128 @@
+#include <boost/ut.hpp>
+
+import tinystd;
+import std;
+
+using namespace boost::ut;
+using namespace tinystd;
+
+// not a multiple of the word size
+struct quote
+{
+    std::uint32_t bid;
+    std::uint32_t ask;
+    std::uint32_t bid_size;
+    std::uint32_t ask_size;
+    std::uint8_t  flags;
+};
+
+auto
+consistent(quote const & q) -> bool
+{
+    return q.ask == q.bid && q.bid_size == q.bid && q.ask_size == q.bid
+        && q.flags == static_cast<std::uint8_t>(q.bid);
+}
+
+auto
+make_quote(std::uint32_t i) -> quote
+{
+    return {i, i, i, i, static_cast<std::uint8_t>(i)};
+}
+
+suite<"seqlock_cell"> seqlock_cell_test = []
+{
+    "load and store"_test = []
+    {
+        seqlock_cell<int> cell;
+        expect(cell.load() == 0_i);
+        cell.store(42);
+        expect(cell.load() == 42_i);
+
+        seqlock_cell<quote> q(make_quote(7));
+        expect(consistent(q.load()));
+        expect(q.load().bid == 7_u);
+    };
+
+    "modify"_test = []
+    {
+        seqlock_cell<std::uint64_t> counter;
+        counter.modify([](std::uint64_t& c) { ++c; });
+        expect(counter.load() == 1_ull);
+
+        // nothing is written if fn throws
+        expect(throws(
+            [&]
+            {
+                counter.modify(
+                    [](std::uint64_t& c)
+                    {
+                        c = 100;
+                        throw std::runtime_error("abort");
+                    }
+                );
+            }
+        ));
+        expect(counter.load() == 1_ull);
+        counter.store(5);
+        expect(counter.load() == 5_ull);
+    };
+
+    "no torn reads with a single writer"_test = []
+    {
+        constexpr int           NUM_READERS = 4;
+        constexpr std::uint32_t ITERATIONS  = 100000;
+
+        seqlock_cell<quote>       cell;
+        std::atomic<bool>         done{false};
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < NUM_READERS; ++i)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    while (!done.load(std::memory_order_relaxed))
+                    {
+                        expect(consistent(cell.load()));
+                    }
+                }
+            );
+        }
+        for (std::uint32_t i = 0; i < ITERATIONS; ++i)
+        {
+            cell.store(make_quote(i));
+        }
+        done = true;
+    };
+
+    "multiple writers"_test = []
+    {
+        constexpr std::uint32_t NUM_THREADS = 4;
+        constexpr std::uint32_t ITERATIONS  = 10000;
+
+        seqlock_cell<quote, multi_writer_policy> cell;
+        {
+            std::vector<std::jthread> threads;
+            for (std::uint32_t i = 0; i < NUM_THREADS; ++i)
+            {
+                threads.emplace_back(
+                    [&]
+                    {
+                        for (std::uint32_t j = 0; j < ITERATIONS; ++j)
+                        {
+                            cell.modify(
+                                [](quote& q) { q = make_quote(q.bid + 1); }
+                            );
+                            expect(consistent(cell.load()));
+                        }
+                    }
+                );
+            }
+        }
+        expect(cell.load().bid == NUM_THREADS * ITERATIONS);
+    };
+};
+
+int
+main()
+{
+}
@@ -21,6 +21,28 @@ struct Derive : Base
     ~Derive() override { resources.fetch_sub(1, std::memory_order_relaxed); }
 };
 
+struct Recycled : Derive
+{
+};
+
+template <>
+inline constexpr bool tinystd::enable_control_block_recycling<Recycled> = true;
+
+// Makes recycled shared_ptrs when its thread exits. Constructed before the
+// first recycled block is freed on the thread, it is destroyed after the
+// local caches of recycled blocks are drained.
+struct RecycleOnExit
+{
+    inline static std::atomic<int> made = 0;
+
+    ~RecycleOnExit()
+    {
+        std::vector<shared_ptr<Base>> kept;
+        for (int i = 0; i < 100; ++i) kept.push_back(make_shared<Recycled>());
+        made.fetch_add(int(kept.size()), std::memory_order_relaxed);
+    }
+};
+
 suite<"shared_ptr"> shared_ptr_test = []
 {
     "move and alias ctor"_test = []
@@ -111,6 +133,69 @@ suite<"shared_ptr"> shared_ptr_test = []
         }
         expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
     };
+
+    "custom deleter"_test = []
+    {
+        int num_deleted = 0;
+        {
+            auto const deleter = [&](Derive* ptr) noexcept
+            {
+                ++num_deleted;
+                delete ptr;
+            };
+            shared_ptr<Derive> sp1(new Derive{}, deleter);
+            shared_ptr<Base>   sp2(sp1);
+            sp1.reset();
+            expect(num_deleted == 0_i);
+        }
+        expect(num_deleted == 1_i);
+        expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
+    };
+
+    "recycled control block"_test = []
+    {
+        constexpr int NUM_THREADS = 8;
+
+        {
+            auto                      sp0{make_shared<Recycled>()};
+            weak_ptr<Base>            wp0(sp0);
+            std::vector<std::jthread> threads;
+            for (int i = 0; i < NUM_THREADS; ++i)
+            {
+                // blocks freed by one thread are reused by the others through
+                // the global stack of batches
+                threads.emplace_back(
+                    [&sp0]
+                    {
+                        std::vector<shared_ptr<Base>> window(100);
+                        for (int i = 0; i < 100000; ++i)
+                        {
+                            window[i % window.size()] =
+                                i % 7 ? make_shared<Recycled>() : sp0;
+                        }
+                    }
+                );
+            }
+            threads.clear();
+            expect(wp0.use_count() == 1_l);
+        }
+        expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
+    };
+
+    "recycled control block in a thread_local destructor"_test = []
+    {
+        std::jthread(
+            []
+            {
+                thread_local RecycleOnExit recycler;
+                // freeing a recycled block registers the drainer of the
+                // thread's caches, after recycler
+                make_shared<Recycled>().reset();
+            }
+        ).join();
+        expect(RecycleOnExit::made.load() == 100_i);
+        expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
+    };
 };
 
 
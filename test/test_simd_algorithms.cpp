@@ -0,0 +1,138 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+using element_types = std::tuple<
+    std::int8_t,
+    std::uint8_t,
+    std::int16_t,
+    std::int32_t,
+    std::uint32_t,
+    std::int64_t,
+    float,
+    double>;
+
+template <typename T>
+concept summable = requires(vector<T> const & v) { simd::sum(v); };
+
+static_assert(summable<std::int8_t> && summable<double>);
+static_assert(!summable<bool> && !summable<long double>);
+
+// `size` values 0, 1, ..., 99, 0, 1, ...; long enough for 512-bit registers,
+// and not a multiple of a register, so the scalar tail runs too
+template <typename T>
+auto
+make(std::size_t size) -> vector<T>
+{
+    vector<T> v;
+    for (std::size_t i = 0; i < size; ++i) v.push_back(static_cast<T>(i % 100));
+    return v;
+}
+
+suite<"simd_algorithms"> test_simd_algorithms = []
+{
+    "find"_test = []<class T>
+    {
+        auto v = make<T>(1000);
+        expect(simd::find(v, T(42)) == v.begin() + 42);
+        expect(simd::find(v, T(120)) == v.end());
+        expect(simd::find(v, T(0)) == v.begin());
+
+        // in the scalar tail
+        v[999] = T(111);
+        expect(simd::find(v, T(111)) == v.begin() + 999);
+
+        vector<T> const empty;
+        expect(simd::find(empty, T(0)) == empty.end());
+    } | element_types{};
+
+    "count"_test = []<class T>
+    {
+        auto const v = make<T>(100'003);
+        expect(simd::count(v, T(1)) == std::ranges::count(v, T(1)));
+        expect(simd::count(v, T(5)) == 1000_l);
+        expect(simd::count(v, T(100)) == 0_l);
+
+        // more matches per lane than an 8-bit lane can count
+        vector<T> zeros;
+        for (int i = 0; i < 10'000; ++i) zeros.push_back(T(0));
+        expect(simd::count(zeros, T(0)) == 10'000_l);
+    } | element_types{};
+
+    "sum"_test = []<class T>
+    {
+        auto const v = make<T>(1003);
+        // 10 * (0 + ... + 99) + (0 + 1 + 2), exact for all element types
+        expect(simd::sum(v) == 49503);
+        expect(simd::sum(vector<T>{}) == 0);
+    } | element_types{};
+
+    "sum does not overflow narrow integers"_test = []
+    {
+        vector<std::uint8_t> v;
+        for (int i = 0; i < 1000; ++i) v.push_back(255);
+        expect(simd::sum(v) == 255'000_ul);
+
+        vector<std::int8_t> negative;
+        for (int i = 0; i < 1000; ++i) negative.push_back(-128);
+        expect(simd::sum(negative) == -128'000_l);
+    };
+
+    "min and max"_test = []<class T>
+    {
+        auto v = make<T>(1000);
+        expect(simd::min(v) == T(0));
+        expect(simd::max(v) == T(99));
+
+        v[517] = T(-1);
+        v[998] = T(120);
+        expect(simd::min(v) == std::ranges::min(v));
+        expect(simd::max(v) == std::ranges::max(v));
+
+        // shorter than a register
+        auto const few = make<T>(3);
+        expect(simd::min(few) == T(0) && simd::max(few) == T(2));
+    } | element_types{};
+
+    "equal"_test = []<class T>
+    {
+        auto const v    = make<T>(1000);
+        auto       same = make<T>(1000);
+        expect(simd::equal(v, same));
+
+        same[500] = T(101);
+        expect(!simd::equal(v, same));
+        same[500] = v[500];
+        same[999] = T(101);
+        expect(!simd::equal(v, same));
+
+        expect(!simd::equal(v, make<T>(999)));
+    } | element_types{};
+
+    "other contiguous ranges"_test = []
+    {
+        small_vector<int, 8> small;
+        for (int i = 0; i < 100; ++i) small.push_back(i);
+        expect(simd::sum(small) == 4950_l);
+
+        std::vector<int> values(100);
+        std::ranges::iota(values, 0);
+        span<int> const view(values.data(), values.size());
+        expect(simd::max(view) == 99_i);
+        expect(*simd::find(view, 7) == 7_i);
+        expect(simd::equal(small, view));
+
+        std::array<double, 3> const doubles{1.5, -2.5, 4.0};
+        expect(simd::min(doubles) == -2.5_d);
+        expect(simd::sum(doubles) == 3.0_d);
+    };
+};
+
+int
+main()
+{
+}
@@ -0,0 +1,169 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+// counts live objects, the constructor from `int` throws on request
+struct field
+{
+    inline static int count     = 0;
+    inline static int throw_for = -1;
+
+    int value;
+
+    field(int v) : value(v)
+    {
+        if (v == throw_for) throw std::runtime_error("field");
+        ++count;
+    }
+
+    field(field const & other) : field(other.value) {}
+
+    field(field&& other) noexcept : value(other.value) { ++count; }
+
+    auto operator=(field const &) -> field& = default;
+
+    ~field() noexcept { --count; }
+};
+
+suite<"soa_vector"> test_soa_vector = []
+{
+    "emplace_back and columns"_test = []
+    {
+        soa_vector<int, double, char> v;
+        expect(v.empty());
+        for (int i = 0; i < 100; ++i) v.emplace_back(i, i * 0.5, 'a' + i % 26);
+        expect(v.size() == 100_ul);
+        expect(v.capacity() >= 100_ul);
+
+        // growth keeps every column
+        expect(std::ranges::equal(v.column<0>(), std::views::iota(0, 100)));
+        expect(v.column<1>()[99] == 49.5_d);
+        expect(v.column<2>()[27] == 'b');
+
+        auto [i, d, c] = v[42];
+        expect(i == 42_i && d == 21.0_d && c == 'q');
+    };
+
+    "rows are proxy references"_test = []
+    {
+        soa_vector<int, std::string> v;
+        v.emplace_back(1, "one");
+        v.emplace_back(2, "two");
+
+        auto [i, s] = v[1];
+        i           = 20;
+        s += "!";
+        expect(v.column<0>()[1] == 20_i);
+        expect(v.column<1>()[1] == "two!");
+
+        std::get<0>(v[0]) = 10;
+        expect(v.column<0>()[0] == 10_i);
+    };
+
+    "columns are cache line aligned"_test = []
+    {
+        soa_vector<char, int, double> v;
+        for (int i = 0; i < 5; ++i) v.emplace_back('x', i, 1.0);
+        auto const aligned = [](void const * p)
+        {
+            return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+        };
+        expect(aligned(v.column<0>().data()));
+        expect(aligned(v.column<1>().data()));
+        expect(aligned(v.column<2>().data()));
+    };
+
+    "copy, move and swap"_test = []
+    {
+        soa_vector<int, std::string> v;
+        for (int i = 0; i < 10; ++i) v.emplace_back(i, std::to_string(i));
+
+        auto copy = v;
+        expect(copy.size() == 10_ul && copy.capacity() == 10_ul);
+        expect(std::ranges::equal(copy.column<1>(), v.column<1>()));
+
+        auto moved = std::move(copy);
+        expect(copy.empty() && moved.size() == 10_ul);
+
+        soa_vector<int, std::string> other;
+        other.emplace_back(-1, "minus one");
+        swap(other, moved);
+        expect(other.size() == 10_ul && moved.size() == 1_ul);
+        expect(std::get<1>(moved[0]) == "minus one");
+
+        other = moved;
+        expect(other.size() == 1_ul);
+        expect(std::get<1>(other[0]) == "minus one");
+    };
+
+    "no leaks"_test = []
+    {
+        {
+            soa_vector<field, field> v;
+            for (int i = 0; i < 50; ++i) v.emplace_back(i, -i);
+            expect(field::count == 100_i);
+            v.pop_back();
+            expect(field::count == 98_i);
+            auto copy = v;
+            expect(field::count == 196_i);
+            copy.clear();
+            expect(field::count == 98_i);
+        }
+        expect(field::count == 0_i);
+    };
+
+    "a throwing field leaves the vector unchanged"_test = []
+    {
+        {
+            soa_vector<field, field> v;
+            v.emplace_back(1, 2);
+            v.reserve(2);
+            field::throw_for = 7;
+
+            // in place and while growing
+            expect(throws([&] { v.emplace_back(3, 7); }));
+            expect(v.size() == 1_ul && field::count == 2_i);
+            v.emplace_back(3, 4);
+            expect(throws([&] { v.emplace_back(7, 5); }));
+            expect(v.size() == 2_ul && v.capacity() == 2_ul);
+            expect(field::count == 4_i);
+
+            // copying the second column throws
+            v.emplace_back(5, 6);
+            std::get<1>(v[1]).value = 7;
+            expect(throws([&] { auto copy = v; }));
+            expect(field::count == 6_i);
+            field::throw_for = -1;
+        }
+        expect(field::count == 0_i);
+    };
+
+    "iterators work with algorithms"_test = []
+    {
+        soa_vector<int, float> v;
+        for (int i = 0; i < 10; ++i) v.emplace_back(i, i * 2.0f);
+
+        static_assert(std::random_access_iterator<soa_vector<int>::iterator>);
+        static_assert(std::ranges::random_access_range<soa_vector<int> const>);
+
+        auto const it = std::ranges::find_if(
+            v, [](auto const & row) { return std::get<1>(row) > 7.0f; }
+        );
+        expect(it - v.begin() == 4_l);
+        expect(std::get<0>(*it) == 4_i);
+
+        int sum = 0;
+        for (auto [i, f] : std::as_const(v)) sum += i;
+        expect(sum == 45_i);
+        expect(std::ranges::distance(v) == 10_l);
+    };
+};
+
+int
+main()
+{
+}
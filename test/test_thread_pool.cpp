@@ -0,0 +1,162 @@
+#include <boost/ut.hpp>
+
+import std;
+import tinystd;
+
+using namespace tinystd;
+using namespace boost::ut;
+
+suite<"thread_pool"> test_thread_pool = []
+{
+    "submit"_test = []
+    {
+        constexpr int NUM_TASKS = 10000;
+
+        std::atomic<int> count{0};
+        {
+            thread_pool pool(4);
+            expect(pool.size() == 4_u);
+            for (int i = 0; i < NUM_TASKS; ++i)
+            {
+                pool.submit([&] { count.fetch_add(1); });
+            }
+        }
+        // the destructor runs every submitted task
+        expect(count == NUM_TASKS);
+    };
+
+    "move-only tasks"_test = []
+    {
+        std::latch done{1};
+        int        result = 0;
+        {
+            thread_pool pool(2);
+            pool.submit(
+                [p = std::make_unique<int>(42), &result, &done]
+                {
+                    result = *p;
+                    done.count_down();
+                }
+            );
+            done.wait();
+        }
+        expect(result == 42_i);
+    };
+
+    "tasks submitted by tasks"_test = []
+    {
+        std::atomic<int> count{0};
+        {
+            thread_pool pool(4);
+            for (int i = 0; i < 100; ++i)
+            {
+                pool.submit(
+                    [&]
+                    {
+                        for (int j = 0; j < 100; ++j)
+                        {
+                            pool.submit([&] { count.fetch_add(1); });
+                        }
+                    }
+                );
+            }
+        }
+        expect(count == 10000_i);
+    };
+
+    "parallel_for"_test = []
+    {
+        thread_pool      pool(4);
+        std::vector<int> data(100000);
+        std::iota(data.begin(), data.end(), 0);
+        span<int> view(data.data(), data.size());
+
+        pool.parallel_for(view, [](int& x) { x *= 2; });
+        for (int i = 0; i < 100000; ++i) expect(fatal(data[i] == 2 * i));
+
+        // one element per chunk
+        pool.parallel_for(view.first(1000), [](int& x) { x = 0; }, 1);
+        expect(std::ranges::all_of(
+            data | std::views::take(1000), [](int x) { return x == 0; }
+        ));
+        expect(data[1000] == 2000_i);
+
+        pool.parallel_for(span<int>(), [](int&) { expect(false); });
+    };
+
+    "parallel_reduce"_test = []
+    {
+        thread_pool                pool(4);
+        std::vector<std::uint64_t> data(100000);
+        std::iota(data.begin(), data.end(), 1);
+        span<std::uint64_t> view(data.data(), data.size());
+
+        auto const sum =
+            pool.parallel_reduce(view, std::uint64_t{0}, std::plus<>{});
+        expect(sum == 100000ull * 100001 / 2);
+
+        // the chunk results are combined in order
+        std::vector<std::string> words{"a", "b", "c", "d", "e", "f", "g"};
+        auto const               joined = pool.parallel_reduce(
+            span<std::string>(words.data(), words.size()),
+            std::string{},
+            [](std::string acc, std::string const & word)
+            { return std::move(acc) + word; },
+            [](std::string lhs, std::string rhs) { return lhs + rhs; },
+            2
+        );
+        expect(joined == "abcdefg");
+
+        expect(
+            pool.parallel_reduce(span<std::uint64_t>(), 7ull, std::plus<>{})
+            == 7_ull
+        );
+    };
+
+    "nested fork-join"_test = []
+    {
+        thread_pool      pool(4);
+        std::vector<int> rows(64);
+        span<int>        view(rows.data(), rows.size());
+        pool.parallel_for(
+            view,
+            [&](int& row)
+            {
+                std::vector<int> cols(1000, 1);
+                row = pool.parallel_reduce(
+                    span<int>(cols.data(), cols.size()), 0, std::plus<>{}
+                );
+            },
+            1
+        );
+        expect(std::ranges::all_of(rows, [](int x) { return x == 1000; }));
+    };
+
+    "exceptions"_test = []
+    {
+        thread_pool      pool(4);
+        std::vector<int> data(1000);
+        span<int>        view(data.data(), data.size());
+        expect(throws<std::runtime_error>(
+            [&]
+            {
+                pool.parallel_for(view, [](int& x) { x = 1; });
+                pool.parallel_for(
+                    view,
+                    [](int& x)
+                    {
+                        if (x == 1) throw std::runtime_error{"fails"};
+                    }
+                );
+            }
+        ));
+        // the pool is still usable
+        pool.parallel_for(view, [](int& x) { x = 5; });
+        expect(data[999] == 5_i);
+    };
+};
+
+int
+main()
+{
+}
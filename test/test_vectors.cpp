@@ -56,6 +56,98 @@ struct [[clang::trivial_abi]] S
 
 static_assert(__is_trivially_relocatable(S));
 
+// trivially relocatable, insert/erase shift it with memmove
+struct relocatable
+{
+    int value;
+
+    relocatable(int v = 0) noexcept : value(v) {}
+};
+
+// move may throw, so insert/erase cannot relocate it
+struct throwing_move
+{
+    int value;
+
+    throwing_move(int v = 0) : value(v) {}
+
+    throwing_move(throwing_move const &) = default;
+
+    throwing_move(throwing_move&& other) noexcept(false) : value(other.value)
+    {
+    }
+
+    auto operator=(throwing_move const &) -> throwing_move& = default;
+
+    auto
+    operator==(throwing_move const &) const -> bool = default;
+};
+
+static_assert(!__is_trivially_relocatable(throwing_move));
+
+// counts the bytes currently allocated from it
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t bytes = 0;
+
+private:
+    auto
+    do_allocate(std::size_t size, std::size_t alignment) -> void* override
+    {
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void
+    do_deallocate(void* p, std::size_t size, std::size_t alignment) override
+    {
+        bytes -= size;
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    auto
+    do_is_equal(std::pmr::memory_resource const & other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+// stateful allocator that propagates on move assignment and swap only
+template <typename T>
+struct tagged_allocator
+{
+    using value_type                             = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    int tag;
+
+    explicit tagged_allocator(int t) noexcept : tag(t) {}
+
+    template <typename U>
+    tagged_allocator(tagged_allocator<U> const & other) noexcept
+        : tag(other.tag)
+    {
+    }
+
+    auto
+    allocate(std::size_t n) -> T*
+    {
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    auto
+    operator==(tagged_allocator const &) const noexcept -> bool = default;
+};
+
 template <class VectorInt>
 consteval bool
 test_vector_compile_time()
@@ -80,11 +172,68 @@ test_vector_compile_time()
     return true;
 }
 
+template <class VectorInt>
+consteval bool
+test_modifiers_compile_time()
+{
+    VectorInt v;
+    v.assign({1, 2, 3, 4});
+    v.insert(v.begin() + 1, 10);
+    v.insert(v.begin(), 2, 20);
+    assert(v.size() == 7);
+    assert(v[0] == 20 && v[1] == 20 && v[2] == 1 && v[3] == 10);
+
+    v.erase(v.begin(), v.begin() + 2);
+    v.erase(v.begin() + 1);
+    assert(v.size() == 4);
+    assert(v[0] == 1 && v[1] == 2 && v[3] == 4);
+
+    v.resize(6, 5);
+    assert(v[5] == 5);
+    v.resize(2);
+    assert(v.size() == 2);
+    v.clear();
+    assert(v.empty());
+
+    auto const appended = v.append_for_overwrite(3);
+    assert(appended.size() == 3 && appended.data() == v.data());
+    for (int& x : appended) x = 8;
+    v.resize_for_overwrite(4);
+    v[3] = 9;
+    assert(v.size() == 4 && v[2] == 8 && v[3] == 9);
+
+    return true;
+}
+
 using namespace tinystd;
 static_assert(sizeof(vector<int>) == 24ul);
 static_assert(test_vector_compile_time<vector<int>>());
 static_assert(test_vector_compile_time<small_vector<int, 2>>());
 static_assert(test_vector_compile_time<inplace_vector<int, 5>>());
+static_assert(test_modifiers_compile_time<vector<int>>());
+static_assert(test_modifiers_compile_time<small_vector<int, 2>>());
+static_assert(test_modifiers_compile_time<inplace_vector<int, 8>>());
+
+// compact layouts
+template <typename T, typename StoredSize>
+using compact_vector =
+    vector<T, std::allocator<T>, small_vector_options<StoredSize>>;
+
+template <typename T, std::size_t Bytes, typename StoredSize>
+inline constexpr std::size_t compact_capacity = inline_capacity_for<
+    T,
+    Bytes,
+    std::allocator<T>,
+    small_vector_options<StoredSize>>;
+
+static_assert(sizeof(compact_vector<int, std::uint32_t>) == 16ul);
+static_assert(inline_capacity_for<int, 64> == 10);
+static_assert(compact_capacity<int, 64, std::uint32_t> == 12);
+static_assert(compact_capacity<char, 64, std::uint16_t> == 52);
+static_assert(sizeof(small_vector<int, inline_capacity_for<int, 128>>) == 128);
+static_assert(
+    test_modifiers_compile_time<compact_vector<int, std::uint16_t>>()
+);
 
 
 using namespace boost::ut;
@@ -123,7 +272,312 @@ suite<"vectors"> vectors = []
         expect(fatal(S::resources == 0_ul))
             << "leaking " << S::resources << " resources";
         expect(fatal(S::count == 0_ul)) << "leaking " << S::count << "objects";
-    } | std::tuple<small_vector<S, 2>, inplace_vector<S, 3>, vector<S>>{};
+    } | std::tuple<
+            small_vector<S, 2>,
+            inplace_vector<S, 3>,
+            vector<S>,
+            pmr::small_vector<S, 2>,
+            pmr::vector<S>>{};
+};
+
+suite<"modifiers"> modifiers = []
+{
+    "no leaks"_test = []<class VectorS>
+    {
+        boost::ut::log << reflection::type_name<VectorS>();
+        {
+            VectorS v;
+            v.resize(3);
+            S const value;
+            v.insert(v.begin() + 1, 2, value);
+            v.insert(v.begin(), v[4]);
+            v.emplace(v.begin() + 2);
+            expect(v.size() == 7_ul);
+
+            v.erase(v.begin() + 1, v.begin() + 4);
+            v.erase(v.end() - 1);
+            expect(v.size() == 3_ul);
+
+            std::array<S, 3> more;
+            v.append_range(more);
+            v.insert_range(v.begin() + 2, more);
+            expect(v.size() == 9_ul);
+
+            v.resize(5);
+            v.shrink_to_fit();
+            v.assign(3, value);
+            expect(v.size() == 3_ul);
+            v.clear();
+            expect(v.empty());
+            v.resize(4, value);
+        }
+
+        expect(fatal(S::resources == 0_ul))
+            << "leaking " << S::resources << " resources";
+        expect(fatal(S::count == 0_ul)) << "leaking " << S::count << "objects";
+    } | std::tuple<small_vector<S, 2>, inplace_vector<S, 16>, vector<S>>{};
+
+    "contents"_test = []<class Vector>
+    {
+        using value_type = std::ranges::range_value_t<Vector>;
+
+        auto const values = [](Vector const & v)
+        {
+            std::vector<int> result;
+            for (value_type const & x : v) result.push_back(x.value);
+            return result;
+        };
+
+        Vector v;
+        v.assign({1, 2, 3});
+        v.push_back(4);
+        v.insert(v.begin(), 0);
+        expect(values(v) == std::vector{0, 1, 2, 3, 4});
+
+        // inserting an element of the vector itself
+        v.insert(v.begin() + 1, v[4]);
+        v.insert(v.begin(), 2, v[1]);
+        expect(values(v) == std::vector{4, 4, 0, 4, 1, 2, 3, 4});
+
+        v.erase(v.begin(), v.begin() + 3);
+        v.erase(v.end() - 2);
+        expect(values(v) == std::vector{4, 1, 2, 4});
+
+        std::array<value_type, 2> const more{7, 8};
+        v.insert(v.begin() + 2, more.begin(), more.end());
+        expect(values(v) == std::vector{4, 1, 7, 8, 2, 4});
+
+        // single pass input range
+        std::istringstream in{"5 6"};
+        v.insert_range(
+            v.begin() + 1,
+            std::views::istream<int>(in)
+                | std::views::transform([](int i) { return value_type{i}; })
+        );
+        expect(values(v) == std::vector{4, 5, 6, 1, 7, 8, 2, 4});
+
+        v.resize(10, value_type{9});
+        expect(values(v) == std::vector{4, 5, 6, 1, 7, 8, 2, 4, 9, 9});
+        v.resize(3);
+        expect(values(v) == std::vector{4, 5, 6});
+        v.assign(2, v[2]);
+        expect(values(v) == std::vector{6, 6});
+    } | std::tuple<
+            small_vector<throwing_move, 4>,
+            inplace_vector<throwing_move, 16>,
+            vector<throwing_move>,
+            small_vector<relocatable, 4>,
+            inplace_vector<relocatable, 16>,
+            vector<relocatable>>{};
+
+    "default-initialized growth"_test = []
+    {
+        vector<std::byte> buffer(default_init, 4096);
+        expect(buffer.size() == 4096_ul);
+        expect(buffer.capacity() == 4096_ul);
+
+        auto const tail = buffer.append_for_overwrite(100);
+        expect(tail.data() == buffer.data() + 4096);
+        expect(tail.size() == 100_ul);
+        std::ranges::fill(tail, std::byte{1});
+        expect(buffer[4195] == std::byte{1});
+
+        small_vector<float, 8> floats;
+        floats.resize_for_overwrite(4);
+        expect(floats.size() == 4_ul);
+        expect(floats.capacity() == 8_ul);
+        floats.resize_for_overwrite(2);
+        expect(floats.size() == 2_ul);
+
+        inplace_vector<int, 16> ints(default_init, 16);
+        expect(ints.size() == 16_ul);
+        expect(throws<std::bad_alloc>([&] { ints.append_for_overwrite(1); }));
+
+        // non-trivial types are still default constructed
+        {
+            vector<S> v(default_init, 3);
+            v.append_for_overwrite(2);
+            expect(S::count == 5_i);
+            expect(S::resources == 5_i);
+        }
+        expect(S::count == 0_i);
+    };
+
+    "capacity"_test = []
+    {
+        vector<int> v;
+        v.reserve(100);
+        expect(v.capacity() == 100_ul);
+        int const* const data = v.data();
+        for (int i = 0; i < 100; ++i) v.push_back(i);
+        expect(v.data() == data);
+
+        // a range insert allocates once, for exactly what is needed
+        std::vector<int> const more(150, 1);
+        v.insert(v.begin() + 50, more.begin(), more.end());
+        expect(v.capacity() == 250_ul);
+        expect(v[49] == 49 && v[50] == 1 && v[200] == 50);
+
+        v.resize(10);
+        v.shrink_to_fit();
+        expect(v.capacity() == 10_ul);
+
+        small_vector<int, 4> sv;
+        sv.assign({1, 2, 3, 4, 5, 6});
+        expect(sv.capacity() >= 6_ul);
+        sv.resize(3);
+        sv.shrink_to_fit();
+        expect(sv.capacity() == 4_ul) << "back in the inline buffer";
+        expect(sv[2] == 3_i);
+
+        inplace_vector<int, 4> iv;
+        expect(throws<std::bad_alloc>([&] { iv.resize(5); }));
+        expect(throws<std::bad_alloc>([&] { iv.reserve(5); }));
+        expect(iv.empty());
+
+        for (int i = 0; i < 4; ++i) iv.push_back(i);
+        expect(throws<std::bad_alloc>([&] { iv.push_back(4); }));
+        expect(throws<std::bad_alloc>([&] { iv.emplace_back(4); }));
+        expect(iv.size() == 4_ul && iv[3] == 3_i);
+    };
+};
+
+suite<"allocators"> allocators = []
+{
+    "memory resource"_test = []<class VectorInt>
+    {
+        counting_resource resource;
+        {
+            VectorInt v(&resource);
+            for (int i = 0; i < 100; ++i) v.emplace_back(i);
+            expect(resource.bytes >= 100 * sizeof(int));
+            expect(v.get_allocator().resource() == &resource);
+
+            // copies select the default resource, like std::pmr containers
+            VectorInt copy(v);
+            expect(
+                copy.get_allocator().resource()
+                == std::pmr::get_default_resource()
+            );
+
+            // assignment keeps the resource of the lhs
+            counting_resource other_resource;
+            VectorInt         w(&other_resource);
+            w = v;
+            expect(w.get_allocator().resource() == &other_resource);
+            expect(other_resource.bytes >= 100 * sizeof(int));
+            w = std::move(copy);
+            expect(w.get_allocator().resource() == &other_resource);
+            expect(w.size() == 100_ul);
+            expect(w[99] == 99_i);
+            expect(copy.empty());
+        }
+        expect(resource.bytes == 0_ul);
+    } | std::tuple<pmr::vector<int>, pmr::small_vector<int, 4>>{};
+
+    "monotonic buffer"_test = []
+    {
+        std::array<std::byte, 1024>         buffer;
+        std::pmr::monotonic_buffer_resource arena{
+            buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+        };
+        pmr::vector<int> v(&arena);
+        for (int i = 0; i < 64; ++i) v.emplace_back(i);
+        expect(v.size() == 64_ul);
+        auto const * first = reinterpret_cast<std::byte const *>(v.data());
+        expect(first >= buffer.data() && first < buffer.data() + buffer.size());
+    };
+
+    "elements use the memory resource"_test = []
+    {
+        counting_resource             resource;
+        pmr::vector<std::pmr::string> v(&resource);
+        v.emplace_back(100, 'x');
+        expect(v[0].get_allocator().resource() == &resource);
+        auto const bytes = resource.bytes;
+        expect(bytes > 100_ul);
+        v.pop_back();
+        expect(resource.bytes < bytes);
+    };
+
+    "propagation"_test = []<class VectorInt>
+    {
+        using allocator = tagged_allocator<int>;
+
+        VectorInt v1{allocator{1}};
+        VectorInt v2{allocator{2}};
+        for (int i = 0; i < 10; ++i) v2.emplace_back(i);
+
+        // not propagated on copy assignment
+        v1 = v2;
+        expect(v1.get_allocator().tag == 1_i);
+        expect(v1.size() == 10_ul);
+
+        // propagated on move assignment and swap
+        VectorInt v3{allocator{3}};
+        v3.emplace_back(42);
+        v1.swap(v3);
+        expect(v1.get_allocator().tag == 3_i);
+        expect(v3.get_allocator().tag == 1_i);
+        expect(v1.size() == 1_ul);
+        expect(v3.size() == 10_ul);
+        v1 = std::move(v2);
+        expect(v1.get_allocator().tag == 2_i);
+        expect(v1.size() == 10_ul);
+        expect(v1[9] == 9_i);
+    } | std::tuple<
+            small_vector<int, 4, tagged_allocator<int>>,
+            vector<int, tagged_allocator<int>>>{};
+};
+
+suite<"options"> options = []
+{
+    "growth factor"_test = []
+    {
+        using options = small_vector_options<std::size_t, 3, 2>;
+        vector<int, std::allocator<int>, options> v;
+        std::vector<std::size_t>                  capacities;
+        for (int i = 0; i < 10; ++i)
+        {
+            v.push_back(i);
+            capacities.push_back(v.capacity());
+        }
+        expect(std::ranges::equal(
+            capacities,
+            std::array<std::size_t, 10>{1, 2, 3, 4, 6, 6, 9, 9, 9, 13}
+        ));
+        expect(v[9] == 9_i);
+    };
+
+    "stored size limits the size"_test = []
+    {
+        using options = small_vector_options<std::uint16_t>;
+        small_vector<char, 4, std::allocator<char>, options> v;
+        expect(v.max_size() == 65535_ul);
+        expect(throws<std::length_error>([&] { v.reserve(65536); }));
+
+        v.resize(65535, 'x');
+        expect(v.size() == 65535_ul && v.capacity() == 65535_ul);
+        expect(throws<std::length_error>([&] { v.push_back('y'); }));
+        expect(v.size() == 65535_ul && v[65534] == 'x');
+
+        v.resize(10);
+        v.shrink_to_fit();
+        auto copy = v;
+        expect(copy.size() == 10_ul && copy.capacity() == 10_ul);
+        v.resize(2);
+        v.shrink_to_fit();
+        expect(v.capacity() == 4_ul);
+
+        using tiny_options = small_vector_options<std::uint8_t>;
+        small_vector<int, 2, std::allocator<int>, tiny_options> tiny;
+        tiny.insert(tiny.end(), 200, 1);
+        tiny.insert(tiny.begin(), 55, 0);
+        expect(tiny.size() == 255_ul && tiny[54] == 0_i && tiny[55] == 1_i);
+        expect(throws<std::length_error>(
+            [&] { tiny.insert(tiny.end(), 1, 2); }
+        ));
+    };
 };
 
 
@@ -82,6 +82,27 @@ suite<"weak_ptr"> weak_ptr_test = []
         expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
     };
 
+    "object outlived by weak_ptr"_test = []
+    {
+        {
+            auto                          sp{make_shared<Derive>()};
+            std::vector<weak_ptr<Derive>> wps(8, weak_ptr<Derive>(sp));
+            expect(wps.back().use_count() == 1_l);
+
+            // the object is destroyed with the last shared_ptr while the
+            // control block is kept alive by the weak_ptrs
+            sp.reset();
+            expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i)
+            );
+            for (auto const & wp : wps)
+            {
+                expect(wp.expired());
+                expect(!wp.lock());
+            }
+        }
+        expect(fatal(Base::resources.load(std::memory_order_relaxed) == 0_i));
+    };
+
     "concurrent"_test = []
     {
         constexpr int    NUM_THREADS      = 100;